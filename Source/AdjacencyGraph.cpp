@@ -0,0 +1,102 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "AdjacencyGraph.h"
+#include <cstring>
+#include <Windows.h>
+
+
+
+bool AdjacencyGraph::readFile(const std::string& fileName, size_t recordSize)
+{
+	offsets.clear();
+	neighborIds.clear();
+
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+		return false;
+	}
+	if (fileSize.QuadPart == 0)
+	{
+		// an empty file can't be mapped, but is an empty graph
+		CloseHandle(file);
+		offsets.push_back(0);
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const char* view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (view == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	parse(view, static_cast<size_t>(fileSize.QuadPart), recordSize);
+
+	UnmapViewOfFile(view);
+	CloseHandle(mapping);
+	CloseHandle(file);
+	return true;
+}
+
+
+void AdjacencyGraph::parse(const char* data, size_t dataSize, size_t recordSize)
+{
+	// each province is a count of records followed by the records; a truncated record ends the file
+	neighborIds.reserve(dataSize / ((recordSize > 0) ? recordSize : sizeof(int)));
+	offsets.push_back(0);
+	size_t position = 0;
+	while (position + sizeof(int) <= dataSize)
+	{
+		int numAdjacencies;
+		memcpy(&numAdjacencies, data + position, sizeof(numAdjacencies));
+		position += sizeof(numAdjacencies);
+
+		for (int i = 0; (i < numAdjacencies) && (recordSize > 0); ++i)
+		{
+			if (position + recordSize > dataSize)
+			{
+				position = dataSize;
+				break;
+			}
+			int to;
+			memcpy(&to, data + position + sizeof(int), sizeof(to));
+			neighborIds.push_back(to);
+			position += recordSize;
+		}
+		offsets.push_back(neighborIds.size());
+	}
+}
@@ -0,0 +1,81 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef ADJACENCYGRAPH_H_
+#define ADJACENCYGRAPH_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+// A read-only view of one province's neighbors
+class AdjacencySpan
+{
+	public:
+		typedef const int* const_iterator;
+
+		AdjacencySpan(const int* _first, const int* _last) noexcept: first(_first), last(_last) {}
+
+		const_iterator	begin()					const noexcept { return first; }
+		const_iterator	end()						const noexcept { return last; }
+		size_t		size()						const noexcept { return static_cast<size_t>(last - first); }
+		bool			empty()						const noexcept { return first == last; }
+		int			operator[](size_t i)		const noexcept { return first[i]; }
+	private:
+		const int*	first;
+		const int*	last;
+};
+
+
+// The V2 province adjacencies in compressed-sparse-row form: the neighbors of every province sit back
+// to back in one array, and the neighbors of province p are neighbors[offsets[p]] up to
+// neighbors[offsets[p + 1]].
+class AdjacencyGraph
+{
+	public:
+		// Reads the graph from an adjacencies.bin, whose records for the installed game are recordSize
+		// bytes long with the neighbor in their second int.  Returns false if the file can't be read.
+		bool readFile(const std::string& fileName, size_t recordSize);
+
+		// The number of provinces the file had entries for; larger ids have no neighbors
+		size_t			size()						const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+		AdjacencySpan	neighbors(int province)	const noexcept
+		{
+			if ((province < 0) || (static_cast<size_t>(province) >= size()))
+			{
+				return AdjacencySpan(nullptr, nullptr);
+			}
+			return AdjacencySpan(neighborIds.data() + offsets[province], neighborIds.data() + offsets[province + 1]);
+		}
+
+	private:
+		void parse(const char* data, size_t dataSize, size_t recordSize);
+
+		std::vector<size_t>	offsets;
+		std::vector<int>		neighborIds;
+};
+
+
+
+#endif // ADJACENCYGRAPH_H_
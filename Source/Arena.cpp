@@ -0,0 +1,80 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "Arena.h"
+#include <cstdint>
+
+
+
+static const size_t blockSize = 64 * 1024;
+
+
+Arena::Arena() noexcept
+{
+	next		= nullptr;
+	blockEnd	= nullptr;
+}
+
+
+Arena::~Arena()
+{
+	// newest first, as if each object had been a local
+	for (std::vector<std::pair<void*, void (*)(void*)>>::reverse_iterator itr = destructors.rbegin(); itr != destructors.rend(); ++itr)
+	{
+		itr->second(itr->first);
+	}
+	for (std::vector<char*>::iterator itr = blocks.begin(); itr != blocks.end(); ++itr)
+	{
+		delete[] *itr;
+	}
+}
+
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+	std::lock_guard<std::mutex> guard(lock);
+
+	uintptr_t address = (reinterpret_cast<uintptr_t>(next) + alignment - 1) & ~(alignment - 1);
+	if ((next == nullptr) || (address + size > reinterpret_cast<uintptr_t>(blockEnd)))
+	{
+		// an object too big for a block gets one of its own, so the current block keeps its free space
+		if (size + alignment > blockSize)
+		{
+			char* block = new char[size + alignment];
+			blocks.push_back(block);
+			return reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(alignment - 1));
+		}
+		char* block = new char[blockSize];
+		blocks.push_back(block);
+		blockEnd	= block + blockSize;
+		address	= (reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(alignment - 1);
+	}
+	next = reinterpret_cast<char*>(address + size);
+	return reinterpret_cast<void*>(address);
+}
+
+
+void Arena::addDestructor(void* object, void (*destructor)(void*))
+{
+	std::lock_guard<std::mutex> guard(lock);
+	destructors.push_back(std::make_pair(object, destructor));
+}
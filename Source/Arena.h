@@ -0,0 +1,124 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+// Bulk storage for a world's object graph.  Objects are carved out of large blocks rather than
+// allocated one by one, and are never freed individually: they all go, destructors and memory
+// both, when the arena that made them is destroyed.  make() may be called from several threads.
+//		Arena arena;
+//		V2State* newState = arena.make<V2State>(stateId, province);
+class Arena
+{
+	public:
+		Arena() noexcept;
+		~Arena();
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		template<class T, class... Args>
+		T* make(Args&&... args)
+		{
+			T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			if (!std::is_trivially_destructible<T>::value)
+			{
+				addDestructor(object, &destroy<T>);
+			}
+			return object;
+		}
+
+	private:
+		void*	allocate(size_t size, size_t alignment);
+		void	addDestructor(void* object, void (*destructor)(void*));
+
+		template<class T>
+		static void destroy(void* object) noexcept	{ static_cast<T*>(object)->~T(); }
+
+		std::mutex										lock;
+		std::vector<char*>							blocks;
+		char*												next;				// the free space left in the newest block
+		char*												blockEnd;
+		std::vector<std::pair<void*, void (*)(void*)>>	destructors;	// in the order the objects were made
+};
+
+
+// A typed pool for the most numerous objects: they are packed back to back in slabs, and cost no
+// more than their own size.  Like an arena, a pool releases everything at once when it is destroyed.
+template<class T>
+class ObjectPool
+{
+	public:
+		explicit ObjectPool(size_t _slabSize = 1024) noexcept: slabSize(_slabSize), usedInLastSlab(_slabSize) {}
+		~ObjectPool()
+		{
+			for (size_t i = 0; i < slabs.size(); ++i)
+			{
+				size_t used = (i + 1 == slabs.size()) ? usedInLastSlab : slabSize;
+				for (size_t j = 0; j < used; ++j)
+				{
+					reinterpret_cast<T*>(&slabs[i][j])->~T();
+				}
+				delete[] slabs[i];
+			}
+		}
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		template<class... Args>
+		T* make(Args&&... args)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (usedInLastSlab == slabSize)
+			{
+				slabs.push_back(new slot[slabSize]);
+				usedInLastSlab = 0;
+			}
+			T* object = new (&slabs.back()[usedInLastSlab]) T(std::forward<Args>(args)...);
+			++usedInLastSlab;	// only once the object exists, so a throwing constructor leaves nothing to destroy
+			return object;
+		}
+
+	private:
+		struct slot
+		{
+			alignas(T) unsigned char bytes[sizeof(T)];
+		};
+
+		std::mutex				lock;
+		std::vector<slot*>	slabs;
+		size_t					slabSize;
+		size_t					usedInLastSlab;
+};
+
+
+
+#endif // ARENA_H_
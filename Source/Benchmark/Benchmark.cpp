@@ -0,0 +1,258 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+// Benchmark driver: generates synthetic EU3 saves and converts each one several times,
+// reporting the median time of every top-level stage.  Built from the converter's sources
+// with EU3V2_BENCHMARK defined, which leaves out the converter's own main().
+//
+//		Benchmark --provinces 2000,5000,20000 --countries 250 --runs 5 --csv benchmark_results.csv
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "SaveGenerator.h"
+#include "../EU3toV2Converter.h"
+#include "../Log.h"
+#include "../Diagnostics.h"
+#include "../StageTimer.h"
+
+#include "wiz/load_data.h"
+
+
+
+// every run's measurements for one stage
+struct stageSamples
+{
+	std::string					name;
+	std::vector<long long>	wallMicros;
+	std::vector<long long>	cpuMicros;
+};
+
+
+static long long Median(std::vector<long long> samples)
+{
+	if (samples.empty())
+	{
+		return 0;
+	}
+	std::sort(samples.begin(), samples.end());
+	size_t middle = samples.size() / 2;
+	if ((samples.size() % 2) == 0)
+	{
+		return (samples[middle - 1] + samples[middle]) / 2;
+	}
+	return samples[middle];
+}
+
+
+static std::vector<int> ParseSizes(const std::string& list)
+{
+	std::vector<int> sizes;
+	std::istringstream stream(list);
+	std::string size;
+	while (std::getline(stream, size, ','))
+	{
+		if (!size.empty())
+		{
+			sizes.push_back(atoi(size.c_str()));
+		}
+	}
+	return sizes;
+}
+
+
+// Converts the save the given number of times and returns the samples for the conversion
+// and its direct sub-stages, in the order the stages first ran
+static std::vector<stageSamples> RunConversions(const std::string& saveFileName, int runs)
+{
+	std::vector<stageSamples>	samples;
+	std::map<std::string, size_t>	sampleIndex;
+	for (int run = 0; run < runs; ++run)
+	{
+		StageTimings::clear();
+		Diagnostics::clear();
+		LOG(LogLevel::Info) << "Benchmark run " << (run + 1) << " of " << runs;
+		int result = ConvertEU3ToV2(saveFileName);
+		if (result != 0)
+		{
+			LOG(LogLevel::Error) << "Conversion of " << saveFileName << " failed with code " << result;
+			exit(-1);
+		}
+
+		std::vector<stageTiming> timings = StageTimings::getTimings();
+		for (std::vector<stageTiming>::const_iterator itr = timings.begin(); itr != timings.end(); ++itr)
+		{
+			if (itr->depth > 1)
+			{
+				continue;
+			}
+			std::map<std::string, size_t>::iterator indexItr = sampleIndex.find(itr->name);
+			if (indexItr == sampleIndex.end())
+			{
+				indexItr = sampleIndex.insert(std::make_pair(itr->name, samples.size())).first;
+				samples.push_back(stageSamples());
+				samples.back().name = itr->name;
+			}
+			samples[indexItr->second].wallMicros.push_back(itr->wallMicros);
+			samples[indexItr->second].cpuMicros.push_back(itr->cpuMicros);
+		}
+	}
+	return samples;
+}
+
+
+int main(int argc, char * argv[])
+{
+	try
+	{
+		wiz::USE_REMOVE_IN_DATATYPE = true;
+		wiz::USE_EMPTY_VECTOR_IN_LOAD_DATA_TYPES = true;
+
+		saveGeneratorOptions	options;
+		std::vector<int>		sizes(1, options.provinces);
+		int						runs = 5;
+		std::string				csvFileName;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				LOG(LogLevel::Error) << "Missing value for " << arg;
+				return -1;
+			}
+			std::string value = argv[++i];
+			if (arg == "--provinces")
+			{
+				sizes = ParseSizes(value);
+			}
+			else if (arg == "--countries")
+			{
+				options.countries = atoi(value.c_str());
+			}
+			else if (arg == "--armies")
+			{
+				options.armiesPerCountry = atoi(value.c_str());
+			}
+			else if (arg == "--regiments")
+			{
+				options.regimentsPerArmy = atoi(value.c_str());
+			}
+			else if (arg == "--history")
+			{
+				options.historyEntries = atoi(value.c_str());
+			}
+			else if (arg == "--agreements")
+			{
+				options.agreements = atoi(value.c_str());
+			}
+			else if (arg == "--seed")
+			{
+				options.seed = static_cast<unsigned int>(strtoul(value.c_str(), NULL, 10));
+			}
+			else if (arg == "--runs")
+			{
+				runs = std::max(1, atoi(value.c_str()));
+			}
+			else if (arg == "--csv")
+			{
+				csvFileName = value;
+			}
+			else
+			{
+				LOG(LogLevel::Error) << "Unknown option " << arg;
+				return -1;
+			}
+		}
+		if (sizes.empty() || (options.countries < 1))
+		{
+			LOG(LogLevel::Error) << "Need at least one province count and one country";
+			return -1;
+		}
+
+		FILE* csvFile = NULL;
+		if (!csvFileName.empty())
+		{
+			if (fopen_s(&csvFile, csvFileName.c_str(), "w") != 0)
+			{
+				LOG(LogLevel::Error) << "Could not create " << csvFileName;
+				return -1;
+			}
+			fprintf(csvFile, "provinces,countries,runs,stage,median_wall_s,median_cpu_s\n");
+		}
+
+		for (std::vector<int>::const_iterator sizeItr = sizes.begin(); sizeItr != sizes.end(); ++sizeItr)
+		{
+			options.provinces = *sizeItr;
+			std::ostringstream saveFileName;
+			saveFileName << "benchmark_" << options.provinces << "_" << options.countries << "_" << options.seed << ".eu3";
+			LOG(LogLevel::Info) << "Generating " << saveFileName.str();
+			if (!GenerateEU3Save(saveFileName.str(), options))
+			{
+				LOG(LogLevel::Error) << "Could not create " << saveFileName.str();
+				return -1;
+			}
+
+			std::vector<stageSamples> samples = RunConversions(saveFileName.str(), runs);
+
+			LOG(LogLevel::Info) << "Median of " << runs << " runs with " << options.provinces << " provinces and " << options.countries << " countries:";
+			LOG(LogLevel::Info) << "     wall (s)     cpu (s)  stage";
+			for (std::vector<stageSamples>::const_iterator itr = samples.begin(); itr != samples.end(); ++itr)
+			{
+				double wall	= Median(itr->wallMicros) / 1000000.0;
+				double cpu	= Median(itr->cpuMicros) / 1000000.0;
+				std::ostringstream row;
+				row << std::fixed << std::setprecision(3);
+				row << std::setw(13) << wall << std::setw(12) << cpu << "  " << itr->name;
+				LOG(LogLevel::Info) << row.str();
+				if (csvFile != NULL)
+				{
+					fprintf(csvFile, "%d,%d,%d,\"%s\",%.6f,%.6f\n", options.provinces, options.countries, runs, itr->name.c_str(), wall, cpu);
+				}
+			}
+		}
+
+		if (csvFile != NULL)
+		{
+			fclose(csvFile);
+		}
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		LOG(LogLevel::Error) << e.what();
+		return -1;
+	}
+	catch (const std::string& e) {
+		LOG(LogLevel::Error) << e;
+		return -1;
+	}
+	catch (const char* e) {
+		LOG(LogLevel::Error) << e;
+		return -1;
+	}
+}
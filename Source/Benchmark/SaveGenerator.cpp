@@ -0,0 +1,407 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "SaveGenerator.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+static const char* const cultures[] =
+{
+	"english", "scottish", "french", "cosmopolitan_french", "castillian", "portugese", "lombard", "prussian",
+	"austrian", "swedish", "danish", "polish", "russian", "turkish", "arabic", "persian",
+	"hindustani", "bengali", "han", "japanese", "korean", "aztek", "inca", "mali"
+};
+static const char* const religions[] =
+{
+	"catholic", "protestant", "reformed", "orthodox", "sunni", "shiite", "hindu", "buddhism", "confucianism", "shinto", "animism"
+};
+static const char* const techGroups[] =
+{
+	"western", "eastern", "ottoman", "muslim", "indian", "chinese", "nomad_group", "sub_saharan", "new_world"
+};
+static const char* const governments[] =
+{
+	"feudal_monarchy", "despotic_monarchy", "administrative_monarchy", "absolute_monarchy", "constitutional_monarchy",
+	"merchant_republic", "noble_republic", "administrative_republic", "theocracy"
+};
+static const char* const tradeGoods[] =
+{
+	"grain", "wine", "wool", "cloth", "fish", "fur", "salt", "naval_supplies", "copper", "gold",
+	"iron", "slaves", "ivory", "tea", "chinaware", "spices", "coffee", "cotton", "sugar", "tobacco"
+};
+static const char* const buildings[] =
+{
+	"temple", "courthouse", "marketplace", "workshop", "fort1", "fort2", "dock", "shipyard", "barracks", "armory",
+	"college", "university", "weapons", "textile", "refinery", "wharf", "naval_base", "customs_house"
+};
+static const char* const regimentTypes[] =
+{
+	"western_medieval_infantry", "western_medieval_knights", "western_longbow", "chevauchee", "pike_and_shot",
+	"large_bronze_mortar", "swivel_cannon"
+};
+static const char* const shipTypes[] =
+{
+	"carrack", "galleon", "barque", "galley", "cog", "flute"
+};
+static const char* const agreementTypes[] =
+{
+	"royal_marriage", "guarantee", "vassal", "sphere", "alliance", "union"
+};
+
+#define COUNT_OF(array) (sizeof(array) / sizeof(array[0]))
+
+
+// AAA, AAB, ... skipping the tags the converter treats specially
+static std::vector<std::string> MakeTags(int count)
+{
+	std::vector<std::string> tags;
+	for (int i = 0; (static_cast<int>(tags.size()) < count) && (i < 26 * 26 * 26); ++i)
+	{
+		std::string tag;
+		tag += static_cast<char>('A' + (i / (26 * 26)));
+		tag += static_cast<char>('A' + ((i / 26) % 26));
+		tag += static_cast<char>('A' + (i % 26));
+		if ((tag == "REB") || (tag == "PIR") || (tag == "NAT"))
+		{
+			continue;
+		}
+		tags.push_back(tag);
+	}
+	return tags;
+}
+
+
+static std::string RandomDate(std::mt19937& generator, int firstYear, int lastYear)
+{
+	std::uniform_int_distribution<int> year(firstYear, lastYear);
+	std::uniform_int_distribution<int> month(1, 12);
+	std::uniform_int_distribution<int> day(1, 28);
+	char buffer[32];
+	sprintf_s(buffer, "%d.%d.%d", year(generator), month(generator), day(generator));
+	return buffer;
+}
+
+
+template<size_t N>
+static const char* Pick(std::mt19937& generator, const char* const (&choices)[N])
+{
+	std::uniform_int_distribution<size_t> index(0, N - 1);
+	return choices[index(generator)];
+}
+
+
+static void WriteProvince(FILE* output, std::mt19937& generator, const saveGeneratorOptions& options, int num, const std::string& owner, const std::vector<std::string>& tags)
+{
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<size_t> anyTag(0, tags.size() - 1);
+
+	const char* culture	= Pick(generator, cultures);
+	const char* religion	= Pick(generator, religions);
+
+	fprintf(output, "%d=\n{\n", num);
+	fprintf(output, "\tname=\"Province %d\"\n", num);
+	if (!owner.empty())
+	{
+		fprintf(output, "\towner=\"%s\"\n", owner.c_str());
+		fprintf(output, "\tcontroller=\"%s\"\n", owner.c_str());
+		fprintf(output, "\tcore=\"%s\"\n", owner.c_str());
+		if (unit(generator) < 0.2)
+		{
+			fprintf(output, "\tcore=\"%s\"\n", tags[anyTag(generator)].c_str());
+		}
+		fprintf(output, "\tcitysize=%d\n", 1000 + static_cast<int>(unit(generator) * 60000));
+	}
+	else
+	{
+		fprintf(output, "\tnative_size=%d\n", static_cast<int>(unit(generator) * 50));
+	}
+	fprintf(output, "\tculture=%s\n", culture);
+	fprintf(output, "\treligion=%s\n", religion);
+	fprintf(output, "\tbase_tax=%.3f\n", 1.0 + unit(generator) * 11.0);
+	fprintf(output, "\tmanpower=%.3f\n", unit(generator) * 5.0);
+	fprintf(output, "\ttrade_goods=%s\n", Pick(generator, tradeGoods));
+	for (size_t i = 0; i < COUNT_OF(buildings); ++i)
+	{
+		if (unit(generator) < 0.25)
+		{
+			fprintf(output, "\t%s=yes\n", buildings[i]);
+		}
+	}
+
+	// province 1 must have an owner in its history, it sets the first EU3 date
+	fprintf(output, "\thistory=\n\t{\n");
+	fprintf(output, "\t\towner=\"%s\"\n", owner.empty() ? tags[anyTag(generator)].c_str() : owner.c_str());
+	fprintf(output, "\t\tculture=%s\n", Pick(generator, cultures));
+	fprintf(output, "\t\treligion=%s\n", Pick(generator, religions));
+	std::vector<std::string> dates;
+	for (int i = 0; i < options.historyEntries; ++i)
+	{
+		dates.push_back(RandomDate(generator, 1400, 1820));
+	}
+	for (std::vector<std::string>::const_iterator itr = dates.begin(); itr != dates.end(); ++itr)
+	{
+		fprintf(output, "\t\t%s=\n\t\t{\n", itr->c_str());
+		double roll = unit(generator);
+		if (roll < 0.4)
+		{
+			fprintf(output, "\t\t\towner=\"%s\"\n", tags[anyTag(generator)].c_str());
+		}
+		else if (roll < 0.7)
+		{
+			fprintf(output, "\t\t\tculture=%s\n", Pick(generator, cultures));
+		}
+		else
+		{
+			fprintf(output, "\t\t\treligion=%s\n", Pick(generator, religions));
+		}
+		fprintf(output, "\t\t}\n");
+	}
+	if (!owner.empty())
+	{
+		fprintf(output, "\t\t1820.1.1=\n\t\t{\n\t\t\towner=\"%s\"\n\t\t\tculture=%s\n\t\t\treligion=%s\n\t\t}\n", owner.c_str(), culture, religion);
+	}
+	fprintf(output, "\t}\n");
+	fprintf(output, "}\n");
+}
+
+
+static void WriteArmy(FILE* output, std::mt19937& generator, const saveGeneratorOptions& options, bool navy, int armyNum,
+	const std::vector<int>& ownedProvinces, int& nextLeaderID, std::vector<int>& activeLeaders)
+{
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<size_t> anyProvince(0, ownedProvinces.size() - 1);
+
+	fprintf(output, "\t%s=\n\t{\n", navy ? "navy" : "army");
+	fprintf(output, "\t\tname=\"%d. %s\"\n", armyNum, navy ? "Fleet" : "Army");
+	fprintf(output, "\t\tlocation=%d\n", ownedProvinces[anyProvince(generator)]);
+	if (unit(generator) < 0.5)
+	{
+		fprintf(output, "\t\tleader=\n\t\t{\n\t\t\tid=%d\n\t\t\ttype=37\n\t\t}\n", nextLeaderID);
+		activeLeaders.push_back(nextLeaderID++);
+	}
+	for (int i = 0; i < options.regimentsPerArmy; ++i)
+	{
+		fprintf(output, "\t\t%s=\n\t\t{\n", navy ? "ship" : "regiment");
+		fprintf(output, "\t\t\tname=\"%d. %s\"\n", i + 1, navy ? "Ship" : "Regiment");
+		fprintf(output, "\t\t\thome=%d\n", ownedProvinces[anyProvince(generator)]);
+		fprintf(output, "\t\t\ttype=\"%s\"\n", navy ? Pick(generator, shipTypes) : Pick(generator, regimentTypes));
+		fprintf(output, "\t\t\tstrength=%.3f\n", 0.2 + unit(generator) * 0.8);
+		fprintf(output, "\t\t}\n");
+	}
+	fprintf(output, "\t}\n");
+}
+
+
+static void WriteCountry(FILE* output, std::mt19937& generator, const saveGeneratorOptions& options, const std::string& tag,
+	const std::vector<int>& ownedProvinces, const std::vector<std::string>& tags, int& nextLeaderID)
+{
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<int> slider(-5, 5);
+	std::uniform_int_distribution<size_t> anyTag(0, tags.size() - 1);
+
+	fprintf(output, "%s=\n{\n", tag.c_str());
+	fprintf(output, "\tname=\"Country %s\"\n", tag.c_str());
+	fprintf(output, "\tmap_color=\n\t{\n\t\t%d %d %d\n\t}\n", static_cast<int>(unit(generator) * 255), static_cast<int>(unit(generator) * 255), static_cast<int>(unit(generator) * 255));
+	if (!ownedProvinces.empty())
+	{
+		fprintf(output, "\tcapital=%d\n", ownedProvinces[0]);
+	}
+	fprintf(output, "\ttechnology_group=%s\n", Pick(generator, techGroups));
+	fprintf(output, "\tprimary_culture=%s\n", Pick(generator, cultures));
+	fprintf(output, "\taccepted_culture=%s\n", Pick(generator, cultures));
+	fprintf(output, "\treligion=%s\n", Pick(generator, religions));
+	fprintf(output, "\tgovernment=%s\n", Pick(generator, governments));
+	fprintf(output, "\tprestige=%.3f\n", unit(generator));
+	fprintf(output, "\tcultural_tradition=%.3f\n", unit(generator));
+	fprintf(output, "\tarmy_tradition=%.3f\n", unit(generator));
+	fprintf(output, "\tnavy_tradition=%.3f\n", unit(generator));
+	fprintf(output, "\tstability=%.3f\n", -3.0 + unit(generator) * 6.0);
+	fprintf(output, "\ttreasury=%.3f\n", unit(generator) * 1000.0);
+	fprintf(output, "\testimated_monthly_income=%.3f\n", unit(generator) * 50.0);
+	fprintf(output, "\tdiplomats=%d\n", static_cast<int>(unit(generator) * 5));
+	fprintf(output, "\tbadboy=%.3f\n", unit(generator) * 20.0);
+	fprintf(output, "\tlegitimacy=%.3f\n", unit(generator));
+	fprintf(output, "\tinflation=%.3f\n", unit(generator) * 10.0);
+	fprintf(output, "\tlast_bankrupt=\"%s\"\n", RandomDate(generator, 1500, 1800).c_str());
+
+	fprintf(output, "\ttechnology=\n\t{\n");
+	const char* const techs[] = { "land_tech", "naval_tech", "trade_tech", "production_tech", "government_tech" };
+	for (size_t i = 0; i < COUNT_OF(techs); ++i)
+	{
+		fprintf(output, "\t\t%s=\n\t\t{\n\t\t\t%d 0.000\n\t\t}\n", techs[i], 20 + static_cast<int>(unit(generator) * 40));
+	}
+	fprintf(output, "\t}\n");
+	fprintf(output, "\tdistribution=\n\t{\n\t\t0.100 0.100 0.200 0.100 0.200 0.200 0.100\n\t}\n");
+
+	const char* const sliders[] = { "centralization_decentralization", "aristocracy_plutocracy", "serfdom_freesubjects", "innovative_narrowminded",
+		"mercantilism_freetrade", "offensive_defensive", "land_naval", "quality_quantity" };
+	for (size_t i = 0; i < COUNT_OF(sliders); ++i)
+	{
+		fprintf(output, "\t%s=%d\n", sliders[i], slider(generator));
+	}
+	const char* const ideas[] = { "grand_army", "military_drill", "national_bank", "bureaucracy", "bill_of_rights", "deus_vult", "humanist_tolerance" };
+	for (size_t i = 0; i < COUNT_OF(ideas); ++i)
+	{
+		if (unit(generator) < 0.3)
+		{
+			fprintf(output, "\t%s=yes\n", ideas[i]);
+		}
+	}
+	fprintf(output, "\tflags=\n\t{\n\t\tsynthetic_flag=\n\t\t{\n\t\t}\n\t}\n");
+	fprintf(output, "\tmodifier=\n\t{\n\t\tmodifier=\"synthetic_modifier\"\n\t\tdate=\"1821.1.1\"\n\t}\n");
+
+	// leaders live in the history; the active ones are listed again at the top level
+	std::vector<int> activeLeaders;
+	fprintf(output, "\thistory=\n\t{\n");
+	for (int i = 0; i < options.historyEntries; ++i)
+	{
+		fprintf(output, "\t\t%s=\n\t\t{\n", RandomDate(generator, 1750, 1820).c_str());
+		fprintf(output, "\t\t\tleader=\n\t\t\t{\n");
+		fprintf(output, "\t\t\t\tname=\"Leader %d\"\n", nextLeaderID);
+		fprintf(output, "\t\t\t\ttype=%s\n", (unit(generator) < 0.7) ? "general" : "admiral");
+		fprintf(output, "\t\t\t\tmanuever=%d\n\t\t\t\tfire=%d\n\t\t\t\tshock=%d\n\t\t\t\tsiege=%d\n",
+			static_cast<int>(unit(generator) * 6), static_cast<int>(unit(generator) * 6), static_cast<int>(unit(generator) * 6), static_cast<int>(unit(generator) * 3));
+		fprintf(output, "\t\t\t\tactivation=\"%s\"\n", RandomDate(generator, 1750, 1820).c_str());
+		fprintf(output, "\t\t\t\tid=%d\n", nextLeaderID);
+		fprintf(output, "\t\t\t}\n");
+		fprintf(output, "\t\t}\n");
+		if (unit(generator) < 0.5)
+		{
+			activeLeaders.push_back(nextLeaderID);
+		}
+		++nextLeaderID;
+	}
+	fprintf(output, "\t}\n");
+
+	if (!ownedProvinces.empty())
+	{
+		for (int i = 0; i < options.armiesPerCountry; ++i)
+		{
+			WriteArmy(output, generator, options, (i % 2) == 1, i + 1, ownedProvinces, nextLeaderID, activeLeaders);
+		}
+	}
+	for (std::vector<int>::const_iterator itr = activeLeaders.begin(); itr != activeLeaders.end(); ++itr)
+	{
+		fprintf(output, "\tleader=\n\t{\n\t\tid=%d\n\t\ttype=37\n\t}\n", *itr);
+	}
+
+	if (unit(generator) < 0.3)
+	{
+		fprintf(output, "\tloan=\n\t{\n\t\tlender=\"%s\"\n\t\tinterest=%.3f\n\t\tamount=%d\n\t}\n", tags[anyTag(generator)].c_str(), 4.0 + unit(generator) * 4.0, static_cast<int>(unit(generator) * 500));
+	}
+
+	for (int i = 0; i < 5; ++i)
+	{
+		std::string other = tags[anyTag(generator)];
+		if (other == tag)
+		{
+			continue;
+		}
+		fprintf(output, "\t%s=\n\t{\n", other.c_str());
+		fprintf(output, "\t\tvalue=%d\n", static_cast<int>(-200 + unit(generator) * 400));
+		if (unit(generator) < 0.2)
+		{
+			fprintf(output, "\t\tmilitary_access=yes\n");
+		}
+		fprintf(output, "\t\tlast_send_diplomat=\"%s\"\n", RandomDate(generator, 1780, 1820).c_str());
+		fprintf(output, "\t}\n");
+	}
+	fprintf(output, "}\n");
+}
+
+
+bool GenerateEU3Save(const std::string& fileName, const saveGeneratorOptions& options)
+{
+	FILE* output;
+	if (fopen_s(&output, fileName.c_str(), "w") != 0)
+	{
+		return false;
+	}
+
+	std::mt19937 generator(options.seed);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::vector<std::string> tags = MakeTags(options.countries);
+	if (tags.empty())
+	{
+		fclose(output);
+		return false;
+	}
+
+	// hand out the provinces in contiguous blocks, leaving about a tenth uncolonized
+	std::vector<std::string> owners(options.provinces + 1);
+	std::vector<std::vector<int>> ownedProvinces(tags.size());
+	for (int num = 1; num <= options.provinces; ++num)
+	{
+		if ((num == 1) || (unit(generator) >= 0.1))
+		{
+			size_t country = static_cast<size_t>((num - 1) * static_cast<long long>(tags.size()) / options.provinces);
+			owners[num] = tags[country];
+			ownedProvinces[country].push_back(num);
+		}
+	}
+
+	fprintf(output, "date=\"1821.1.1\"\n");
+	fprintf(output, "player=\"%s\"\n", tags[0].c_str());
+
+	for (int num = 1; num <= options.provinces; ++num)
+	{
+		WriteProvince(output, generator, options, num, owners[num], tags);
+	}
+
+	int nextLeaderID = 1;
+	for (size_t i = 0; i < tags.size(); ++i)
+	{
+		WriteCountry(output, generator, options, tags[i], ownedProvinces[i], tags, nextLeaderID);
+	}
+
+	std::uniform_int_distribution<size_t> anyTag(0, tags.size() - 1);
+	fprintf(output, "diplomacy=\n{\n");
+	for (int i = 0; i < options.agreements; ++i)
+	{
+		std::string first		= tags[anyTag(generator)];
+		std::string second	= tags[anyTag(generator)];
+		if (first == second)
+		{
+			continue;
+		}
+		fprintf(output, "\t%s=\n\t{\n", agreementTypes[i % COUNT_OF(agreementTypes)]);
+		fprintf(output, "\t\tfirst=\"%s\"\n\t\tsecond=\"%s\"\n", first.c_str(), second.c_str());
+		fprintf(output, "\t\tstart_date=\"%s\"\n", RandomDate(generator, 1600, 1820).c_str());
+		fprintf(output, "\t}\n");
+	}
+	fprintf(output, "}\n");
+
+	fprintf(output, "trade=\n{\n");
+	for (int num = 1; num <= options.provinces; num += 50)
+	{
+		fprintf(output, "\tcot=\n\t{\n\t\tlocation=%d\n\t\tlevel=1\n\t}\n", num);
+	}
+	fprintf(output, "}\n");
+
+	fclose(output);
+	return true;
+}
@@ -0,0 +1,52 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef SAVEGENERATOR_H_
+#define SAVEGENERATOR_H_
+
+#include <string>
+
+
+
+// What to put in a synthetic save
+struct saveGeneratorOptions
+{
+	saveGeneratorOptions() : provinces(1882), countries(250), armiesPerCountry(4), regimentsPerArmy(10), historyEntries(6), agreements(400), seed(1) {}
+
+	int				provinces;			// numbered 1..provinces; 1774, 1814 and 1882 are the IN, HttT and DW maps
+	int				countries;
+	int				armiesPerCountry;	// half armies, half navies
+	int				regimentsPerArmy;
+	int				historyEntries;	// dated history blocks per province and per country
+	int				agreements;			// diplomacy agreements, spread over the agreement types
+	unsigned int	seed;
+};
+
+
+// Writes an EU3 save with the same key layout the converter reads from a real one
+// (provinces, countries with armies/leaders/loans/relations, diplomacy and centers of trade).
+// Returns false if the file could not be created.
+bool GenerateEU3Save(const std::string& fileName, const saveGeneratorOptions& options);
+
+
+
+#endif // SAVEGENERATOR_H_
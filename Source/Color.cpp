@@ -25,6 +25,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <chrono>
 #include <random>
+#include <thread>
 
 // remove - #include <boost/lexical_cast.hpp>
 
@@ -57,7 +58,9 @@ void Color::RandomlyFlunctuate(const int stdDev)
 {
 	// All three color components will go up or down by the some amount (according to stdDev), 
 	// and then each is tweaked a bit more (with a much smaller standard deviation).
-	static std::mt19937 generator(static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()));
+	// one generator per thread, as countries are read in parallel
+	thread_local std::mt19937 generator(static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()
+		^ std::hash<std::thread::id>()(std::this_thread::get_id())));
 	const double allChange = std::normal_distribution<double>(0.0, stdDev)(generator);	// the amount the colors all change by
 	std::normal_distribution<double> distribution(0.0, stdDev / 4.0);
 	for (auto& component : c)	// the component under consideration
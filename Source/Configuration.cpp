@@ -60,9 +60,73 @@ Configuration::Configuration()
 	V2DocumentsPath		= (obj[0]->GetItem("V2Documentsdirectory", true)[0].Get(0).ToString());
 	EU3Path				= (obj[0]->GetItem("EU3directory", true)[0].Get(0).ToString());
 	EU3gametype			= (obj[0]->GetItem("EU3gametype", true)[0].Get(0).ToString());
-	V2Gametype			= (obj[0]->GetItem("V2gametype", true)[0].Get(0).ToString());
+	V2GametypeName		= (obj[0]->GetItem("V2gametype", true)[0].Get(0).ToString());
 	EU3Mod				= (obj[0]->GetItem("EU3Mod", true)[0].Get(0).ToString());
 	Removetype			= (obj[0]->GetItem("removetype", true)[0].Get(0).ToString());
 	convertPopTotals	= ((obj[0]->GetItem("convertPopTotals", true)[0].Get(0).ToString()) == "yes");
 	outputName			= "";
+
+	if (V2GametypeName == "vanilla")
+	{
+		V2Game = V2Vanilla;
+	}
+	else if (V2GametypeName == "AHD")
+	{
+		V2Game = V2AHD;
+	}
+	else if (V2GametypeName == "HOD")
+	{
+		V2Game = V2HOD;
+	}
+	else if (V2GametypeName == "HoD-NNM")
+	{
+		V2Game = V2HODNNM;
+	}
+	else
+	{
+		LOG(LogLevel::Error) << "Unknown V2gametype " << V2GametypeName << " - must be vanilla, AHD, HOD or HoD-NNM";
+		exit(-1);
+	}
+
+	std::vector<wiz::load_data::ItemType<wiz::DataType>> stageTraceObj = obj[0]->GetItem("stage_trace", true);
+	stageTrace			= ((stageTraceObj.size() > 0) && (stageTraceObj[0].Get(0).ToString() == "yes"));
+
+	// optional - how many threads to use for the parallel stages, 0 for one per core
+	std::vector<wiz::load_data::ItemType<wiz::DataType>> threadsObj = obj[0]->GetItem("threads", true);
+	threads				= (threadsObj.size() > 0) ? static_cast<unsigned int>(threadsObj[0].Get(0).ToInt()) : 0;
+
+	// optional - whether to keep binary snapshots of the parsed V2 data, on unless set to no
+	std::vector<wiz::load_data::ItemType<wiz::DataType>> staticDataCacheObj = obj[0]->GetItem("static_data_cache", true);
+	staticDataCache	= ((staticDataCacheObj.size() == 0) || (staticDataCacheObj[0].Get(0).ToString() != "no"));
+
+	// optional - whether to keep a binary snapshot of the EU3 world built from each save
+	std::vector<wiz::load_data::ItemType<wiz::DataType>> worldSnapshotObj = obj[0]->GetItem("world_snapshot", true);
+	worldSnapshot		= ((worldSnapshotObj.size() > 0) && (worldSnapshotObj[0].Get(0).ToString() == "yes"));
+
+	// optional - the least severe messages to write to the log (error, warning, info or debug)
+	std::vector<wiz::load_data::ItemType<wiz::DataType>> logLevelObj = obj[0]->GetItem("log_level", true);
+	if (logLevelObj.size() > 0)
+	{
+		std::string logLevel = logLevelObj[0].Get(0).ToString();
+		if (logLevel == "error")
+		{
+			Log::SetMinLevel(LogLevel::Error);
+		}
+		else if (logLevel == "warning")
+		{
+			Log::SetMinLevel(LogLevel::Warning);
+		}
+		else if (logLevel == "info")
+		{
+			Log::SetMinLevel(LogLevel::Info);
+		}
+		else if (logLevel == "debug")
+		{
+			Log::SetMinLevel(LogLevel::Debug);
+		}
+		else
+		{
+			LOG(LogLevel::Warning) << "Unknown log_level " << logLevel << " in configuration.txt; logging everything";
+		}
+	}
 }
\ No newline at end of file
@@ -30,6 +30,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+// The V2 games that can be converted to
+enum V2Gametype
+{
+	V2Vanilla,
+	V2AHD,
+	V2HOD,
+	V2HODNNM
+};
+
+
 class Configuration // Singleton
 {
 	private:
@@ -48,10 +58,15 @@ class Configuration // Singleton
 		static std::string	getEU3Mod()									{ return getInstance()->EU3Mod; }
 		static std::string	getV2DocumentsPath()						{ return getInstance()->V2DocumentsPath; }
 		static std::string	getEU3Gametype()							{ return getInstance()->EU3gametype; }
-		static std::string	getV2Gametype()							{ return getInstance()->V2Gametype; }
+		static V2Gametype	getV2Gametype()							noexcept { return getInstance()->V2Game; }
+		static std::string	getV2GametypeName()						{ return getInstance()->V2GametypeName; }
 		static std::string	getRemovetype()							{ return getInstance()->Removetype; }
 		static std::string	getOutputName()							{ return getInstance()->outputName; }
 		static bool		getConvertPopTotals()						{ return getInstance()->convertPopTotals; }
+		static bool		getStageTrace()								{ return getInstance()->stageTrace; }
+		static unsigned int	getThreads()								{ return getInstance()->threads; }
+		static bool		getStaticDataCache()						{ return getInstance()->staticDataCache; }
+		static bool		getWorldSnapshot()							{ return getInstance()->worldSnapshot; }
 		static void		setOutputName(std::string _outputName)	{ getInstance()->outputName = _outputName; }
 
 		static Configuration* getInstance()
@@ -71,11 +86,16 @@ class Configuration // Singleton
 		std::string	EU3Mod;					// the name of the EU3 mod to use for conversion
 		std::string	V2Path;					// the install directory for V2
 		std::string	V2DocumentsPath;		// V2's directory under My Documents
-		std::string	V2Gametype;				// whether V2 is vanilla, AHD, or HoD
+		std::string	V2GametypeName;		// whether V2 is vanilla, AHD, HOD or HoD-NNM
+		V2Gametype	V2Game;					// the same, resolved once
 		std::string	resetProvinces;		// whether or not to reset allowed provinces back to V2 defaults
 		double	MaxLiteracy;			// the maximum literacy allowed
 		std::string	Removetype;				// the rule to use for removing excess EU3 nations
 		bool	convertPopTotals;		// whether or not to convert pop totals
+		bool	stageTrace;				// whether or not to export stage timings as a Chrome trace
+		unsigned int	threads;				// how many threads parallel stages use, 0 for one per core
+		bool	staticDataCache;		// whether or not to keep binary snapshots of the parsed V2 data
+		bool	worldSnapshot;			// whether or not to keep a binary snapshot of each save's EU3 world
 
 		// items set during conversion
 		date	firstEU3Date;
@@ -68,12 +68,12 @@ bool CountryMapping::ReadRules(const std::string& fileName)
 
 	// Convert rule nodes into our map data structure.
 	LOG(LogLevel::Debug) << "Building rules map";
-	std::map<std::string, std::vector<std::string>> newEU3TagToV2TagsRules;
+	std::unordered_map<CountryTag, std::vector<CountryTag>> newEU3TagToV2TagsRules;
 	for (std::vector<wiz::load_data::UserType*>::iterator i = ruleNodes.begin(); i != ruleNodes.end(); ++i)
 	{
 		//vector<Object*> rule = (*i)->getLeaves();	// an individual rule
-		std::string newEU3Tag;									// the EU3 tag in the rule
-		std::vector<std::string>	V2Tags;							// the V2 tags in the rule
+		CountryTag newEU3Tag;									// the EU3 tag in the rule
+		std::vector<CountryTag>	V2Tags;							// the V2 tags in the rule
 
 		for (int j=0; j < (*i)->GetItemListSize(); ++j)
 		{
@@ -109,46 +109,46 @@ void CountryMapping::CreateMapping(const EU3World& srcWorld, const V2World& dest
 	int generatedV2TagSuffix = 0; // two digit suffix
 
 	// Get the EU3 tags for all countries we want to map.
-	std::set<std::string> EU3TagsToMap;		// the EU3 tags that still need mapping
-	const std::map<std::string, EU3Country*> EU3Countries = srcWorld.getCountries();	// all the EU3 countries
-	for (std::map<std::string, EU3Country*>::const_iterator i = EU3Countries.begin(); i != EU3Countries.end(); ++i)
+	std::set<CountryTag> EU3TagsToMap;		// the EU3 tags that still need mapping
+	const std::map<CountryTag, EU3Country*>& EU3Countries = srcWorld.getCountries();	// all the EU3 countries
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = EU3Countries.begin(); i != EU3Countries.end(); ++i)
 	{
 		EU3TagsToMap.insert(i->first);
 	}
 
 	// Find a V2 tag from the rules for each EU3 tag.
-	const std::map<std::string, V2Country*> V2Countries = destWorld.getPotentialCountries();
-	for (std::set<std::string>::iterator i = EU3TagsToMap.begin(); i != EU3TagsToMap.end(); ++i)
+	const std::map<CountryTag, V2Country*> V2Countries = destWorld.getPotentialCountries();
+	for (std::set<CountryTag>::iterator i = EU3TagsToMap.begin(); i != EU3TagsToMap.end(); ++i)
 	{
-		const std::string& EU3Tag = *i;	// the EU3 tag being considered
+		CountryTag EU3Tag = *i;	// the EU3 tag being considered
 		bool mapped = false;					// whether or not the EU3 tag has been mapped
 		// Find a V2 tag from our rule if possible.
-		std::map<std::string, std::vector<std::string>>::iterator findIter = EU3TagToV2TagsRules.find(EU3Tag);	// the rule (if any) with this EU3 tag
+		std::unordered_map<CountryTag, std::vector<CountryTag>>::iterator findIter = EU3TagToV2TagsRules.find(EU3Tag);	// the rule (if any) with this EU3 tag
 		if (findIter != EU3TagToV2TagsRules.end())
 		{
-			const std::vector<std::string>& possibleV2Tags = findIter->second;
+			const std::vector<CountryTag>& possibleV2Tags = findIter->second;
 			// We want to use a V2 tag that corresponds to an actual V2 country if possible.
-			for (std::vector<std::string>::const_iterator j = possibleV2Tags.begin(); j != possibleV2Tags.end() && !mapped; ++j)
+			for (std::vector<CountryTag>::const_iterator j = possibleV2Tags.begin(); j != possibleV2Tags.end() && !mapped; ++j)
 			{
-				const std::string& V2Tag = *j;
+				CountryTag V2Tag = *j;
 				if (V2Countries.find(V2Tag) != V2Countries.end() && EU3TagToV2TagMapR.find(V2Tag) == EU3TagToV2TagMapR.end())
 				{
 					mapped = true;
-					EU3TagToV2TagMapL.insert(make_pair(EU3Tag, V2Tag));
-					EU3TagToV2TagMapR.insert(make_pair(V2Tag, EU3Tag));
+					EU3TagToV2TagMapL.insert(std::make_pair(EU3Tag, V2Tag));
+					EU3TagToV2TagMapR.insert(std::make_pair(V2Tag, EU3Tag));
 					LogMapping(EU3Tag, V2Tag, "default V2 country");
 				}
 			}
 			if (!mapped)
 			{	// None of the V2 tags in our rule correspond to an actual V2 country, so we just use the first unused V2 tag.
-				for (std::vector<std::string>::const_iterator j = possibleV2Tags.begin(); j != possibleV2Tags.end() && !mapped; ++j)
+				for (std::vector<CountryTag>::const_iterator j = possibleV2Tags.begin(); j != possibleV2Tags.end() && !mapped; ++j)
 				{
-					const std::string& V2Tag = *j;
+					CountryTag V2Tag = *j;
 					if (EU3TagToV2TagMapR.find(V2Tag) == EU3TagToV2TagMapR.end())
 					{
 						mapped = true;
-						EU3TagToV2TagMapL.insert(make_pair(EU3Tag, V2Tag));
-						EU3TagToV2TagMapR.insert(make_pair(V2Tag, EU3Tag));
+						EU3TagToV2TagMapL.insert(std::make_pair(EU3Tag, V2Tag));
+						EU3TagToV2TagMapR.insert(std::make_pair(V2Tag, EU3Tag));
 						LogMapping(EU3Tag, V2Tag, "mapping rule, not a V2 country");
 					}
 				}
@@ -161,9 +161,9 @@ void CountryMapping::CreateMapping(const EU3World& srcWorld, const V2World& dest
 			// We generate a new V2 tag for it.
 			std::ostringstream generatedV2TagStream;
 			generatedV2TagStream << generatedV2TagPrefix << std::setfill('0') << std::setw(2) << generatedV2TagSuffix;
-			std::string V2Tag = generatedV2TagStream.str();
-			EU3TagToV2TagMapL.insert(make_pair(EU3Tag, V2Tag));
-			EU3TagToV2TagMapR.insert(make_pair(V2Tag, EU3Tag));
+			CountryTag V2Tag = generatedV2TagStream.str();
+			EU3TagToV2TagMapL.insert(std::make_pair(EU3Tag, V2Tag));
+			EU3TagToV2TagMapR.insert(std::make_pair(V2Tag, EU3Tag));
 			LogMapping(EU3Tag, V2Tag, "generated tag");
 			// Prepare the next generated tag.
 			++generatedV2TagSuffix;
@@ -176,12 +176,11 @@ void CountryMapping::CreateMapping(const EU3World& srcWorld, const V2World& dest
 	}
 }
 
-const std::string& CountryMapping::GetV2Tag(const std::string& EU3Tag) const
+CountryTag CountryMapping::GetV2Tag(CountryTag EU3Tag) const
 {
 	// The following EU3 tags always map to the V2 rebel tag.
-	const std::vector<std::string> EU3RebelTags = { "REB", "PIR", "NAT" };
-	static const std::string V2RebelTag = "REB";
-	if (std::find(EU3RebelTags.begin(), EU3RebelTags.end(), EU3Tag) != EU3RebelTags.end())
+	static const CountryTag V2RebelTag = "REB";
+	if ((EU3Tag == CountryTag("REB")) || (EU3Tag == CountryTag("PIR")) || (EU3Tag == CountryTag("NAT")))
 	{
 		return V2RebelTag;
 	}
@@ -193,12 +192,11 @@ const std::string& CountryMapping::GetV2Tag(const std::string& EU3Tag) const
 	}
 	else
 	{
-		static const std::string EU3TagNotFound = "";
-		return EU3TagNotFound;
+		return CountryTag();
 	}
 }
 
-const std::string& CountryMapping::GetEU3Tag(const std::string& V2Tag) const
+CountryTag CountryMapping::GetEU3Tag(CountryTag V2Tag) const
 {
 	auto findIter = EU3TagToV2TagMapR.find(V2Tag);
 	if (findIter != EU3TagToV2TagMapR.end())
@@ -207,12 +205,11 @@ const std::string& CountryMapping::GetEU3Tag(const std::string& V2Tag) const
 	}
 	else
 	{
-		static const std::string V2TagNotFound = "";
-		return V2TagNotFound;
+		return CountryTag();
 	}
 }
 
-void CountryMapping::LogMapping(const std::string& EU3Tag, const std::string& V2Tag, const std::string& reason)
+void CountryMapping::LogMapping(CountryTag EU3Tag, CountryTag V2Tag, const std::string& reason)
 {
 	LOG(LogLevel::Debug) << "Mapping " << EU3Tag << " -> " << V2Tag << " (" << reason << ')';
 }
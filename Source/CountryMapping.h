@@ -26,7 +26,9 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "CountryTag.h"
 
 // remove? - #include <boost/bimap.hpp>
 
@@ -47,25 +49,25 @@ public:
 	// are given a generated tag "X00"-"X99".
 	void CreateMapping(const EU3World& srcWorld, const V2World& destWorld);
 
-	// Returns the V2 tag that is mapped to by the given EU3 tag. Returns an empty string
+	// Returns the V2 tag that is mapped to by the given EU3 tag. Returns an empty tag
 	// if there is no corresponding V2 tag. If CreateMapping() has been called then there
 	// is guaranteed to be a V2 tag for every EU3 country.
-	const std::string& operator[](const std::string& EU3Tag) const	{ return GetV2Tag(EU3Tag); }
-	// Returns the V2 tag that is mapped to by the given EU3 tag. Returns an empty string
+	CountryTag operator[](CountryTag EU3Tag) const	{ return GetV2Tag(EU3Tag); }
+	// Returns the V2 tag that is mapped to by the given EU3 tag. Returns an empty tag
 	// if there is no corresponding V2 tag. If CreateMapping() has been called then there
 	// is guaranteed to be a V2 tag for every EU3 country.
-	const std::string& GetV2Tag(const std::string& EU3Tag) const;
-	// Returns the EU3 tag that maps to the given V2 tag. Returns an empty string if there
+	CountryTag GetV2Tag(CountryTag EU3Tag) const;
+	// Returns the EU3 tag that maps to the given V2 tag. Returns an empty tag if there
 	// is no such EU3 tag.
-	const std::string& GetEU3Tag(const std::string& V2Tag) const;
+	CountryTag GetEU3Tag(CountryTag V2Tag) const;
 
 private:
 	// Writes the given mapping to the log.
-	static void LogMapping(const std::string& EU3Tag, const std::string& V2Tag, const std::string& reason);
+	static void LogMapping(CountryTag EU3Tag, CountryTag V2Tag, const std::string& reason);
 
-	std::map<std::string, std::vector<std::string>> EU3TagToV2TagsRules;
-	std::map<std::string, std::string> EU3TagToV2TagMapL; // left
-	std::map<std::string, std::string> EU3TagToV2TagMapR; // right
+	std::unordered_map<CountryTag, std::vector<CountryTag>> EU3TagToV2TagsRules;
+	std::unordered_map<CountryTag, CountryTag> EU3TagToV2TagMapL; // left
+	std::unordered_map<CountryTag, CountryTag> EU3TagToV2TagMapR; // right
 	// boost::bimap -> 2 std::map
 };
 
@@ -0,0 +1,48 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "CountryTag.h"
+#include <cstdlib>
+#include "Log.h"
+
+
+
+CountryTag::CountryTag(const std::string& tag)
+{
+	if (tag.size() > 4)
+	{
+		LOG(LogLevel::Error) << "\"" << tag << "\" is too long to be a country tag";
+		exit(-1);
+	}
+	packed = pack(tag.c_str(), tag.size());
+}
+
+
+std::string CountryTag::str() const
+{
+	std::string tag;
+	for (int shift = 24; (shift >= 0) && (((packed >> shift) & 0xff) != 0); shift -= 8)
+	{
+		tag.push_back(static_cast<char>((packed >> shift) & 0xff));
+	}
+	return tag;
+}
@@ -0,0 +1,96 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef COUNTRYTAG_H_
+#define COUNTRYTAG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+
+
+// A country tag ("ENG", "REB", "X01") packed into one 32-bit value, first character in the
+// highest byte.  Tags of up to four characters fit, compare as integers, order alphabetically
+// like the strings they replace and never touch the heap.
+class CountryTag
+{
+	public:
+		constexpr CountryTag() noexcept: packed(0) {}						// no tag
+		template<size_t N> constexpr CountryTag(const char (&tag)[N]) noexcept: packed(pack(tag, N - 1))
+		{
+			static_assert(N <= 5, "country tags are at most four characters");
+		}
+		CountryTag(const std::string& tag);									// exits on tags over four characters
+
+		std::string		str()			const;
+		bool				empty()		const noexcept	{ return packed == 0; }
+		uint32_t			getPacked()	const noexcept	{ return packed; }
+		operator std::string()			const				{ return str(); }
+
+		constexpr bool operator==(CountryTag rhs)	const noexcept	{ return packed == rhs.packed; }
+		constexpr bool operator!=(CountryTag rhs)	const noexcept	{ return packed != rhs.packed; }
+		constexpr bool operator<(CountryTag rhs)	const noexcept	{ return packed < rhs.packed; }
+		bool operator==(const std::string& rhs)	const				{ return str() == rhs; }
+		bool operator!=(const std::string& rhs)	const				{ return str() != rhs; }
+		bool operator==(const char* rhs)				const				{ return str() == rhs; }
+		bool operator!=(const char* rhs)				const				{ return str() != rhs; }
+
+	private:
+		static constexpr uint32_t pack(const char* tag, size_t length) noexcept
+		{
+			uint32_t result = 0;
+			for (size_t i = 0; i < 4; ++i)
+			{
+				result = (result << 8) | ((i < length) ? static_cast<unsigned char>(tag[i]) : 0);
+			}
+			return result;
+		}
+
+		uint32_t packed;
+};
+
+
+inline bool operator==(const std::string& lhs, CountryTag rhs)	{ return rhs == lhs; }
+inline bool operator!=(const std::string& lhs, CountryTag rhs)	{ return rhs != lhs; }
+inline bool operator==(const char* lhs, CountryTag rhs)			{ return rhs == lhs; }
+inline bool operator!=(const char* lhs, CountryTag rhs)			{ return rhs != lhs; }
+inline std::string operator+(const std::string& lhs, CountryTag rhs)	{ return lhs + rhs.str(); }
+inline std::string operator+(CountryTag lhs, const std::string& rhs)	{ return lhs.str() + rhs; }
+inline std::string operator+(const char* lhs, CountryTag rhs)			{ return lhs + rhs.str(); }
+inline std::string operator+(CountryTag lhs, const char* rhs)			{ return lhs.str() + rhs; }
+inline std::ostream& operator<<(std::ostream& out, CountryTag tag)	{ return out << tag.str(); }
+
+
+namespace std
+{
+	template<> struct hash<CountryTag>
+	{
+		size_t operator()(CountryTag tag) const noexcept { return tag.getPacked(); }
+	};
+}
+
+
+
+#endif // COUNTRYTAG_H_
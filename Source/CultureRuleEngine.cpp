@@ -0,0 +1,158 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "CultureRuleEngine.h"
+#include <string>
+
+
+
+CultureRuleEngine::CultureRuleEngine(const cultureMapping& rules, const EU3RegionsMapping& regions, bool _regionOverrides)
+	: regionOverrides(_regionOverrides)
+{
+	// number every region, including any the rules name that no province is in
+	std::unordered_map<std::string, unsigned int> regionIndices;
+	for (EU3RegionsMapping::const_iterator itr = regions.begin(); itr != regions.end(); ++itr)
+	{
+		for (std::set<std::string>::const_iterator regionItr = itr->second.begin(); regionItr != itr->second.end(); ++regionItr)
+		{
+			regionIndices.insert(std::make_pair(*regionItr, static_cast<unsigned int>(regionIndices.size())));
+		}
+	}
+	for (cultureMapping::const_iterator itr = rules.begin(); itr != rules.end(); ++itr)
+	{
+		for (std::vector<distinguisher>::const_iterator distItr = itr->distinguishers.begin(); distItr != itr->distinguishers.end(); ++distItr)
+		{
+			if (distItr->first == DTRegion)
+			{
+				regionIndices.insert(std::make_pair(distItr->second.str(), static_cast<unsigned int>(regionIndices.size())));
+			}
+		}
+	}
+	const size_t numWords = (regionIndices.size() + 63) / 64;
+
+	for (EU3RegionsMapping::const_iterator itr = regions.begin(); itr != regions.end(); ++itr)
+	{
+		if (itr->first < 0)
+		{
+			continue;
+		}
+		regionSet& provinceSet = provinceRegions[itr->first];
+		provinceSet.resize(numWords, 0);
+		for (std::set<std::string>::const_iterator regionItr = itr->second.begin(); regionItr != itr->second.end(); ++regionItr)
+		{
+			unsigned int index = regionIndices[*regionItr];
+			provinceSet[index / 64] |= (uint64_t(1) << (index % 64));
+		}
+	}
+
+	for (cultureMapping::const_iterator itr = rules.begin(); itr != rules.end(); ++itr)
+	{
+		compiledRule rule;
+		rule.dstCulture = itr->dstCulture;
+		for (std::vector<distinguisher>::const_iterator distItr = itr->distinguishers.begin(); distItr != itr->distinguishers.end(); ++distItr)
+		{
+			compiledDistinguisher compiled;
+			compiled.type			= distItr->first;
+			compiled.region		= 0;
+			compiled.impossible	= false;
+			if (distItr->first == DTOwner)
+			{
+				if (distItr->second.str().size() > 4)
+				{
+					compiled.impossible = true;	// longer than any tag, so no owner matches
+				}
+				else
+				{
+					compiled.owner = CountryTag(distItr->second.str());
+				}
+			}
+			else if (distItr->first == DTReligion)
+			{
+				compiled.religion = distItr->second;
+			}
+			else if (distItr->first == DTRegion)
+			{
+				compiled.region = regionIndices[distItr->second.str()];
+			}
+			rule.distinguishers.push_back(compiled);
+		}
+		rulesByCulture[itr->srcCulture].push_back(std::move(rule));
+	}
+}
+
+
+Symbol CultureRuleEngine::resolve(Symbol culture, Symbol religion, CountryTag ownerTag, int srcProvince) const
+{
+	std::unordered_map<Symbol, std::vector<compiledRule>>::const_iterator rules = rulesByCulture.find(culture);
+	if (rules == rulesByCulture.end())
+	{
+		return Symbol();
+	}
+	for (std::vector<compiledRule>::const_iterator itr = rules->second.begin(); itr != rules->second.end(); ++itr)
+	{
+		if (holds(*itr, religion, ownerTag, srcProvince))
+		{
+			return itr->dstCulture;
+		}
+	}
+	return Symbol();
+}
+
+
+bool CultureRuleEngine::holds(const compiledRule& rule, Symbol religion, CountryTag ownerTag, int srcProvince) const
+{
+	ProvinceTable<regionSet>::const_iterator provinceSet = provinceRegions.end();
+	bool match = true;
+	for (std::vector<compiledDistinguisher>::const_iterator itr = rule.distinguishers.begin(); itr != rule.distinguishers.end(); ++itr)
+	{
+		if (itr->type == DTOwner)
+		{
+			if (itr->impossible || (itr->owner != ownerTag))
+			{
+				match = false;
+			}
+		}
+		else if (itr->type == DTReligion)
+		{
+			if (itr->religion != religion)
+			{
+				match = false;
+			}
+		}
+		else if (itr->type == DTRegion)
+		{
+			if (provinceSet == provinceRegions.end())
+			{
+				provinceSet = provinceRegions.find(srcProvince);
+			}
+			if ((provinceSet == provinceRegions.end()) || ((provinceSet->second[itr->region / 64] & (uint64_t(1) << (itr->region % 64))) == 0))
+			{
+				match = false;
+			}
+			else if (regionOverrides)
+			{
+				match = true;
+			}
+		}
+	}
+	return match;
+}
@@ -0,0 +1,82 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef CULTURERULEENGINE_H_
+#define CULTURERULEENGINE_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "CountryTag.h"
+#include "Mapper.h"
+#include "ProvinceTable.h"
+#include "Symbol.h"
+
+
+
+// Maps EU3 cultures to V2 cultures by the rules of a culture map.  The rules are compiled once: they
+// are indexed by their EU3 culture, and their owner, religion and region distinguishers become tag,
+// Symbol and region-bit comparisons, so resolving a culture neither scans the rules nor compares
+// strings.
+class CultureRuleEngine
+{
+public:
+	CultureRuleEngine() = default;
+	// With regionOverrides, a region distinguisher that holds makes the rule hold again even after an
+	// earlier distinguisher failed, as the main culture map always worked; otherwise every
+	// distinguisher must hold.
+	CultureRuleEngine(const cultureMapping& rules, const EU3RegionsMapping& regions, bool regionOverrides);
+
+	// Returns the V2 culture of the first rule for the given culture that holds for the given
+	// religion, owner and EU3 province, or an empty Symbol if no rule does.
+	Symbol resolve(Symbol culture, Symbol religion, CountryTag ownerTag, int srcProvince) const;
+	// Returns true if there is any rule for the given culture.
+	bool hasRules(Symbol culture) const	{ return rulesByCulture.count(culture) > 0; }
+
+private:
+	typedef std::vector<uint64_t> regionSet;	// one bit per region
+
+	struct compiledDistinguisher
+	{
+		distinguisherType	type;
+		CountryTag			owner;
+		Symbol				religion;
+		unsigned int		region;			// the region's bit in a province's regionSet
+		bool					impossible;		// an owner longer than any tag
+	};
+
+	struct compiledRule
+	{
+		Symbol										dstCulture;
+		std::vector<compiledDistinguisher>	distinguishers;	// in culture map order
+	};
+
+	bool holds(const compiledRule& rule, Symbol religion, CountryTag ownerTag, int srcProvince) const;
+
+	std::unordered_map<Symbol, std::vector<compiledRule>>	rulesByCulture;	// in culture map order
+	ProvinceTable<regionSet>										provinceRegions;
+	bool																	regionOverrides = false;
+};
+
+
+
+#endif // CULTURERULEENGINE_H_
@@ -0,0 +1,106 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "DemographicCache.h"
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include "Log.h"
+
+
+
+DemographicCache::DemographicCache(const CultureRuleEngine& _cultureRules, const CultureRuleEngine& _slaveCultureRules,
+	const religionMapping& _religionMap, const EU3RegionsMapping& regions)
+	: cultureRules(_cultureRules), slaveCultureRules(_slaveCultureRules), religionMap(_religionMap), hits(0), misses(0)
+{
+	std::map<std::set<std::string>, int> regionSetIds;
+	for (EU3RegionsMapping::const_iterator itr = regions.begin(); itr != regions.end(); ++itr)
+	{
+		if (itr->first < 0)
+		{
+			continue;
+		}
+		int regionSet = regionSetIds.insert(std::make_pair(itr->second, static_cast<int>(regionSetIds.size()))).first->second;
+		provinceRegionSets.insert(std::make_pair(itr->first, regionSet));
+	}
+}
+
+
+resolvedDemographic DemographicCache::resolve(Symbol culture, Symbol religion, CountryTag ownerTag, int srcProvince) const
+{
+	key entryKey;
+	entryKey.culture		= culture.getId();
+	entryKey.religion		= religion.getId();
+	entryKey.owner			= ownerTag.getPacked();
+	ProvinceTable<int>::const_iterator regionSet = provinceRegionSets.find(srcProvince);
+	entryKey.regionSet	= (regionSet != provinceRegionSets.end()) ? regionSet->second : -1;
+
+	{
+		std::shared_lock<std::shared_mutex> readGuard(lock);
+		std::unordered_map<key, resolvedDemographic, keyHash>::const_iterator entry = entries.find(entryKey);
+		if (entry != entries.end())
+		{
+			++hits;
+			return entry->second;
+		}
+	}
+
+	++misses;
+	resolvedDemographic demographic;
+	demographic.culture			= cultureRules.resolve(culture, religion, ownerTag, srcProvince);
+	demographic.slaveCulture	= slaveCultureRules.resolve(culture, religion, ownerTag, srcProvince);
+	religionMapping::const_iterator religionItr = religionMap.find(religion);
+	if (religionItr != religionMap.end())
+	{
+		demographic.religion = religionItr->second;
+	}
+
+	std::unique_lock<std::shared_mutex> writeGuard(lock);
+	entries.insert(std::make_pair(entryKey, demographic));
+	return demographic;
+}
+
+
+void DemographicCache::logStatistics() const
+{
+	std::shared_lock<std::shared_mutex> readGuard(lock);
+	unsigned long long cacheHits	= hits;
+	unsigned long long lookups		= cacheHits + misses;
+	if (lookups == 0)
+	{
+		return;
+	}
+	LOG(LogLevel::Debug) << "Demographic cache: " << lookups << " lookups, " << (100.0 * cacheHits / lookups) << "% hits, "
+		<< entries.size() << " combinations";
+}
+
+
+size_t DemographicCache::keyHash::operator()(const key& k) const noexcept
+{
+	uint64_t hash = (static_cast<uint64_t>(k.culture) << 32) | k.religion;
+	hash ^= ((static_cast<uint64_t>(k.owner) << 32) | static_cast<uint32_t>(k.regionSet)) * 0x9E3779B97F4A7C15ull;
+	hash ^= hash >> 29;
+	hash *= 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 32;
+	return static_cast<size_t>(hash);
+}
@@ -0,0 +1,94 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef DEMOGRAPHICCACHE_H_
+#define DEMOGRAPHICCACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include "CountryTag.h"
+#include "CultureRuleEngine.h"
+#include "Mapper.h"
+#include "ProvinceTable.h"
+#include "Symbol.h"
+
+
+
+// The V2 culture, slave culture and religion for pops of one EU3 culture and religion.  Each is empty
+// if no rule or mapping gives one.
+struct resolvedDemographic
+{
+	Symbol	culture;
+	Symbol	slaveCulture;
+	Symbol	religion;
+};
+
+
+// Remembers how each combination of EU3 culture, religion, owner and set of regions resolves, since
+// many source provinces share one, and each is converted once for every V2 province it maps to.
+// The rules never change, so entries stay valid from one save to the next.  resolve() may be called
+// from several threads.
+class DemographicCache
+{
+public:
+	DemographicCache(const CultureRuleEngine& _cultureRules, const CultureRuleEngine& _slaveCultureRules,
+		const religionMapping& _religionMap, const EU3RegionsMapping& regions);
+
+	resolvedDemographic resolve(Symbol culture, Symbol religion, CountryTag ownerTag, int srcProvince) const;
+
+	// Writes how many lookups there have been and how many were answered from the cache to the log.
+	void logStatistics() const;
+
+private:
+	struct key
+	{
+		unsigned int	culture;
+		unsigned int	religion;
+		uint32_t			owner;
+		int				regionSet;		// provinces in the same regions resolve alike
+
+		bool operator==(const key& rhs) const noexcept
+		{
+			return (culture == rhs.culture) && (religion == rhs.religion) && (owner == rhs.owner) && (regionSet == rhs.regionSet);
+		}
+	};
+	struct keyHash
+	{
+		size_t operator()(const key& k) const noexcept;
+	};
+
+	const CultureRuleEngine&	cultureRules;
+	const CultureRuleEngine&	slaveCultureRules;
+	const religionMapping&		religionMap;
+	ProvinceTable<int>			provinceRegionSets;	// provinces in no region have none
+
+	mutable std::shared_mutex														lock;
+	mutable std::unordered_map<key, resolvedDemographic, keyHash>	entries;
+	mutable std::atomic<unsigned long long>									hits;
+	mutable std::atomic<unsigned long long>									misses;
+};
+
+
+
+#endif // DEMOGRAPHICCACHE_H_
@@ -0,0 +1,203 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "Diagnostics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+
+
+
+static const char* LogLevelName(LogLevel level)
+{
+	switch (level)
+	{
+		case LogLevel::Error:
+			return "error";
+		case LogLevel::Warning:
+			return "warning";
+		case LogLevel::Info:
+			return "info";
+		default:
+			return "debug";
+	}
+}
+
+
+std::string JSONEscape(const std::string& text)
+{
+	std::string escaped;
+	escaped.reserve(text.size());
+	for (std::string::const_iterator itr = text.begin(); itr != text.end(); ++itr)
+	{
+		switch (*itr)
+		{
+			case '"':
+				escaped += "\\\"";
+				break;
+			case '\\':
+				escaped += "\\\\";
+				break;
+			case '\n':
+				escaped += "\\n";
+				break;
+			case '\t':
+				escaped += "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(*itr) < 0x20)
+				{
+					char code[8];
+					sprintf_s(code, "\\u%04x", static_cast<unsigned char>(*itr));
+					escaped += code;
+				}
+				else
+				{
+					escaped += *itr;
+				}
+		}
+	}
+	return escaped;
+}
+
+
+Diagnostic::~Diagnostic()
+{
+	Diagnostics::record(level, key, detail.str());
+}
+
+
+Diagnostics* Diagnostics::getInstance()
+{
+	static Diagnostics* instance = new Diagnostics();
+	return instance;
+}
+
+
+void Diagnostics::record(LogLevel level, const std::string& key, const std::string& detail)
+{
+	Diagnostics* diagnostics = getInstance();
+
+	unsigned int count;
+	{
+		std::lock_guard<std::mutex> lock(diagnostics->entriesLock);
+		std::map<std::string, entry>::iterator itr = diagnostics->entries.find(key);
+		if (itr == diagnostics->entries.end())
+		{
+			entry newEntry;
+			newEntry.level	= level;
+			newEntry.count	= 0;
+			itr = diagnostics->entries.insert(std::make_pair(key, newEntry)).first;
+		}
+		count = ++(itr->second.count);
+		if (count <= maxExamples)
+		{
+			itr->second.examples.push_back(detail);
+		}
+	}
+
+	if (count <= maxExamples)
+	{
+		if (detail.empty())
+		{
+			LOG(level) << key;
+		}
+		else
+		{
+			LOG(level) << key << ": " << detail;
+		}
+	}
+	if (count == maxExamples)
+	{
+		LOG(level) << "Further \"" << key << "\" messages will only be counted in the diagnostics summary";
+	}
+}
+
+
+static bool EntryCountPredicate(const std::pair<std::string, unsigned int>& lhs, const std::pair<std::string, unsigned int>& rhs)
+{
+	if (lhs.second != rhs.second)
+	{
+		return lhs.second > rhs.second;
+	}
+	return lhs.first < rhs.first;
+}
+
+
+void Diagnostics::writeSummary(const std::string& jsonFileName)
+{
+	Diagnostics* diagnostics = getInstance();
+	std::lock_guard<std::mutex> lock(diagnostics->entriesLock);
+
+	// most frequent first
+	std::vector<std::pair<std::string, unsigned int>> sortedKeys;
+	for (std::map<std::string, entry>::const_iterator itr = diagnostics->entries.begin(); itr != diagnostics->entries.end(); ++itr)
+	{
+		sortedKeys.push_back(std::make_pair(itr->first, itr->second.count));
+	}
+	sort(sortedKeys.begin(), sortedKeys.end(), EntryCountPredicate);
+
+	LOG(LogLevel::Info) << "Diagnostics summary (" << sortedKeys.size() << " distinct messages)";
+	for (std::vector<std::pair<std::string, unsigned int>>::const_iterator itr = sortedKeys.begin(); itr != sortedKeys.end(); ++itr)
+	{
+		const entry& e = diagnostics->entries[itr->first];
+		std::ostringstream row;
+		row << std::setw(9) << e.count << "  " << std::left << std::setw(8) << LogLevelName(e.level) << itr->first;
+		LOG(LogLevel::Info) << row.str();
+	}
+
+	FILE* jsonFile;
+	if (fopen_s(&jsonFile, jsonFileName.c_str(), "w") != 0)
+	{
+		LOG(LogLevel::Warning) << "Could not create diagnostics file " << jsonFileName;
+		return;
+	}
+	fprintf(jsonFile, "{\n");
+	fprintf(jsonFile, "\t\"diagnostics\": [");
+	for (std::vector<std::pair<std::string, unsigned int>>::const_iterator itr = sortedKeys.begin(); itr != sortedKeys.end(); ++itr)
+	{
+		const entry& e = diagnostics->entries[itr->first];
+		fprintf(jsonFile, "%s\n\t\t{\n", (itr == sortedKeys.begin()) ? "" : ",");
+		fprintf(jsonFile, "\t\t\t\"message\": \"%s\",\n", JSONEscape(itr->first).c_str());
+		fprintf(jsonFile, "\t\t\t\"level\": \"%s\",\n", LogLevelName(e.level));
+		fprintf(jsonFile, "\t\t\t\"count\": %u,\n", e.count);
+		fprintf(jsonFile, "\t\t\t\"examples\": [");
+		for (std::vector<std::string>::const_iterator exItr = e.examples.begin(); exItr != e.examples.end(); ++exItr)
+		{
+			fprintf(jsonFile, "%s\"%s\"", (exItr == e.examples.begin()) ? "" : ", ", JSONEscape(*exItr).c_str());
+		}
+		fprintf(jsonFile, "]\n");
+		fprintf(jsonFile, "\t\t}");
+	}
+	fprintf(jsonFile, "\n\t]\n");
+	fprintf(jsonFile, "}\n");
+	fclose(jsonFile);
+}
+
+
+void Diagnostics::clear()
+{
+	Diagnostics* diagnostics = getInstance();
+	std::lock_guard<std::mutex> lock(diagnostics->entriesLock);
+	diagnostics->entries.clear();
+}
@@ -0,0 +1,94 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#ifndef DIAGNOSTICS_H_
+#define DIAGNOSTICS_H_
+
+#include "Log.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Reports a message that may repeat thousands of times in one conversion, e.g.
+//		DIAGNOSE(LogLevel::Warning, "No mapping for province") << provinceNum;
+// The first few occurrences of each key are logged as usual, the rest are only counted.
+// Diagnostics::writeSummary() reports the totals at the end of the conversion.
+#define DIAGNOSE(LOG_LEVEL, KEY) Diagnostic(LOG_LEVEL, KEY)
+
+// Escapes text for use inside a JSON string literal
+std::string JSONEscape(const std::string& text);
+
+
+class Diagnostic
+{
+	public:
+		Diagnostic(LogLevel _level, const char* _key) : level(_level), key(_key) {}
+		~Diagnostic();
+
+		template<class T>
+		Diagnostic& operator<<(T t)
+		{
+			detail << t;
+			return *this;
+		}
+
+	private:
+		LogLevel					level;
+		const char*				key;
+		std::ostringstream	detail;
+};
+
+
+class Diagnostics // Singleton
+{
+	public:
+		// counts one occurrence of key, keeping detail as an example if there are not yet enough
+		static void	record(LogLevel level, const std::string& key, const std::string& detail);
+
+		// logs a table of every key with its count, and writes the same as JSON to jsonFileName
+		static void	writeSummary(const std::string& jsonFileName);
+
+		// forgets everything recorded so far
+		static void	clear();
+
+		static const unsigned int maxExamples = 5;	// examples kept (and logged) per key
+
+	private:
+		Diagnostics() {}
+		static Diagnostics* getInstance();
+
+		struct entry
+		{
+			LogLevel							level;
+			unsigned int					count;
+			std::vector<std::string>	examples;
+		};
+
+		std::mutex								entriesLock;
+		std::map<std::string, entry>		entries;		// message template -> occurrences
+};
+
+
+
+#endif // DIAGNOSTICS_H_
@@ -24,25 +24,28 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "EU3Army.h"
 #include "../Log.h"
+#include "../Diagnostics.h"
+#include "../FieldTable.h"
+#include "../Snapshot.h"
 #include "wiz/load_data.h"
 
 
 EU3Regiment::EU3Regiment(const wiz::load_data::UserType *obj)
 {
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objName = obj->GetItem("name");
-	if (objName.size() > 0)
+	static const FieldTable<EU3Regiment> fields = FieldTable<EU3Regiment>()
+		.field("name", &EU3Regiment::name)
+		.field("strength", &EU3Regiment::strength)
+		.collect("type")
+		.collect("home");
+
+	name		= "";
+	strength	= 0.0;
+	fieldMatches found = fields.apply(obj, *this);
+
+	const wiz::load_data::ItemType<wiz::DataType>* objType = found.getItem("type");
+	if (objType != nullptr)
 	{
-		name = objName[0].Get(0).ToString();
-	}
-	else
-	{
-		name = "";
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objType = obj->GetItem("type");
-	if (objType.size() > 0)
-	{
-		type = objType[0].Get(0).ToString();
+		type = objType->Get(0).ToString();
 	}
 	else
 	{
@@ -50,10 +53,10 @@ EU3Regiment::EU3Regiment(const wiz::load_data::UserType *obj)
 		type = "";
 	}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objHome = obj->GetItem("home");
-	if (objHome.size() > 0)
+	const wiz::load_data::ItemType<wiz::DataType>* objHome = found.getItem("home");
+	if (objHome != nullptr)
 	{
-		home = objHome[0].Get(0).ToInt();
+		home = objHome->Get(0).ToInt();
 	}
 	else
 	{
@@ -61,37 +64,55 @@ EU3Regiment::EU3Regiment(const wiz::load_data::UserType *obj)
 		home = -1;
 	}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objStr = obj->GetItem("strength");
-	if (objStr.size() > 0)
-	{
-		strength = (double)objStr[0].Get(0).ToFloat();
-	}
-	else
-	{
-		strength = 0.0;
-	}
-
 	category		= num_reg_categories;
 	type_strength	= 0;
 }
 
 
-EU3Army::EU3Army(const wiz::load_data::UserType *obj)
+EU3Regiment::EU3Regiment(SnapshotReader& snapshot)
 {
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objName = obj->GetItem("name");
-	if (objName.size() > 0)
-	{
-		name = objName[0].Get(0).ToString();
-	}
-	else
-	{
-		name = "";
-	}
+	name				= snapshot.readString();
+	type				= snapshot.readString();
+	home				= static_cast<int>(snapshot.readInt());
+	strength			= snapshot.readDouble();
+	category			= (RegimentCategory)snapshot.readInt();
+	type_strength	= static_cast<int>(snapshot.readInt());
+}
+
+
+void EU3Regiment::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(name);
+	snapshot.writeString(type);
+	snapshot.writeInt(home);
+	snapshot.writeDouble(strength);
+	snapshot.writeInt(category);
+	snapshot.writeInt(type_strength);
+}
+
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objLoc = obj->GetItem("location");
-	if (objLoc.size() > 0)
+EU3Army::EU3Army(const wiz::load_data::UserType *obj, ObjectPool<EU3Regiment>& regimentPool)
+{
+	static const FieldTable<EU3Army> fields = FieldTable<EU3Army>()
+		.field("name", &EU3Army::name)
+		.field("at_sea", &EU3Army::at_sea)
+		.userType("leader", [](EU3Army& army, wiz::load_data::UserType* leaderObj)
+			{
+				army.leaderID = leaderObj->GetItem("id")[0].Get(0).ToInt();
+			})
+		.collect("location")
+		.collect("regiment")
+		.collect("ship");
+
+	name		= "";
+	at_sea		= 0;
+	leaderID	= 0;
+	fieldMatches found = fields.apply(obj, *this);
+
+	const wiz::load_data::ItemType<wiz::DataType>* objLoc = found.getItem("location");
+	if (objLoc != nullptr)
 	{
-		location = objLoc[0].Get(0).ToInt();
+		location = objLoc->Get(0).ToInt();
 	}
 	else
 	{
@@ -99,41 +120,59 @@ EU3Army::EU3Army(const wiz::load_data::UserType *obj)
 		location = -1;
 	}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objAtSea = obj->GetItem("at_sea");
-	if (objAtSea.size() > 0)
+	// regiments before ships, whatever order the save lists them in
+	regiments.clear();
+	const fieldMatches::userTypeList& objRegs = found.getUserTypes("regiment");
+	for (fieldMatches::userTypeList::const_iterator itr = objRegs.begin(); itr != objRegs.end(); ++itr)
 	{
-		at_sea = objAtSea[0].Get(0).ToInt();
+		EU3Regiment* reg = regimentPool.make(*itr);
+		regiments.push_back(reg);
 	}
-	else
+	const fieldMatches::userTypeList& objShips = found.getUserTypes("ship");
+	for (fieldMatches::userTypeList::const_iterator itr = objShips.begin(); itr != objShips.end(); ++itr)
 	{
-		at_sea = 0;
+		EU3Regiment* reg = regimentPool.make(*itr);
+		regiments.push_back(reg);
 	}
 
-	regiments.clear();
-	std::vector<wiz::load_data::UserType*> objRegs = obj->GetUserTypeItem("regiment");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objRegs.begin(); itr != objRegs.end(); ++itr)
+	blocked_homes.clear();
+}
+
+
+EU3Army::EU3Army(SnapshotReader& snapshot, ObjectPool<EU3Regiment>& regimentPool)
+{
+	name			= snapshot.readString();
+	location		= static_cast<int>(snapshot.readInt());
+	at_sea		= static_cast<int>(snapshot.readInt());
+	leaderID		= static_cast<int>(snapshot.readInt());
+	size_t numRegiments = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numRegiments); ++i)
 	{
-		EU3Regiment* reg = new EU3Regiment(*itr);
-		regiments.push_back(reg);
+		regiments.push_back(regimentPool.make(snapshot));
 	}
-	std::vector<wiz::load_data::UserType*> objShips = obj->GetUserTypeItem("ship");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objShips.begin(); itr != objShips.end(); ++itr)
+	size_t numBlockedHomes = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numBlockedHomes); ++i)
 	{
-		EU3Regiment* reg = new EU3Regiment(*itr);
-		regiments.push_back(reg);
+		blocked_homes.push_back(static_cast<int>(snapshot.readInt()));
 	}
+}
 
-	blocked_homes.clear();
 
-	std::vector<wiz::load_data::UserType*> objLeader = obj->GetUserTypeItem("leader");
-	if (objLeader.size() > 0)
+void EU3Army::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(name);
+	snapshot.writeInt(location);
+	snapshot.writeInt(at_sea);
+	snapshot.writeInt(leaderID);
+	snapshot.writeInt(regiments.size());
+	for (std::vector<EU3Regiment*>::const_iterator itr = regiments.begin(); itr != regiments.end(); ++itr)
 	{
-		//objLeader = objLeader[0]->getValue("id");
-		leaderID = objLeader[0]->GetItem("id")[0].Get(0).ToInt();
+		(*itr)->writeSnapshot(snapshot);
 	}
-	else
+	snapshot.writeInt(blocked_homes.size());
+	for (std::vector<int>::const_iterator itr = blocked_homes.begin(); itr != blocked_homes.end(); ++itr)
 	{
-		leaderID = 0;
+		snapshot.writeInt(*itr);
 	}
 }
 
@@ -150,7 +189,7 @@ void EU3Army::resolveRegimentTypes(const RegimentTypeMap& regimentTypeMap)
 		}
 		else
 		{
-			LOG(LogLevel::Warning) << "Unknown unit type " << (*itr)->getType() << " for regiment \"" << (*itr)->getName() << "\"\n";
+			DIAGNOSE(LogLevel::Warning, "Unknown unit type") << (*itr)->getType() << " for regiment \"" << (*itr)->getName() << "\"";
 		}
 	}
 }
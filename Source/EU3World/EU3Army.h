@@ -33,6 +33,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "wiz/load_data_types.h"
+#include "../Arena.h"
+
+class SnapshotReader;
+class SnapshotWriter;
 
 
 typedef enum
@@ -69,6 +73,8 @@ class EU3Regiment // also Ship
 {
 	public:
 		EU3Regiment(const wiz::load_data::UserType* obj);
+		EU3Regiment(SnapshotReader& snapshot);
+		void					writeSnapshot(SnapshotWriter& snapshot) const;
 
 		void					setCategory(const RegimentCategory cat) { category = cat; }
 		void					setTypeStrength(const int typeStrength) { type_strength = typeStrength; }
@@ -92,7 +98,9 @@ private:
 class EU3Army // also Navy
 {
 	public:
-		EU3Army(const wiz::load_data::UserType* obj);
+		EU3Army(const wiz::load_data::UserType* obj, ObjectPool<EU3Regiment>& regimentPool);
+		EU3Army(SnapshotReader& snapshot, ObjectPool<EU3Regiment>& regimentPool);
+		void						writeSnapshot(SnapshotWriter& snapshot) const;
 		void						resolveRegimentTypes(const RegimentTypeMap& regimentTypeMap);
 		double						getAverageStrength(RegimentCategory category) const;
 		int							getTotalTypeStrength(RegimentCategory category) const;
@@ -0,0 +1,161 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef EU3BUILDINGS_H_
+#define EU3BUILDINGS_H_
+
+
+
+#include <bitset>
+#include <string>
+
+
+
+// The buildings read from a province in the save.  Each run of six base buildings is in the order of
+// its levels, which getBuildingLineLevel relies on.
+#define EU3_SAVE_BUILDING_LIST(DO) \
+	/* unique buildings */ \
+	DO(tax_assessor) \
+	DO(embassy) \
+	DO(glorious_monument) \
+	DO(march) \
+	DO(grain_depot) \
+	DO(royal_palace) \
+	DO(war_college) \
+	DO(admiralty) \
+\
+	/* manufactories */ \
+	DO(weapons) \
+	DO(university) \
+	DO(wharf) \
+	DO(textile) \
+	DO(fine_arts_academy) \
+	DO(refinery) \
+\
+	/* base buildings */ \
+	DO(fort1) \
+	DO(fort2) \
+	DO(fort3) \
+	DO(fort4) \
+	DO(fort5) \
+	DO(fort6) \
+	DO(dock) \
+	DO(drydock) \
+	DO(shipyard) \
+	DO(grand_shipyard) \
+	DO(naval_arsenal) \
+	DO(naval_base) \
+	DO(temple) \
+	DO(courthouse) \
+	DO(spy_agency) \
+	DO(town_hall) \
+	DO(college) \
+	DO(cathedral) \
+	DO(armory) \
+	DO(training_fields) \
+	DO(barracks) \
+	DO(regimental_camp) \
+	DO(arsenal) \
+	DO(conscription_center) \
+	DO(constable) \
+	DO(workshop) \
+	DO(counting_house) \
+	DO(treasury_office) \
+	DO(mint) \
+	DO(stock_exchange) \
+	DO(marketplace) \
+	DO(trade_depot) \
+	DO(canal) \
+	DO(road_network) \
+	DO(post_office) \
+	DO(customs_house)
+
+// Every building the converter knows.  The province weights also look for these manufactories, but
+// they have never been read from the save, so a province never has them.
+#define EU3_BUILDING_LIST(DO) \
+	EU3_SAVE_BUILDING_LIST(DO) \
+	DO(plantations) \
+	DO(farm_estate) \
+	DO(tradecompany)
+
+
+#define MAKE_BUILDING_ENUM(NAME) BUILDING_ ## NAME,
+enum EU3Building
+{
+	EU3_BUILDING_LIST(MAKE_BUILDING_ENUM)
+	NUM_BUILDINGS
+};
+
+
+#define MAKE_BUILDING_NAME(NAME) #NAME,
+const char* const EU3BuildingNames[NUM_BUILDINGS] = {
+	EU3_BUILDING_LIST(MAKE_BUILDING_NAME)
+};
+
+
+#define COUNT_BUILDING(NAME) + 1
+const int numSaveBuildings = 0 EU3_SAVE_BUILDING_LIST(COUNT_BUILDING);
+
+
+// which buildings a province has, one bit per EU3Building
+typedef std::bitset<NUM_BUILDINGS> EU3BuildingSet;
+static_assert(NUM_BUILDINGS <= 64, "province snapshots keep the buildings in a single int");
+
+
+// The building with the given name, or NUM_BUILDINGS for one the converter doesn't know
+inline EU3Building findEU3Building(const std::string& name)
+{
+	for (int i = 0; i < NUM_BUILDINGS; ++i)
+	{
+		if (name == EU3BuildingNames[i])
+		{
+			return static_cast<EU3Building>(i);
+		}
+	}
+	return NUM_BUILDINGS;
+}
+
+
+// The Divine Wind level of a line of six base buildings, given its lowest building: 1, 2, 3, 4, 6 or 8
+// for its buildings from the lowest up, or 0 for none.  Where a province has more than one of a line,
+// the lowest counts.
+const int buildingLineLevels[6] = { 1, 2, 3, 4, 6, 8 };
+static_assert(	(BUILDING_cathedral == BUILDING_temple + 5) && (BUILDING_conscription_center == BUILDING_armory + 5) &&
+					(BUILDING_stock_exchange == BUILDING_constable + 5) && (BUILDING_customs_house == BUILDING_marketplace + 5),
+					"each building line must be six consecutive buildings");
+
+inline int getBuildingLineLevel(const EU3BuildingSet& buildings, EU3Building lowest)
+{
+	unsigned long long line = (buildings >> lowest).to_ullong() & 0x3F;
+	for (int i = 0; i < 6; ++i)
+	{
+		if (line & (1ULL << i))
+		{
+			return buildingLineLevels[i];
+		}
+	}
+	return 0;
+}
+
+
+
+#endif	// EU3BUILDINGS_H_
@@ -24,6 +24,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "EU3Country.h"
 #include "../Log.h"
+#include "../FieldTable.h"
+#include "../Snapshot.h"
 #include "EU3Province.h"
 #include "EU3Relations.h"
 #include "EU3Loan.h"
@@ -32,180 +34,191 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-EU3Country::EU3Country(const wiz::load_data::UserType* obj)
+EU3Country::EU3Country(const wiz::load_data::UserType* obj, Arena& _arena, ObjectPool<EU3Regiment>& regimentPool)
 {
-	tag = obj->GetName().ToString();
-
-	provinces.clear();
-	cores.clear();
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> nameObj = obj->GetItem("name");
-	if (!nameObj.empty())
-	{
-		name = nameObj[0].Get(0).ToString();
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> adjectiveObj = obj->GetItem("adjective");
-	if (!adjectiveObj.empty())
-	{
-		adjective = adjectiveObj[0].Get(0).ToString();
-	}
-
-	std::vector<wiz::load_data::UserType*> colorObj = obj->GetUserTypeItem("map_color");
-	if (!colorObj.empty())
-	{
-		color = Color(colorObj[0]);
-		// Countries whose colors are included in the object here tend to be generated countries,
-		// i.e. colonial nations which take on the color of their parent. To help distinguish 
-		// these countries from their parent's other colonies we randomly adjust the color.
-		color.RandomlyFlunctuate(30);
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> capitalObj = obj->GetItem("capital");
-	if (capitalObj.size() > 0)
-	{
-		capital = capitalObj[0].Get(0).ToInt();
-	}
-	else
+	static const FieldTable<EU3Country> fields = []()
 	{
-		capital = 0;
-	}
+		FieldTable<EU3Country> table;
+		table.field("name", &EU3Country::name);
+		table.field("adjective", &EU3Country::adjective);
+		table.userType("map_color", [](EU3Country& country, wiz::load_data::UserType* colorObj)
+		{
+			country.color = Color(colorObj);
+			// Countries whose colors are included in the object here tend to be generated countries,
+			// i.e. colonial nations which take on the color of their parent. To help distinguish 
+			// these countries from their parent's other colonies we randomly adjust the color.
+			country.color.RandomlyFlunctuate(30);
+		});
+		table.field("capital", &EU3Country::capital);
+		table.field("national_focus", &EU3Country::nationalFocus);
+		table.field("technology_group", &EU3Country::techGroup);
+		table.field("primary_culture", &EU3Country::primaryCulture);
+		table.list("accepted_culture", &EU3Country::acceptedCultures);
+		table.field("religion", &EU3Country::religion);
+		table.field("prestige", &EU3Country::prestige, 100.0);
+		table.field("cultural_tradition", &EU3Country::culture, 100.0);
+		table.field("army_tradition", &EU3Country::armyTradition, 100.0);
+		table.field("navy_tradition", &EU3Country::navyTradition, 100.0);
+		table.field("stability", &EU3Country::stability);
+		table.userType("technology", [](EU3Country& country, wiz::load_data::UserType* techsObj)
+		{
+			std::vector<wiz::load_data::UserType*> techObj = techsObj->GetUserTypeItem("land_tech");
+			country.landTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
+
+			techObj = techsObj->GetUserTypeItem("naval_tech");
+			country.navalTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
+
+			techObj = techsObj->GetUserTypeItem("trade_tech");
+			country.tradeTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
+
+			techObj = techsObj->GetUserTypeItem("production_tech");
+			country.productionTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
+
+			techObj = techsObj->GetUserTypeItem("government_tech");
+			country.governmentTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
+		});
+		table.field("estimated_monthly_income", &EU3Country::estMonthlyIncome);
+		table.collect("distribution");
+		table.userType("flags", &EU3Country::readFlags);
+		table.userType("hidden_flags", &EU3Country::readFlags);
+		table.userType("modifier", [](EU3Country& country, wiz::load_data::UserType* modifierObj)
+		{
+			std::vector<wiz::load_data::ItemType<wiz::DataType>> nameObject = modifierObj->GetItem("modifier"); 
+			//cf) getLeaves(); -> also date is included..?
+			if (nameObject.size() > 0)
+			{
+				country.modifiers[nameObject[0].Get(0).ToString()] = true;
+			}
+		}, true);
+		table.userType("history", [](EU3Country& country, wiz::load_data::UserType* historyObj)
+		{
+			std::vector<wiz::load_data::ItemType<wiz::DataType>> daimyoObj = historyObj->GetItem("daimyo");
+			if (daimyoObj.size() > 0)
+			{
+				country.possibleDaimyo = true;
+			}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> nfObj = obj->GetItem("national_focus");
-	if (nfObj.size() > 0)
-	{
-		nationalFocus = nfObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		nationalFocus = 0;
-	}
+			date hundredYearsOld = date("1740.1.1");
+			for (int i=0; i < historyObj->GetUserTypeListSize(); ++i)
+			{
+				auto x = historyObj->GetUserTypeList(i);
+				// grab leaders from history, ignoring those that are more than 100 years old...
+				if (date(x->GetName().ToString()) > hundredYearsOld)
+				{
+					std::vector<wiz::load_data::UserType*> leaderObjs = (x)->GetUserTypeItem("leader");
+					for (std::vector<wiz::load_data::UserType*>::iterator litr = leaderObjs.begin(); litr != leaderObjs.end(); ++litr)
+					{
+						EU3Leader* leader = country.arena->make<EU3Leader>(*litr);
+						country.leaders.push_back(leader);
+					}
+				}
+			}
+		});
+		table.collect("leader");
+		table.field("government", &EU3Country::government);
+		// international relations leaves
+		table.otherUserTypes([](EU3Country& country, wiz::load_data::UserType* x)
+		{
+			std::string key = x->GetName().ToString();
+			if ((key.size() == 3) &&
+				 (key.c_str()[0] >= 'A') && (key.c_str()[0] <= 'Z') &&
+				 (key.c_str()[1] >= 'A') && (key.c_str()[1] <= 'Z') &&
+				 (key.c_str()[2] >= 'A') && (key.c_str()[2] <= 'Z'))
+			{
+				EU3Relations* rel = country.arena->make<EU3Relations>(x);
+				country.relations.push_back(rel);
+			}
+		});
+		table.collect("army");
+		table.collect("navy");
+		table.field("centralization_decentralization", &EU3Country::centralization_decentralization);
+		table.field("aristocracy_plutocracy", &EU3Country::aristocracy_plutocracy);
+		table.field("serfdom_freesubjects", &EU3Country::serfdom_freesubjects);
+		table.field("innovative_narrowminded", &EU3Country::innovative_narrowminded);
+		table.field("mercantilism_freetrade", &EU3Country::mercantilism_freetrade);
+		table.field("offensive_defensive", &EU3Country::offensive_defensive);
+		table.field("land_naval", &EU3Country::land_naval);
+		table.field("quality_quantity", &EU3Country::quality_quantity);
+
+		const char* const ideas[] =
+		{
+			"press_gangs", "grand_navy", "sea_hawks", "superior_seamanship", "naval_glory", "excellent_shipwrights",
+			"naval_fighting_instruction", "naval_provisioning", "grand_army", "military_drill", "engineer_corps",
+			"battlefield_commisions", "glorious_arms", "national_conscripts", "regimental_system", "napoleonic_warfare",
+			"land_of_opportunity", "merchant_adventures", "colonial_ventures", "shrewd_commerce_practise", "vice_roys",
+			"quest_for_the_new_world", "scientific_revolution", "improved_foraging", "vetting", "bureaucracy",
+			"national_bank", "national_trade_policy", "espionage", "bill_of_rights", "smithian_economics",
+			"liberty_egalite_fraternity", "ecumenism", "church_attendance_duty", "divine_supremacy", "patron_of_art",
+			"deus_vult", "humanist_tolerance", "cabinet", "revolution_and_counter"
+		};
+		for (size_t i = 0; i < sizeof(ideas) / sizeof(ideas[0]); ++i)
+		{
+			table.item(ideas[i], &EU3Country::checkIdea);
+		}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> techGroupObj = obj->GetItem("technology_group");
-	if (techGroupObj.size() > 0)
-	{
-		techGroup = techGroupObj[0].Get(0).ToString();
-	}
-	else
-	{
-		techGroup = "";
-	}
+		table.field("treasury", &EU3Country::treasury);
+		table.field("last_bankrupt", &EU3Country::last_bankrupt);
+		table.userType("loan", [](EU3Country& country, wiz::load_data::UserType* loanObj)
+		{
+			EU3Loan* loan = country.arena->make<EU3Loan>(loanObj);
+			country.loans.push_back(loan);
+		}, true);
+		table.field("diplomats", &EU3Country::diplomats);
+		table.field("badboy", &EU3Country::badboy);
+		table.field("legitimacy", &EU3Country::legitimacy);
+		table.field("inflation", &EU3Country::inflation);
+		return table;
+	}();
+
+	arena	= &_arena;
+	tag	= obj->GetName().ToString();
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> primaryCultureObj = obj->GetItem("primary_culture");
-	if (primaryCultureObj.size() > 0)
-	{
-		primaryCulture = primaryCultureObj[0].Get(0).ToString();
-	}
-	else
-	{
-		primaryCulture = "";
-	}
+	provinces.clear();
+	cores.clear();
 
+	capital				= 0;
+	nationalFocus		= 0;
+	techGroup			= "";
+	primaryCulture		= Symbol();
 	acceptedCultures.clear();
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> acceptedCultureObj = obj->GetItem("accepted_culture");
-	for (unsigned int i = 0; i < acceptedCultureObj.size(); i++)
-	{
-		acceptedCultures.push_back(acceptedCultureObj[i].Get(0).ToString());
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> religionObj = obj->GetItem("religion");
-	if (religionObj.size() > 0)
-	{
-		religion = religionObj[0].Get(0).ToString();
-	}
-	else
-	{
-		religion = "";
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> prestigeObj = obj->GetItem("prestige");
-	if (prestigeObj.size() > 0)
-	{
-		prestige = 100 * prestigeObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		prestige = -100.0;
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> cultureObj = obj->GetItem("cultural_tradition");
-	if (cultureObj.size() > 0)
-	{
-		culture = 100 * cultureObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		culture = 0.0;
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> armyTraditionObj = obj->GetItem("army_tradition");
-	if (armyTraditionObj.size() > 0)
-	{
-		armyTradition = 100 * armyTraditionObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		armyTradition = 0.0;
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> navyTraditionObj = obj->GetItem("navy_tradition");
-	if (navyTraditionObj.size() > 0)
-	{
-		navyTradition = 100 * navyTraditionObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		navyTradition = 0.0;
-	}
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> stabilityObj = obj->GetItem("stability");
-	if (stabilityObj.size() > 0)
-	{
-		stability = stabilityObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		stability = -3.0;
-	}
-
-	std::vector<wiz::load_data::UserType*> techsObj = obj->GetUserTypeItem("technology");
-	if (techsObj.size() > 0)
-	{
-		std::vector<wiz::load_data::UserType*> techObj = techsObj[0]->GetUserTypeItem("land_tech");
-		landTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
-
-		techObj = techsObj[0]->GetUserTypeItem("naval_tech");
-		navalTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
-
-		techObj = techsObj[0]->GetUserTypeItem("trade_tech");
-		tradeTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
-
-		techObj = techsObj[0]->GetUserTypeItem("production_tech");
-		productionTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
-
-		techObj = techsObj[0]->GetUserTypeItem("government_tech");
-		governmentTech = techObj[0]->GetItemList(0).Get(0).ToFloat();
-	}
-	else
-	{
-		landTech		= 0.0;
-		navalTech		= 0.0;
-		tradeTech		= 0.0;
-		productionTech	= 0.0;
-		governmentTech	= 0.0;
-	}
+	religion				= Symbol();
+	prestige				= -100.0;
+	culture				= 0.0;
+	armyTradition		= 0.0;
+	navyTradition		= 0.0;
+	stability			= -3.0;
+	landTech				= 0.0;
+	navalTech			= 0.0;
+	tradeTech			= 0.0;
+	productionTech		= 0.0;
+	governmentTech		= 0.0;
+	estMonthlyIncome	= 0.0;
+	flags.clear();
+	modifiers.clear();
+	possibleDaimyo		= false;
+	leaders.clear();
+	government			= "";
+	armies.clear();
+	centralization_decentralization	= 0;
+	aristocracy_plutocracy				= 0;
+	serfdom_freesubjects					= 0;
+	innovative_narrowminded				= 0;
+	mercantilism_freetrade				= 0;
+	offensive_defensive					= 0;
+	land_naval								= 0;
+	quality_quantity						= 0;
+	nationalIdeas.clear();
+	treasury				= 0.0;
+	last_bankrupt		= date();
+	loans.clear();
+	diplomats			= 0;
+	badboy				= 0.0;
+	legitimacy			= 1.0;
+	inflation			= 0.0;
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> incomeObj = obj->GetItem("estimated_monthly_income");
-	if (incomeObj.size() > 0)
-	{
-		estMonthlyIncome = incomeObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		estMonthlyIncome = 0.0;
-	}
+	fieldMatches found = fields.apply(obj, *this);
 
-	std::vector<wiz::load_data::UserType*> investmentObj = obj->GetUserTypeItem("distribution");
+	const fieldMatches::userTypeList& investmentObj = found.getUserTypes("distribution");
 	if (investmentObj.size() > 0)
 	{
 		armyInvestment			= investmentObj[0]->GetItemList(2).Get(0).ToFloat() * estMonthlyIncome;
@@ -223,69 +236,11 @@ EU3Country::EU3Country(const wiz::load_data::UserType* obj)
 		cultureInvestment		= 0.0;
 	}
 
-	flags.clear();
-	std::vector<wiz::load_data::UserType*> flagObject = obj->GetUserTypeItem("flags");
-	if (flagObject.size() > 0)
-	{
-		for (int i = 0; i < flagObject[0]->GetUserTypeListSize(); i++)
-		{
-			flags[flagObject[0]->GetUserTypeList(i)->GetName().ToString()] = true;
-		}
-	}
-	flagObject	= obj->GetUserTypeItem("hidden_flags");
-	if (flagObject.size() > 0)
-	{
-		for (int i = 0; i < flagObject[0]->GetUserTypeListSize(); i++)
-		{
-			flags[flagObject[0]->GetUserTypeList(i)->GetName().ToString()] = true;
-		}
-	}
-
-	modifiers.clear();
-	std::vector<wiz::load_data::UserType*> modifierObject = obj->GetUserTypeItem("modifier");
-	for (unsigned int i = 0; i < modifierObject.size(); i++)
-	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> nameObject = modifierObject[i]->GetItem("modifier"); 
-		//cf) getLeaves(); -> also date is included..?
-		if (nameObject.size() > 0)
-		{
-			modifiers[nameObject[0].Get(0).ToString()] = true;
-		}
-	}
-
-	possibleDaimyo = false;
-	leaders.clear();
-	std::vector<wiz::load_data::UserType*> historyObj	= obj->GetUserTypeItem("history");
-	if (historyObj.size() > 0)
-	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> daimyoObj = historyObj[0]->GetItem("daimyo");
-		if (daimyoObj.size() > 0)
-		{
-			possibleDaimyo = true;
-		}
-
-		date hundredYearsOld = date("1740.1.1");
-		for (int i=0; i < historyObj[0]->GetUserTypeListSize(); ++i)
-		{
-			auto x = historyObj[0]->GetUserTypeList(i);
-			// grab leaders from history, ignoring those that are more than 100 years old...
-			if (date(x->GetName().ToString()) > hundredYearsOld)
-			{
-				std::vector<wiz::load_data::UserType*> leaderObjs = (x)->GetUserTypeItem("leader");
-				for (std::vector<wiz::load_data::UserType*>::iterator litr = leaderObjs.begin(); litr != leaderObjs.end(); ++litr)
-				{
-					EU3Leader* leader = new EU3Leader(*litr);
-					leaders.push_back(leader);
-				}
-			}
-		}
-	}
-
 	// figure out which leaders are active, and ditch the rest
-	std::vector<wiz::load_data::UserType*> activeLeaderObj = obj->GetUserTypeItem("leader");
+	const fieldMatches::userTypeList& activeLeaderObj = found.getUserTypes("leader");
 	std::vector<int> activeIds;
 	std::vector<EU3Leader*> activeLeaders;
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = activeLeaderObj.begin(); itr != activeLeaderObj.end(); ++itr)
+	for (fieldMatches::userTypeList::const_iterator itr = activeLeaderObj.begin(); itr != activeLeaderObj.end(); ++itr)
 	{
 		activeIds.push_back((*itr)->GetItem("id")[0].Get(0).ToInt());
 	}
@@ -297,231 +252,244 @@ EU3Country::EU3Country(const wiz::load_data::UserType* obj)
 	}
 	leaders.swap(activeLeaders);
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> governmentObj = obj->GetItem("government");
-	if (governmentObj.size() > 0)
-	{
-		government = governmentObj[0].Get(0).ToString();
-	}
-	else
-	{
-		government = "";
-	}
-
-	// Read international relations leaves
-	for (unsigned int i = 0; i < obj->GetUserTypeListSize(); ++i)
+	// armies before navies, whatever order the save lists them in
+	const fieldMatches::userTypeList& armyObj = found.getUserTypes("army");
+	for (fieldMatches::userTypeList::const_iterator itr = armyObj.begin(); itr != armyObj.end(); ++itr)
 	{
-		auto x = obj->GetUserTypeList(i);
-		std::string key = x->GetName().ToString();
-
-		if ((key.size() == 3) &&
-			 (key.c_str()[0] >= 'A') && (key.c_str()[0] <= 'Z') &&
-			 (key.c_str()[1] >= 'A') && (key.c_str()[1] <= 'Z') &&
-			 (key.c_str()[2] >= 'A') && (key.c_str()[2] <= 'Z'))
-		{
-			EU3Relations* rel = new EU3Relations(x);
-			relations.push_back(rel);
-		}
-	}
-
-	armies.clear();
-	std::vector<wiz::load_data::UserType*> armyObj = obj->GetUserTypeItem("army");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = armyObj.begin(); itr != armyObj.end(); ++itr)
-	{
-		EU3Army* army = new EU3Army(*itr);
+		EU3Army* army = arena->make<EU3Army>(*itr, regimentPool);
 		armies.push_back(army);
 	}
-	std::vector<wiz::load_data::UserType*> navyObj = obj->GetUserTypeItem("navy");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = navyObj.begin(); itr != navyObj.end(); ++itr)
+	const fieldMatches::userTypeList& navyObj = found.getUserTypes("navy");
+	for (fieldMatches::userTypeList::const_iterator itr = navyObj.begin(); itr != navyObj.end(); ++itr)
 	{
-		EU3Army* navy = new EU3Army(*itr);
+		EU3Army* navy = arena->make<EU3Army>(*itr, regimentPool);
 		armies.push_back(navy);
 	}
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> sliderObj = obj->GetItem("centralization_decentralization");
-	if (sliderObj.size() > 0)
-	{
-		centralization_decentralization = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		centralization_decentralization = 0;
-	}
-	sliderObj = obj->GetItem("aristocracy_plutocracy");
-	if (sliderObj.size() > 0)
-	{
-		aristocracy_plutocracy = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		aristocracy_plutocracy = 0;
-	}
-	sliderObj = obj->GetItem("serfdom_freesubjects");
-	if (sliderObj.size() > 0)
-	{
-		serfdom_freesubjects = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		serfdom_freesubjects = 0;
-	}
-	sliderObj = obj->GetItem("innovative_narrowminded");
-	if (sliderObj.size() > 0)
-	{
-		innovative_narrowminded = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		innovative_narrowminded = 0;
-	}
-	sliderObj = obj->GetItem("mercantilism_freetrade");
-	if (sliderObj.size() > 0)
-	{
-		mercantilism_freetrade = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		mercantilism_freetrade = 0;
-	}
-	sliderObj = obj->GetItem("offensive_defensive");
-	if (sliderObj.size() > 0)
-	{
-		offensive_defensive = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		offensive_defensive = 0;
-	}
-	sliderObj = obj->GetItem("land_naval");
-	if (sliderObj.size() > 0)
-	{
-		land_naval = sliderObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		land_naval = 0;
-	}
-	sliderObj = obj->GetItem("quality_quantity");
-	if (sliderObj.size() > 0)
-	{
-		quality_quantity = sliderObj[0].Get(0).ToInt();
-	}
-	else
+
+static void WriteFlagsSnapshot(SnapshotWriter& snapshot, const std::map<std::string, bool>& flags)
+{
+	snapshot.writeInt(flags.size());
+	for (std::map<std::string, bool>::const_iterator itr = flags.begin(); itr != flags.end(); ++itr)
 	{
-		quality_quantity = 0;
+		snapshot.writeString(itr->first);
+		snapshot.writeBool(itr->second);
 	}
+}
 
-	nationalIdeas.clear();
-	checkIdea(obj, "press_gangs");
-	checkIdea(obj, "grand_navy");
-	checkIdea(obj, "sea_hawks");
-	checkIdea(obj, "superior_seamanship");
-	checkIdea(obj, "naval_glory");
-	checkIdea(obj, "excellent_shipwrights");
-	checkIdea(obj, "naval_fighting_instruction");
-	checkIdea(obj, "naval_provisioning");
-	checkIdea(obj, "grand_army");
-	checkIdea(obj, "military_drill");
-	checkIdea(obj, "engineer_corps");
-	checkIdea(obj, "battlefield_commisions");
-	checkIdea(obj, "glorious_arms");
-	checkIdea(obj, "national_conscripts");
-	checkIdea(obj, "regimental_system");
-	checkIdea(obj, "napoleonic_warfare");
-	checkIdea(obj, "land_of_opportunity");
-	checkIdea(obj, "merchant_adventures");
-	checkIdea(obj, "colonial_ventures");
-	checkIdea(obj, "shrewd_commerce_practise");
-	checkIdea(obj, "vice_roys");
-	checkIdea(obj, "quest_for_the_new_world");
-	checkIdea(obj, "scientific_revolution");
-	checkIdea(obj, "improved_foraging");
-	checkIdea(obj, "vetting");
-	checkIdea(obj, "bureaucracy");
-	checkIdea(obj, "national_bank");
-	checkIdea(obj, "national_trade_policy");
-	checkIdea(obj, "espionage");
-	checkIdea(obj, "bill_of_rights");
-	checkIdea(obj, "smithian_economics");
-	checkIdea(obj, "liberty_egalite_fraternity");
-	checkIdea(obj, "ecumenism");
-	checkIdea(obj, "church_attendance_duty");
-	checkIdea(obj, "divine_supremacy");
-	checkIdea(obj, "patron_of_art");
-	checkIdea(obj, "deus_vult");
-	checkIdea(obj, "humanist_tolerance");
-	checkIdea(obj, "cabinet");
-	checkIdea(obj, "revolution_and_counter");
-
-	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> moneyObj = obj->GetItem("treasury");
-		if (moneyObj.size() > 0)
-		{
-			treasury = moneyObj[0].Get(0).ToFloat();
-		}
-		else
-		{
-			treasury = 0.0;
-		}
 
-		moneyObj = obj->GetItem("last_bankrupt");
-		if (moneyObj.size() > 0)
-		{
-			last_bankrupt = date(moneyObj[0].Get(0).ToString());
-		}
-		else
-		{
-			last_bankrupt = date();
-		}
-	}
-	{
-		loans.clear();
-		std::vector<wiz::load_data::UserType*> moneyObj = obj->GetUserTypeItem("loan");
-		for (std::vector<wiz::load_data::UserType*>::iterator itr = moneyObj.begin(); itr != moneyObj.end(); ++itr)
-		{
-			EU3Loan* loan = new EU3Loan(*itr);
-			loans.push_back(loan);
-		}
-	}
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> diploObj = obj->GetItem("diplomats");
-	if (diploObj.size() > 0)
-	{
-		diplomats = diploObj[0].Get(0).ToInt();
-	}
-	else
+static std::map<std::string, bool> ReadFlagsSnapshot(SnapshotReader& snapshot)
+{
+	std::map<std::string, bool> flags;
+	size_t numFlags = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numFlags); ++i)
 	{
-		diplomats = 0;
+		std::string flag = snapshot.readString();
+		flags.insert(std::make_pair(flag, snapshot.readBool()));
 	}
+	return flags;
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> badboyObj = obj->GetItem("badboy");
-	if (badboyObj.size() > 0)
-	{
-		badboy = badboyObj[0].Get(0).ToFloat();
-	}
-	else
-	{
-		badboy = 0.0;
-	}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> legitObj = obj->GetItem("legitimacy");
-	if (legitObj.size() > 0)
-	{
-		legitimacy = legitObj[0].Get(0).ToFloat();
-	}
-	else
+static void WriteLocalisationSnapshot(SnapshotWriter& snapshot, const std::map<int, std::string>& byLanguage)
+{
+	snapshot.writeInt(byLanguage.size());
+	for (std::map<int, std::string>::const_iterator itr = byLanguage.begin(); itr != byLanguage.end(); ++itr)
 	{
-		legitimacy = 1.0;
+		snapshot.writeInt(itr->first);
+		snapshot.writeString(itr->second);
 	}
+}
+
+
+static std::map<int, std::string> ReadLocalisationSnapshot(SnapshotReader& snapshot)
+{
+	std::map<int, std::string> byLanguage;
+	size_t numLanguages = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numLanguages); ++i)
 	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> moneyObj = obj->GetItem("inflation");
-		if (moneyObj.size() > 0)
-		{
-			inflation = moneyObj[0].Get(0).ToFloat();
-		}
-		else
-		{
-			inflation = 0.0;
-		}
+		int language = static_cast<int>(snapshot.readInt());
+		byLanguage.insert(std::make_pair(language, snapshot.readString()));
 	}
+	return byLanguage;
+}
+
+
+EU3Country::EU3Country(SnapshotReader& snapshot, Arena& _arena, ObjectPool<EU3Regiment>& regimentPool)
+{
+	arena					= &_arena;
+	tag					= snapshot.readTag();
+	capital				= static_cast<int>(snapshot.readInt());
+	nationalFocus		= static_cast<int>(snapshot.readInt());
+	techGroup			= snapshot.readString();
+	primaryCulture		= snapshot.readString();
+	size_t numAcceptedCultures = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numAcceptedCultures); ++i)
+	{
+		acceptedCultures.push_back(snapshot.readString());
+	}
+	religion				= snapshot.readString();
+	prestige				= snapshot.readDouble();
+	culture				= snapshot.readDouble();
+	armyTradition		= snapshot.readDouble();
+	navyTradition		= snapshot.readDouble();
+	stability			= snapshot.readDouble();
+	landTech				= snapshot.readDouble();
+	navalTech			= snapshot.readDouble();
+	tradeTech			= snapshot.readDouble();
+	productionTech		= snapshot.readDouble();
+	governmentTech		= snapshot.readDouble();
+	estMonthlyIncome	= snapshot.readDouble();
+	armyInvestment		= snapshot.readDouble();
+	navyInvestment		= snapshot.readDouble();
+	commerceInvestment	= snapshot.readDouble();
+	industryInvestment	= snapshot.readDouble();
+	cultureInvestment	= snapshot.readDouble();
+	flags					= ReadFlagsSnapshot(snapshot);
+	modifiers			= ReadFlagsSnapshot(snapshot);
+	possibleDaimyo		= snapshot.readBool();
+	size_t numLeaders = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numLeaders); ++i)
+	{
+		leaders.push_back(arena->make<EU3Leader>(snapshot));
+	}
+	government			= snapshot.readString();
+	size_t numRelations = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numRelations); ++i)
+	{
+		relations.push_back(arena->make<EU3Relations>(snapshot));
+	}
+	size_t numArmies = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numArmies); ++i)
+	{
+		armies.push_back(arena->make<EU3Army>(snapshot, regimentPool));
+	}
+	centralization_decentralization	= static_cast<int>(snapshot.readInt());
+	aristocracy_plutocracy				= static_cast<int>(snapshot.readInt());
+	serfdom_freesubjects					= static_cast<int>(snapshot.readInt());
+	innovative_narrowminded				= static_cast<int>(snapshot.readInt());
+	mercantilism_freetrade				= static_cast<int>(snapshot.readInt());
+	offensive_defensive					= static_cast<int>(snapshot.readInt());
+	land_naval								= static_cast<int>(snapshot.readInt());
+	quality_quantity						= static_cast<int>(snapshot.readInt());
+	size_t numIdeas = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numIdeas); ++i)
+	{
+		nationalIdeas.insert(snapshot.readString());
+	}
+	treasury				= snapshot.readDouble();
+	last_bankrupt		= snapshot.readDate();
+	size_t numLoans = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numLoans); ++i)
+	{
+		loans.push_back(arena->make<EU3Loan>(snapshot));
+	}
+	diplomats			= snapshot.readDouble();
+	badboy				= snapshot.readDouble();
+	legitimacy			= snapshot.readDouble();
+	inflation			= snapshot.readDouble();
+
+	name					= snapshot.readString();
+	adjective			= snapshot.readString();
+	if (snapshot.readBool())
+	{
+		int r	= static_cast<int>(snapshot.readInt());
+		int g	= static_cast<int>(snapshot.readInt());
+		int b	= static_cast<int>(snapshot.readInt());
+		color	= Color(r, g, b);
+	}
+	namesByLanguage		= ReadLocalisationSnapshot(snapshot);
+	adjectivesByLanguage	= ReadLocalisationSnapshot(snapshot);
+}
+
+
+void EU3Country::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(tag);
+	snapshot.writeInt(capital);
+	snapshot.writeInt(nationalFocus);
+	snapshot.writeString(techGroup);
+	snapshot.writeString(primaryCulture);
+	snapshot.writeInt(acceptedCultures.size());
+	for (std::vector<Symbol>::const_iterator itr = acceptedCultures.begin(); itr != acceptedCultures.end(); ++itr)
+	{
+		snapshot.writeString(*itr);
+	}
+	snapshot.writeString(religion);
+	snapshot.writeDouble(prestige);
+	snapshot.writeDouble(culture);
+	snapshot.writeDouble(armyTradition);
+	snapshot.writeDouble(navyTradition);
+	snapshot.writeDouble(stability);
+	snapshot.writeDouble(landTech);
+	snapshot.writeDouble(navalTech);
+	snapshot.writeDouble(tradeTech);
+	snapshot.writeDouble(productionTech);
+	snapshot.writeDouble(governmentTech);
+	snapshot.writeDouble(estMonthlyIncome);
+	snapshot.writeDouble(armyInvestment);
+	snapshot.writeDouble(navyInvestment);
+	snapshot.writeDouble(commerceInvestment);
+	snapshot.writeDouble(industryInvestment);
+	snapshot.writeDouble(cultureInvestment);
+	WriteFlagsSnapshot(snapshot, flags);
+	WriteFlagsSnapshot(snapshot, modifiers);
+	snapshot.writeBool(possibleDaimyo);
+	snapshot.writeInt(leaders.size());
+	for (std::vector<EU3Leader*>::const_iterator itr = leaders.begin(); itr != leaders.end(); ++itr)
+	{
+		(*itr)->writeSnapshot(snapshot);
+	}
+	snapshot.writeString(government);
+	snapshot.writeInt(relations.size());
+	for (std::vector<EU3Relations*>::const_iterator itr = relations.begin(); itr != relations.end(); ++itr)
+	{
+		(*itr)->writeSnapshot(snapshot);
+	}
+	snapshot.writeInt(armies.size());
+	for (std::vector<EU3Army*>::const_iterator itr = armies.begin(); itr != armies.end(); ++itr)
+	{
+		(*itr)->writeSnapshot(snapshot);
+	}
+	snapshot.writeInt(centralization_decentralization);
+	snapshot.writeInt(aristocracy_plutocracy);
+	snapshot.writeInt(serfdom_freesubjects);
+	snapshot.writeInt(innovative_narrowminded);
+	snapshot.writeInt(mercantilism_freetrade);
+	snapshot.writeInt(offensive_defensive);
+	snapshot.writeInt(land_naval);
+	snapshot.writeInt(quality_quantity);
+	snapshot.writeInt(nationalIdeas.size());
+	for (std::set<std::string>::const_iterator itr = nationalIdeas.begin(); itr != nationalIdeas.end(); ++itr)
+	{
+		snapshot.writeString(*itr);
+	}
+	snapshot.writeDouble(treasury);
+	snapshot.writeDate(last_bankrupt);
+	snapshot.writeInt(loans.size());
+	for (std::vector<EU3Loan*>::const_iterator itr = loans.begin(); itr != loans.end(); ++itr)
+	{
+		(*itr)->writeSnapshot(snapshot);
+	}
+	snapshot.writeDouble(diplomats);
+	snapshot.writeDouble(badboy);
+	snapshot.writeDouble(legitimacy);
+	snapshot.writeDouble(inflation);
+
+	snapshot.writeString(name);
+	snapshot.writeString(adjective);
+	snapshot.writeBool(color);
+	if (color)
+	{
+		int r, g, b;
+		color.GetRGB(r, g, b);
+		snapshot.writeInt(r);
+		snapshot.writeInt(g);
+		snapshot.writeInt(b);
+	}
+	WriteLocalisationSnapshot(snapshot, namesByLanguage);
+	WriteLocalisationSnapshot(snapshot, adjectivesByLanguage);
 }
 
 
@@ -605,13 +573,13 @@ int EU3Country::getManufactoryCount() const
 	int retval = 0;
 	for (std::vector<EU3Province*>::const_iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
 	{
-		if ((*itr)->hasBuilding("weapons"))
+		if ((*itr)->hasBuilding(BUILDING_weapons))
 			++retval;
-		if ((*itr)->hasBuilding("wharf"))
+		if ((*itr)->hasBuilding(BUILDING_wharf))
 			++retval;
-		if ((*itr)->hasBuilding("textile"))
+		if ((*itr)->hasBuilding(BUILDING_textile))
 			++retval;
-		if ((*itr)->hasBuilding("refinery"))
+		if ((*itr)->hasBuilding(BUILDING_refinery))
 			++retval;
 	}
 	return retval;
@@ -761,13 +729,20 @@ std::string EU3Country::getAdjective(const unsigned int language) const
 }
 
 
-void EU3Country::checkIdea(const wiz::load_data::UserType* countryObj, const std::string idea)
+void EU3Country::checkIdea(const wiz::load_data::ItemType<wiz::DataType>& ideaObj)
+{
+	if (ideaObj.Get(0).ToString() == "yes")
+	{
+		nationalIdeas.insert(ideaObj.GetName().ToString());
+	}
+}
+
+
+void EU3Country::readFlags(wiz::load_data::UserType* flagObject)
 {
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> niObj;
-	niObj = countryObj->GetItem(idea);
-	if ((niObj.size() > 0) && (niObj[0].Get(0).ToString() == "yes"))
+	for (int i = 0; i < flagObject->GetUserTypeListSize(); i++)
 	{
-		nationalIdeas.insert(idea);
+		flags[flagObject->GetUserTypeList(i)->GetName().ToString()] = true;
 	}
 }
 
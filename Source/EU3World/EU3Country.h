@@ -29,19 +29,26 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <set>
 #include "EU3Army.h"
 #include "../Color.h"
+#include "../CountryTag.h"
 #include "../Date.h"
+#include "../Symbol.h"
 
 class EU3Province;
 class EU3Relations;
 class EU3Loan;
 class EU3Leader;
+class SnapshotReader;
+class SnapshotWriter;
 
 #include "wiz/load_data_types.h"
 
 class EU3Country
 {
 	public:
-		EU3Country(const wiz::load_data::UserType* obj);
+		// the country's leaders, relations, armies and loans are made in the world's arena and pool
+		EU3Country(const wiz::load_data::UserType* obj, Arena& _arena, ObjectPool<EU3Regiment>& regimentPool);
+		EU3Country(SnapshotReader& snapshot, Arena& _arena, ObjectPool<EU3Regiment>& regimentPool);		// the provinces and cores are left for EU3World to add
+		void writeSnapshot(SnapshotWriter& snapshot) const;
 
 		// Add any additional information available from the specified country file.
 		void readFromCommonCountry(const std::string& fileName, wiz::load_data::UserType*);
@@ -60,15 +67,15 @@ class EU3Country
 		double						getBadboyLimit() const;
 		void							eatCountry(EU3Country* target);
 
-		std::string						getTag()										const noexcept { return tag; };
-		std::vector<EU3Province*>		getProvinces()								const noexcept { return provinces; };
-		std::vector<EU3Province*>		getCores()									const noexcept { return cores; };
+		CountryTag						getTag()										const noexcept { return tag; };
+		const std::vector<EU3Province*>&	getProvinces()							const noexcept { return provinces; };
+		const std::vector<EU3Province*>&	getCores()								const noexcept { return cores; };
 		int							getCapital()								const noexcept { return capital; };
 		int							getNationalFocus()						const noexcept { return nationalFocus; };
 		std::string						getTechGroup()								const noexcept { return techGroup; };
-		std::string						getPrimaryCulture()						const noexcept { return primaryCulture; };
-		std::vector<std::string>				getAcceptedCultures()					const noexcept { return acceptedCultures; };
-		std::string						getReligion()								const noexcept { return religion; };
+		Symbol						getPrimaryCulture()						const noexcept { return primaryCulture; };
+		const std::vector<Symbol>&		getAcceptedCultures()					const noexcept { return acceptedCultures; };
+		Symbol						getReligion()								const noexcept { return religion; };
 		double						getPrestige()								const noexcept { return prestige; };
 		double						getCulture()								const noexcept { return culture; };
 		double						getArmyTradition()						const noexcept { return armyTradition; };
@@ -87,8 +94,8 @@ class EU3Country
 		double						getCultureInvestment()					const noexcept { return cultureInvestment; };
 		bool							getPossibleDaimyo()						const noexcept { return possibleDaimyo; };
 		std::string						getGovernment()							const noexcept { return government; };
-		std::vector<EU3Relations*>	getRelations()								const noexcept { return relations; };
-		std::vector<EU3Army*>			getArmies()									const noexcept { return armies; };
+		const std::vector<EU3Relations*>&	getRelations()						const noexcept { return relations; };
+		const std::vector<EU3Army*>&	getArmies()									const noexcept { return armies; };
 		int							getCentralizationDecentralization()	const noexcept { return centralization_decentralization; };
 		int							getAristocracyPlutocracy()				const noexcept { return aristocracy_plutocracy; };
 		int							getSerfdomFreesubjects()				const noexcept { return serfdom_freesubjects; };
@@ -98,10 +105,10 @@ class EU3Country
 		int							getLandNaval()								const noexcept { return land_naval; };
 		int							getQualityQuantity()						const noexcept { return quality_quantity; };
 		date							getLastBankrupt()							const noexcept { return last_bankrupt; };
-		std::vector<EU3Loan*>			getLoans()									const noexcept { return loans; };
+		const std::vector<EU3Loan*>&	getLoans()									const noexcept { return loans; };
 		double						getDiplomats()								const noexcept { return diplomats; };
 		double						getBadboy()									const noexcept { return badboy; };
-		std::vector<EU3Leader*>		getLeaders()								const noexcept { return leaders; };
+		const std::vector<EU3Leader*>&	getLeaders()							const noexcept { return leaders; };
 
 		double						getTreasury()								const noexcept { return inflationAdjust(treasury); };
 
@@ -111,19 +118,21 @@ class EU3Country
 		Color		getColor() const noexcept { return color; }
 
 	private:
-		void						checkIdea(const wiz::load_data::UserType*, const std::string);
+		void						checkIdea(const wiz::load_data::ItemType<wiz::DataType>& ideaObj);
+		void						readFlags(wiz::load_data::UserType* flagObject);
 		void						clearProvinces();
 		void						clearCores();
 
-		std::string					tag;
+		Arena*						arena;
+		CountryTag					tag;
 		std::vector<EU3Province*>	provinces;
 		std::vector<EU3Province*>	cores;
 		int							capital;
 		int							nationalFocus;
 		std::string					techGroup;
-		std::string					primaryCulture;
-		std::vector<std::string>	acceptedCultures;
-		std::string					religion;
+		Symbol						primaryCulture;
+		std::vector<Symbol>			acceptedCultures;
+		Symbol						religion;
 		double						prestige;
 		double						culture;
 		double						armyTradition;
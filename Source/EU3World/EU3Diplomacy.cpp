@@ -24,38 +24,59 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "EU3Diplomacy.h"
 #include "../Log.h"
+#include "../FieldTable.h"
+#include "../Snapshot.h"
 
 
 
 EU3Agreement::EU3Agreement(const wiz::load_data::UserType *obj)
 {
+	static const FieldTable<EU3Agreement> fields = FieldTable<EU3Agreement>()
+		.collect("first")
+		.collect("second")
+		.field("start_date", &EU3Agreement::startDate);
+
 	type = obj->GetName().ToString();
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objFirst = obj->GetItem("first");
-	if (objFirst.size() > 0)
+	fieldMatches found = fields.apply(obj, *this);
+
+	const wiz::load_data::ItemType<wiz::DataType>* objFirst = found.getItem("first");
+	if (objFirst != nullptr)
 	{
-		country1 = objFirst[0].Get(0).ToString();
+		country1 = objFirst->Get(0).ToString();
 	}
 	else
 	{
 		LOG(LogLevel::Warning) << "Diplomatic agreement (" << type << ") has no first party";
 	}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objSecond = obj->GetItem("second");
-	if (objSecond.size() > 0)
+	const wiz::load_data::ItemType<wiz::DataType>* objSecond = found.getItem("second");
+	if (objSecond != nullptr)
 	{
-		country2 = objSecond[0].Get(0).ToString();
+		country2 = objSecond->Get(0).ToString();
 	}
 	else
 	{
 		LOG(LogLevel::Warning) << "Diplomatic agreement (" << type << ") has no second party";
 	}
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> objDate = obj->GetItem("start_date");
-	if (objDate.size() > 0)
-	{
-		startDate = date(objDate[0].Get(0).ToString());
-	}
+
+EU3Agreement::EU3Agreement(SnapshotReader& snapshot)
+{
+	type			= snapshot.readString();
+	country1		= snapshot.readTag();
+	country2		= snapshot.readTag();
+	startDate	= snapshot.readDate();
+}
+
+
+void EU3Agreement::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(type);
+	snapshot.writeString(country1);
+	snapshot.writeString(country2);
+	snapshot.writeDate(startDate);
 }
 
 
@@ -67,45 +88,46 @@ EU3Diplomacy::EU3Diplomacy()
 
 EU3Diplomacy::EU3Diplomacy(const wiz::load_data::UserType* obj)
 {
-	std::vector<wiz::load_data::UserType*> objRMs = obj->GetUserTypeItem("royal_marriage");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objRMs.begin(); itr != objRMs.end(); ++itr)
+	// agreements are grouped by type, in this order
+	static const char* const agreementTypes[] = { "royal_marriage", "guarantee", "vassal", "sphere", "alliance", "union" };
+	static const FieldTable<EU3Diplomacy> fields = []()
 	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
-	}
-
-	std::vector<wiz::load_data::UserType*> objGaurantees = obj->GetUserTypeItem("guarantee");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objGaurantees.begin(); itr != objGaurantees.end(); ++itr)
+		FieldTable<EU3Diplomacy> table;
+		for (size_t i = 0; i < sizeof(agreementTypes) / sizeof(agreementTypes[0]); ++i)
+		{
+			table.collect(agreementTypes[i]);
+		}
+		return table;
+	}();
+
+	fieldMatches found = fields.apply(obj, *this);
+	for (size_t i = 0; i < sizeof(agreementTypes) / sizeof(agreementTypes[0]); ++i)
 	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
+		const fieldMatches::userTypeList& objAgreements = found.getUserTypes(agreementTypes[i]);
+		for (fieldMatches::userTypeList::const_iterator itr = objAgreements.begin(); itr != objAgreements.end(); ++itr)
+		{
+			EU3Agreement agr(*itr);
+			agreements.push_back(agr);
+		}
 	}
+}
 
-	std::vector<wiz::load_data::UserType*> objVassals = obj->GetUserTypeItem("vassal");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objVassals.begin(); itr != objVassals.end(); ++itr)
-	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
-	}
 
-	std::vector<wiz::load_data::UserType*> objSpheres = obj->GetUserTypeItem("sphere");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objSpheres.begin(); itr != objSpheres.end(); ++itr)
+EU3Diplomacy::EU3Diplomacy(SnapshotReader& snapshot)
+{
+	size_t numAgreements = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numAgreements); ++i)
 	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
+		agreements.push_back(EU3Agreement(snapshot));
 	}
+}
 
-	std::vector<wiz::load_data::UserType*> objAlliances = obj->GetUserTypeItem("alliance");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objAlliances.begin(); itr != objAlliances.end(); ++itr)
-	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
-	}
 
-	std::vector<wiz::load_data::UserType*> objUnions = obj->GetUserTypeItem("union");
-	for (std::vector<wiz::load_data::UserType*>::iterator itr = objUnions.begin(); itr != objUnions.end(); ++itr)
+void EU3Diplomacy::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeInt(agreements.size());
+	for (std::vector<EU3Agreement>::const_iterator itr = agreements.begin(); itr != agreements.end(); ++itr)
 	{
-		EU3Agreement agr(*itr);
-		agreements.push_back(agr);
+		itr->writeSnapshot(snapshot);
 	}
 }
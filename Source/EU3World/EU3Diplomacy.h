@@ -25,20 +25,26 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #define EU3DIPLOMACY_H_
 
 
+#include "../CountryTag.h"
 #include "../Date.h"
 #include <vector>
 
 #include "wiz/load_data_types.h"
 
+class SnapshotReader;
+class SnapshotWriter;
+
 
 
 struct EU3Agreement
 {
 	EU3Agreement(const wiz::load_data::UserType* obj);
+	EU3Agreement(SnapshotReader& snapshot);
+	void	writeSnapshot(SnapshotWriter& snapshot) const;
 
 	std::string	type;
-	std::string	country1;
-	std::string	country2;
+	CountryTag	country1;
+	CountryTag	country2;
 	date		startDate;
 };
 
@@ -48,7 +54,9 @@ class EU3Diplomacy
 	public:
 		EU3Diplomacy();
 		EU3Diplomacy(const wiz::load_data::UserType* obj);
-		std::vector<EU3Agreement>	getAgreements() const noexcept { return agreements; };
+		EU3Diplomacy(SnapshotReader& snapshot);
+		void								writeSnapshot(SnapshotWriter& snapshot) const;
+		const std::vector<EU3Agreement>&	getAgreements() const noexcept { return agreements; };
 	private:
 		std::vector<EU3Agreement>	agreements;
 };
@@ -23,6 +23,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "EU3Leader.h"
 #include "../Log.h"
+#include "../Snapshot.h"
 
 
 EU3Leader::EU3Leader(const wiz::load_data::UserType *obj)
@@ -107,6 +108,32 @@ EU3Leader::EU3Leader(const wiz::load_data::UserType *obj)
 }
 
 
+EU3Leader::EU3Leader(SnapshotReader& snapshot)
+{
+	name				= snapshot.readString();
+	fire				= static_cast<int>(snapshot.readInt());
+	shock				= static_cast<int>(snapshot.readInt());
+	manuever			= static_cast<int>(snapshot.readInt());
+	siege				= static_cast<int>(snapshot.readInt());
+	id					= static_cast<int>(snapshot.readInt());
+	type				= snapshot.readString();
+	activationDate	= snapshot.readDate();
+}
+
+
+void EU3Leader::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(name);
+	snapshot.writeInt(fire);
+	snapshot.writeInt(shock);
+	snapshot.writeInt(manuever);
+	snapshot.writeInt(siege);
+	snapshot.writeInt(id);
+	snapshot.writeString(type);
+	snapshot.writeDate(activationDate);
+}
+
+
 bool EU3Leader::isLand() const noexcept
 {
 	if (type == "general" || type == "conquistador")
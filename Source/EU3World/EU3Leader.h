@@ -28,11 +28,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "wiz/load_data_types.h"
 #include "../date.h"
 
+class SnapshotReader;
+class SnapshotWriter;
+
 
 class EU3Leader
 {
 public:
 	EU3Leader(const wiz::load_data::UserType* obj);
+	EU3Leader(SnapshotReader& snapshot);
+	void	writeSnapshot(SnapshotWriter& snapshot) const;
 	std::string	getName() const noexcept { return name; };
 	int		getFire() const noexcept { return fire; };
 	int		getShock() const noexcept { return shock; };
@@ -22,6 +22,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 // 2018.10.25 SOUTH KOREA (vztpv@naver.com)
 
 #include "EU3Loan.h"
+#include "../Snapshot.h"
 
 #include <vector>
 
@@ -55,4 +56,20 @@ EU3Loan::EU3Loan(const wiz::load_data::UserType* obj)
 	{
 		amount = 0.0;
 	}
+}
+
+
+EU3Loan::EU3Loan(SnapshotReader& snapshot)
+{
+	lender	= snapshot.readString();
+	interest	= snapshot.readDouble();
+	amount	= snapshot.readDouble();
+}
+
+
+void EU3Loan::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(lender);
+	snapshot.writeDouble(interest);
+	snapshot.writeDouble(amount);
 }
\ No newline at end of file
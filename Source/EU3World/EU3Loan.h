@@ -30,11 +30,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <string>
 #include "wiz/load_data_types.h"
 
+class SnapshotReader;
+class SnapshotWriter;
+
 
 class EU3Loan
 {
 	public:
 		EU3Loan(const wiz::load_data::UserType* obj);
+		EU3Loan(SnapshotReader& snapshot);
+		void		writeSnapshot(SnapshotWriter& snapshot) const;
 		std::string	getLender() const noexcept { return lender; };
 		double	getInterest() const noexcept { return interest; };
 		double	getAmount() const noexcept { return amount; };
@@ -28,6 +28,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "EU3Religion.h"
 #include "../Log.h"
 #include "../Configuration.h"
+#include "../FieldTable.h"
+#include "../Snapshot.h"
 #include <algorithm>
 #include <fstream>
 
@@ -35,6 +37,35 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 EU3Province::EU3Province(const wiz::load_data::UserType* obj) 
 {
+	static const FieldTable<EU3Province> fields = []()
+	{
+		FieldTable<EU3Province> table;
+		table.field("base_tax", &EU3Province::baseTax);
+		table.field("owner", &EU3Province::ownerString);
+		table.list("core", &EU3Province::cores);
+		table.collect("citysize");
+		table.collect("native_size");
+		table.userType("history", &EU3Province::readHistory);
+		table.collect("culture");
+		table.collect("religion");
+		table.field("trade_goods", &EU3Province::tradeGoods);
+		table.field("name", &EU3Province::provName);
+		table.field("manpower", &EU3Province::manpower);
+
+		for (int i = 0; i < numSaveBuildings; ++i)
+		{
+			const EU3Building building = static_cast<EU3Building>(i);
+			table.item(EU3BuildingNames[i], [building](EU3Province& province, const wiz::load_data::ItemType<wiz::DataType>& buildingObj)
+			{
+				if (buildingObj.Get(0).ToString() == "yes")
+				{
+					province.buildings.set(building);
+				}
+			});
+		}
+		return table;
+	}();
+
 	provTaxIncome = 0;
 	provProdIncome = 0;
 	provMPWeight = 0;
@@ -44,35 +75,30 @@ EU3Province::EU3Province(const wiz::load_data::UserType* obj)
 
 	num = obj->GetName().ToInt();
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> baseTaxObjs;			// the object holding the base tax
-	baseTaxObjs = obj->GetItem("base_tax");
-	baseTax = (baseTaxObjs.size() > 0) ? baseTaxObjs[0].Get(0).ToFloat() : 0.0f;
-
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> ownerObjs;
-	ownerObjs = obj->GetItem("owner");
-	if (ownerObjs.size() == 0)
-	{
-		ownerString = "";
-	}
-	else
-	{
-		ownerString = ownerObjs[0].Get(0).ToString();
-	}
+	baseTax = 0.0f;
+	ownerString = CountryTag();
 	owner = nullptr;
-
 	cores.clear();
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> coreObjs;
-	coreObjs = obj->GetItem("core");
-	for (unsigned int i = 0; i < coreObjs.size(); i++)
-	{
-		cores.push_back(coreObjs[i].Get(0).ToString());
-	}
+	centerOfTrade = false;
+
+	ownershipHistory.clear();
+	lastPossessedDate.clear();
+	religionHistory.clear();
+	cultureHistory.clear();
+
+	popRatios.clear();
+	buildings.reset();
+	tradeGoods = Symbol();
+	provName = "";
+	manpower = 0.0;
+
+	fieldMatches found = fields.apply(obj, *this);
 
 	colony = true;
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> popObj = obj->GetItem("citysize");
-	if (popObj.size() > 0)
+	const wiz::load_data::ItemType<wiz::DataType>* popObj = found.getItem("citysize");
+	if (popObj != nullptr)
 	{
-		population	= (popObj)[0].Get(0).ToInt();
+		population	= popObj->Get(0).ToInt();
 		if (population >= 1000)
 		{
 			colony = false;
@@ -80,10 +106,10 @@ EU3Province::EU3Province(const wiz::load_data::UserType* obj)
 	}
 	else
 	{
-		popObj		= obj->GetItem("native_size");
-		if (popObj.size() > 0)
+		popObj		= found.getItem("native_size");
+		if (popObj != nullptr)
 		{
-			population = (popObj)[0].Get(0).ToInt();
+			population = popObj->Get(0).ToInt();
 		}
 		else
 		{
@@ -91,210 +117,242 @@ EU3Province::EU3Province(const wiz::load_data::UserType* obj)
 		}
 	}
 
-
-	centerOfTrade = false;
-
-	ownershipHistory.clear();
-	lastPossessedDate.clear();
-	religionHistory.clear();
-	cultureHistory.clear();
-
-	std::vector<wiz::load_data::UserType*> historyObj = obj->GetUserTypeItem("history");
-	if (historyObj.size() > 0)
-	{
-		std::string lastOwner;
-		std::string thisCountry;
-
-		for (int i = 0; i < historyObj[0]->GetItemListSize(); ++i) {
-			if (historyObj[0]->GetItemList(i).GetName().ToString() == "owner")
-			{
-				thisCountry = historyObj[0]->GetItemList(i).Get(0).ToString();
-				lastOwner = thisCountry;
-				ownershipHistory.push_back(std::make_pair(date(), thisCountry));
-				continue;
-			}
-			else if (historyObj[0]->GetItemList(i).GetName().ToString() == "culture")
-			{
-				cultureHistory.push_back(std::make_pair(date(), historyObj[0]->GetItemList(i).Get(0).ToString()));
-				continue;
-			}
-			else if (historyObj[0]->GetItemList(i).GetName().ToString() == "religion")
-			{
-				religionHistory.push_back(std::make_pair(date(), historyObj[0]->GetItemList(i).Get(0).ToString()));
-				continue;
-			}
-		}
-
-		for (int i = 0; i < historyObj[0]->GetUserTypeListSize(); ++i)
-		{
-			wiz::load_data::UserType* historyObjs = historyObj[0]->GetUserTypeList(i);
-			std::vector<wiz::load_data::ItemType<wiz::DataType>> ownerObj = historyObjs->GetItem("owner");
-			if (ownerObj.size() > 0)
-			{
-				date newDate(historyObjs->GetName().ToString());
-				thisCountry = ownerObj[0].Get(0).ToString();
-
-				std::map<std::string, date>::iterator itr = lastPossessedDate.find(lastOwner);
-				if (itr != lastPossessedDate.end())
-					itr->second = newDate;
-				else
-					lastPossessedDate.insert(std::make_pair(lastOwner, newDate));
-				lastOwner = thisCountry;
-
-				ownershipHistory.push_back(std::make_pair(newDate, thisCountry));
-			}
-			std::vector<wiz::load_data::ItemType<wiz::DataType>> culObj = historyObjs->GetItem("culture");
-			if (culObj.size() > 0)
-			{
-				date newDate(historyObjs->GetName().ToString());
-				cultureHistory.push_back(std::make_pair(newDate, culObj[0].Get(0).ToString()));
-			}
-			std::vector<wiz::load_data::ItemType<wiz::DataType>> religObj = historyObjs->GetItem("religion");
-			if (religObj.size() > 0)
-			{
-				date newDate(historyObjs->GetName().ToString());
-				religionHistory.push_back(std::make_pair(newDate, religObj[0].Get(0).ToString()));
-			}
-		}
-	}
 	sort(ownershipHistory.begin(), ownershipHistory.end());
 	sort(cultureHistory.begin(), cultureHistory.end());
 	sort(religionHistory.begin(), religionHistory.end());
 
-	if (num == 1)
-	{
-		Configuration::setFirstEU3Date(ownershipHistory[0].first);
-	}
-
 	if (cultureHistory.size() == 0)
 	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> culObj = obj->GetItem("culture");
-		if (culObj.size() > 0)
+		const wiz::load_data::ItemType<wiz::DataType>* culObj = found.getItem("culture");
+		if (culObj != nullptr)
 		{
 			date newDate;
-			cultureHistory.push_back(std::make_pair(newDate, culObj[0].Get(0).ToString()));
+			cultureHistory.push_back(std::make_pair(newDate, culObj->Get(0).ToString()));
 		}
 	}
 	if (religionHistory.size() == 0)
 	{
-		std::vector<wiz::load_data::ItemType<wiz::DataType>> religObj = obj->GetItem("religion");
-		if (religObj.size() > 0)
+		const wiz::load_data::ItemType<wiz::DataType>* religObj = found.getItem("religion");
+		if (religObj != nullptr)
 		{
 			date newDate;
-			religionHistory.push_back(std::make_pair(newDate, religObj[0].Get(0).ToString()));
+			religionHistory.push_back(std::make_pair(newDate, religObj->Get(0).ToString()));
 		}
 	}
 
-	popRatios.clear();
-	buildings.clear();
+	buildPopRatios();
+}
+
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> tradegoodsObj = obj->GetItem("trade_goods");
-	if (tradegoodsObj.size() > 0) 
+template<class T>
+static void WriteHistorySnapshot(SnapshotWriter& snapshot, const std::vector< std::pair<date, T> >& history)
+{
+	snapshot.writeInt(history.size());
+	for (typename std::vector< std::pair<date, T> >::const_iterator itr = history.begin(); itr != history.end(); ++itr)
 	{
-		tradeGoods = tradegoodsObj[0].Get(0).ToString();
+		snapshot.writeDate(itr->first);
+		snapshot.writeString(itr->second);
 	}
-	else
+}
+
+
+template<class T>
+static T ReadHistoryValue(SnapshotReader& snapshot)
+{
+	return T(snapshot.readString());
+}
+
+
+template<>
+CountryTag ReadHistoryValue<CountryTag>(SnapshotReader& snapshot)
+{
+	return snapshot.readTag();
+}
+
+
+template<class T>
+static std::vector< std::pair<date, T> > ReadHistorySnapshot(SnapshotReader& snapshot)
+{
+	std::vector< std::pair<date, T> > history;
+	size_t numEntries = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numEntries); ++i)
 	{
-		tradeGoods = "";
+		date when = snapshot.readDate();
+		history.push_back(std::make_pair(when, ReadHistoryValue<T>(snapshot)));
 	}
+	return history;
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> provNameObj = obj->GetItem("name");
-	if (provNameObj.size() > 0)
-	{
-		provName = provNameObj[0].Get(0).ToString();
+
+EU3Province::EU3Province(SnapshotReader& snapshot)
+{
+	num					= static_cast<int>(snapshot.readInt());
+	baseTax				= snapshot.readDouble();
+	totalWeight			= snapshot.readDouble();
+	ownerString			= snapshot.readTag();
+	provName				= snapshot.readString();
+	owner					= nullptr;
+	size_t numCores = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numCores); ++i)
+	{
+		cores.push_back(snapshot.readTag());
+	}
+	population			= static_cast<int>(snapshot.readInt());
+	colony				= snapshot.readBool();
+	centerOfTrade		= snapshot.readBool();
+	ownershipHistory	= ReadHistorySnapshot<CountryTag>(snapshot);
+	size_t numPossessed = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numPossessed); ++i)
+	{
+		CountryTag tag = snapshot.readTag();
+		lastPossessedDate.insert(std::make_pair(tag, snapshot.readDate()));
+	}
+	religionHistory	= ReadHistorySnapshot<Symbol>(snapshot);
+	cultureHistory		= ReadHistorySnapshot<Symbol>(snapshot);
+	size_t numPopRatios = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numPopRatios); ++i)
+	{
+		EU3PopRatio popRatio;
+		popRatio.culture	= snapshot.readString();
+		popRatio.religion	= snapshot.readString();
+		popRatio.popRatio	= snapshot.readDouble();
+		popRatios.push_back(popRatio);
+	}
+	buildings				= EU3BuildingSet(static_cast<unsigned long long>(snapshot.readInt()));
+	manpower				= snapshot.readDouble();
+	tradeGoods			= snapshot.readString();
+	numV2Provs			= static_cast<int>(snapshot.readInt());
+
+	provTaxIncome			= snapshot.readDouble();
+	provProdIncome			= snapshot.readDouble();
+	provMPWeight			= snapshot.readDouble();
+	provBuildingWeight	= snapshot.readDouble();
+	provTradeGoodWeight	= snapshot.readDouble();
+	size_t numProductionValues = snapshot.readCount(sizeof(double));
+	for (size_t i = 0; snapshot.good() && (i < numProductionValues); ++i)
+	{
+		provProductionVec.push_back(snapshot.readDouble());
 	}
-	else
-	{
-		provName = "";
+}
+
+
+void EU3Province::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeInt(num);
+	snapshot.writeDouble(baseTax);
+	snapshot.writeDouble(totalWeight);
+	snapshot.writeString(ownerString);
+	snapshot.writeString(provName);
+	snapshot.writeInt(cores.size());
+	for (std::vector<CountryTag>::const_iterator itr = cores.begin(); itr != cores.end(); ++itr)
+	{
+		snapshot.writeString(*itr);
+	}
+	snapshot.writeInt(population);
+	snapshot.writeBool(colony);
+	snapshot.writeBool(centerOfTrade);
+	WriteHistorySnapshot(snapshot, ownershipHistory);
+	snapshot.writeInt(lastPossessedDate.size());
+	for (std::map<CountryTag, date>::const_iterator itr = lastPossessedDate.begin(); itr != lastPossessedDate.end(); ++itr)
+	{
+		snapshot.writeString(itr->first);
+		snapshot.writeDate(itr->second);
+	}
+	WriteHistorySnapshot(snapshot, religionHistory);
+	WriteHistorySnapshot(snapshot, cultureHistory);
+	snapshot.writeInt(popRatios.size());
+	for (std::vector<EU3PopRatio>::const_iterator itr = popRatios.begin(); itr != popRatios.end(); ++itr)
+	{
+		snapshot.writeString(itr->culture);
+		snapshot.writeString(itr->religion);
+		snapshot.writeDouble(itr->popRatio);
+	}
+	snapshot.writeInt(static_cast<long long>(buildings.to_ullong()));
+	snapshot.writeDouble(manpower);
+	snapshot.writeString(tradeGoods);
+	snapshot.writeInt(numV2Provs);
+
+	snapshot.writeDouble(provTaxIncome);
+	snapshot.writeDouble(provProdIncome);
+	snapshot.writeDouble(provMPWeight);
+	snapshot.writeDouble(provBuildingWeight);
+	snapshot.writeDouble(provTradeGoodWeight);
+	snapshot.writeInt(provProductionVec.size());
+	for (std::vector<double>::const_iterator itr = provProductionVec.begin(); itr != provProductionVec.end(); ++itr)
+	{
+		snapshot.writeDouble(*itr);
 	}
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> manpowerObj = obj->GetItem("manpower");
-	if (manpowerObj.size() > 0)
-	{
-		manpower = manpowerObj[0].Get(0).ToFloat();
+
+void EU3Province::readHistory(wiz::load_data::UserType* historyObj)
+{
+	CountryTag lastOwner;
+	CountryTag thisCountry;
+
+	for (int i = 0; i < historyObj->GetItemListSize(); ++i) {
+		if (historyObj->GetItemList(i).GetName().ToString() == "owner")
+		{
+			thisCountry = historyObj->GetItemList(i).Get(0).ToString();
+			lastOwner = thisCountry;
+			ownershipHistory.push_back(std::make_pair(date(), thisCountry));
+			continue;
+		}
+		else if (historyObj->GetItemList(i).GetName().ToString() == "culture")
+		{
+			cultureHistory.push_back(std::make_pair(date(), historyObj->GetItemList(i).Get(0).ToString()));
+			continue;
+		}
+		else if (historyObj->GetItemList(i).GetName().ToString() == "religion")
+		{
+			religionHistory.push_back(std::make_pair(date(), historyObj->GetItemList(i).Get(0).ToString()));
+			continue;
+		}
 	}
-	else
+
+	for (int i = 0; i < historyObj->GetUserTypeListSize(); ++i)
 	{
-		manpower = 0.0;
-	}
+		wiz::load_data::UserType* historyObjs = historyObj->GetUserTypeList(i);
+		std::vector<wiz::load_data::ItemType<wiz::DataType>> ownerObj = historyObjs->GetItem("owner");
+		if (ownerObj.size() > 0)
+		{
+			date newDate(historyObjs->GetName().ToString());
+			thisCountry = ownerObj[0].Get(0).ToString();
 
-	//LOG(LogLevel::Info) << "Check unique Buildings...";
-	// unique buildings
-	checkBuilding(obj, "tax_assessor");
-	checkBuilding(obj, "embassy");
-	checkBuilding(obj, "glorious_monument");
-	checkBuilding(obj, "march");
-	checkBuilding(obj, "grain_depot");
-	checkBuilding(obj, "royal_palace");
-	checkBuilding(obj, "war_college");
-	checkBuilding(obj, "admiralty");
-
-	//LOG(LogLevel::Info) << "Check manus...";
-	// Manufacturies
-	checkBuilding(obj, "weapons");
-	checkBuilding(obj, "university");
-	checkBuilding(obj, "wharf");
-	checkBuilding(obj, "textile");
-	checkBuilding(obj, "fine_arts_academy");
-	checkBuilding(obj, "refinery");
-
-	//LOG(LogLevel::Info) << "Check buildings...";
-	// base buildings 
-	checkBuilding(obj, "fort1");
-	checkBuilding(obj, "fort2");
-	checkBuilding(obj, "fort3");
-	checkBuilding(obj, "fort4");
-	checkBuilding(obj, "fort5");
-	checkBuilding(obj, "fort6");
-
-	checkBuilding(obj, "dock");
-	checkBuilding(obj, "drydock");
-	checkBuilding(obj, "shipyard");
-	checkBuilding(obj, "grand_shipyard");
-	checkBuilding(obj, "naval_arsenal");
-	checkBuilding(obj, "naval_base");
-
-	checkBuilding(obj, "temple");
-	checkBuilding(obj, "courthouse");
-	checkBuilding(obj, "spy_agency");
-	checkBuilding(obj, "town_hall");
-	checkBuilding(obj, "college");
-	checkBuilding(obj, "cathedral");
-
-	checkBuilding(obj, "armory");
-	checkBuilding(obj, "training_fields");
-	checkBuilding(obj, "barracks");
-	checkBuilding(obj, "regimental_camp");
-	checkBuilding(obj, "arsenal");
-	checkBuilding(obj, "conscription_center");
-
-	checkBuilding(obj, "constable");
-	checkBuilding(obj, "workshop");
-	checkBuilding(obj, "counting_house");
-	checkBuilding(obj, "treasury_office");
-	checkBuilding(obj, "mint");
-	checkBuilding(obj, "stock_exchange");
-
-	checkBuilding(obj, "marketplace");
-	checkBuilding(obj, "trade_depot");
-	checkBuilding(obj, "canal");
-	checkBuilding(obj, "road_network");
-	checkBuilding(obj, "post_office");
-	checkBuilding(obj, "customs_house");
+			std::map<CountryTag, date>::iterator itr = lastPossessedDate.find(lastOwner);
+			if (itr != lastPossessedDate.end())
+				itr->second = newDate;
+			else
+				lastPossessedDate.insert(std::make_pair(lastOwner, newDate));
+			lastOwner = thisCountry;
 
-	buildPopRatios();
+			ownershipHistory.push_back(std::make_pair(newDate, thisCountry));
+		}
+		std::vector<wiz::load_data::ItemType<wiz::DataType>> culObj = historyObjs->GetItem("culture");
+		if (culObj.size() > 0)
+		{
+			date newDate(historyObjs->GetName().ToString());
+			cultureHistory.push_back(std::make_pair(newDate, culObj[0].Get(0).ToString()));
+		}
+		std::vector<wiz::load_data::ItemType<wiz::DataType>> religObj = historyObjs->GetItem("religion");
+		if (religObj.size() > 0)
+		{
+			date newDate(historyObjs->GetName().ToString());
+			religionHistory.push_back(std::make_pair(newDate, religObj[0].Get(0).ToString()));
+		}
+	}
 }
 
 
-void EU3Province::addCore(const std::string& tag)
+void EU3Province::addCore(CountryTag tag)
 {
 	cores.push_back(tag);
 }
 
 
-void EU3Province::removeCore(const std::string& tag)
+void EU3Province::removeCore(CountryTag tag)
 {
-	for (std::vector<std::string>::iterator i = cores.begin(); i != cores.end(); i++)
+	for (std::vector<CountryTag>::iterator i = cores.begin(); i != cores.end(); i++)
 	{
 		if (*i == tag)
 		{
@@ -348,17 +406,17 @@ bool EU3Province::wasInfidelConquest() const
 
 bool EU3Province::hasBuilding(const std::string& building) const
 {
-	int num = buildings.count(building);
-	return (num > 0);
+	EU3Building known = findEU3Building(building);
+	return (known != NUM_BUILDINGS) && buildings.test(known);
 }
 
 
-std::vector<EU3Country*> EU3Province::getCores(const std::map<std::string, EU3Country*>& countries) const
+std::vector<EU3Country*> EU3Province::getCores(const std::map<CountryTag, EU3Country*>& countries) const
 {
 	std::vector<EU3Country*> coreOwners;
-	for (std::vector<std::string>::const_iterator i = cores.begin(); i != cores.end(); i++)
+	for (std::vector<CountryTag>::const_iterator i = cores.begin(); i != cores.end(); i++)
 	{
-		std::map<std::string, EU3Country*>::const_iterator j = countries.find(*i);
+		std::map<CountryTag, EU3Country*>::const_iterator j = countries.find(*i);
 		if (j != countries.end())
 		{
 			coreOwners.push_back(j->second);
@@ -369,9 +427,9 @@ std::vector<EU3Country*> EU3Province::getCores(const std::map<std::string, EU3Co
 }
 
 
-date EU3Province::getLastPossessedDate(const std::string& tag) const
+date EU3Province::getLastPossessedDate(CountryTag tag) const
 {
-	std::map<std::string, date>::const_iterator itr = lastPossessedDate.find(tag);
+	std::map<CountryTag, date>::const_iterator itr = lastPossessedDate.find(tag);
 	if (itr != lastPossessedDate.end())
 	{
 		return itr->second;
@@ -380,17 +438,6 @@ date EU3Province::getLastPossessedDate(const std::string& tag) const
 }
 
 
-void EU3Province::checkBuilding(const wiz::load_data::UserType* provinceObj, const std::string& building)
-{
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> buildingObj;
-	buildingObj = provinceObj->GetItem(building);
-	if ((buildingObj.size() > 0) && (buildingObj[0].Get(0).ToString() == "yes"))
-	{
-		buildings[building] = true;
-	}
-}
-
-
 void EU3Province::buildPopRatios()
 {
 	date endDate = Configuration::getLastEU3Date();
@@ -402,16 +449,16 @@ void EU3Province::buildPopRatios()
 	cutoffDate.year	-= 200;
 
 	// fast-forward to 200 years before the end date (200 year decay means any changes before then will be at 100%)
-	std::string curCulture		= "";
-	std::string curReligion	= "";
-	std::vector< std::pair<date, std::string> >::iterator cItr = cultureHistory.begin();
-	std::vector< std::pair<date, std::string> >::iterator rItr = religionHistory.begin();
+	Symbol curCulture;
+	Symbol curReligion;
+	std::vector< std::pair<date, Symbol> >::iterator cItr = cultureHistory.begin();
+	std::vector< std::pair<date, Symbol> >::iterator rItr = religionHistory.begin();
 	while (cItr != cultureHistory.end() && cItr->first.year < cutoffDate.year)
 	{
 		curCulture = cItr->second;
 		++cItr;
 	} 
-	if (cItr != cultureHistory.end() && curCulture == "")
+	if (cItr != cultureHistory.end() && curCulture.empty())
 	{
 		// no starting culture; use first settlement culture for starting pop even if it's after 1620
 		curCulture = cItr->second;
@@ -421,7 +468,7 @@ void EU3Province::buildPopRatios()
 		curReligion = rItr->second;
 		++rItr;
 	}
-	if (rItr != religionHistory.end() && curReligion == "")
+	if (rItr != religionHistory.end() && curReligion.empty())
 	{
 		// no starting religion; use first settlement religion for starting pop even if it's after 1620
 		curReligion = rItr->second;
@@ -454,7 +501,7 @@ void EU3Province::buildPopRatios()
 		if (cDate < rDate)
 		{
 			decayPopRatios(lastLoopDate, cDate, pr);
-			if ((pr.culture != "") || (pr.religion != ""))
+			if (!pr.culture.empty() || !pr.religion.empty())
 			{
 				popRatios.push_back(pr);
 			}
@@ -904,573 +951,573 @@ std::vector<double> EU3Province::getProvBuildingWeight() const
 
 	// unique buildings
 	/*
-	if (hasBuilding("march"))
+	if (hasBuilding(BUILDING_march))
 	{
 		building_weight += 2;
 		manpower_modifier += 75;
 	}
 
-	if (hasBuilding("glorious_monument"))
+	if (hasBuilding(BUILDING_glorious_monument))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("royal_palace"))
+	if (hasBuilding(BUILDING_royal_palace))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("admiralty"))
+	if (hasBuilding(BUILDING_admiralty))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("war_college"))
+	if (hasBuilding(BUILDING_war_college))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("embassy"))
+	if (hasBuilding(BUILDING_embassy))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("tax_assessor"))
+	if (hasBuilding(BUILDING_tax_assessor))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("grain_depot"))
+	if (hasBuilding(BUILDING_grain_depot))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("university"))
+	if (hasBuilding(BUILDING_university))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("fine_arts_academy"))
+	if (hasBuilding(BUILDING_fine_arts_academy))
 	{
 		building_weight += 2;
 	}
 
 	// manfacturies building
-	if (hasBuilding("weapons"))
+	if (hasBuilding(BUILDING_weapons))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("wharf"))
+	if (hasBuilding(BUILDING_wharf))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("textile"))
+	if (hasBuilding(BUILDING_textile))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("refinery"))
+	if (hasBuilding(BUILDING_refinery))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("plantations"))
+	if (hasBuilding(BUILDING_plantations))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("farm_estate"))
+	if (hasBuilding(BUILDING_farm_estate))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("tradecompany"))
+	if (hasBuilding(BUILDING_tradecompany))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
 	// Base buildings
-	if (hasBuilding("fort1"))
+	if (hasBuilding(BUILDING_fort1))
 	{
 		building_weight += 1;
 	}
-	if (hasBuilding("fort2"))
+	if (hasBuilding(BUILDING_fort2))
 	{
 		building_weight += 2;
 	}
-	if (hasBuilding("fort3"))
+	if (hasBuilding(BUILDING_fort3))
 	{
 		building_weight += 3;
 	}
-	if (hasBuilding("fort4"))
+	if (hasBuilding(BUILDING_fort4))
 	{
 		building_weight += 4;
 
 	}
-	if (hasBuilding("fort5"))
+	if (hasBuilding(BUILDING_fort5))
 	{
 		building_weight += 5;
 	}
-	if (hasBuilding("fort6"))
+	if (hasBuilding(BUILDING_fort6))
 	{
 		building_weight += 6;
 	}
-	if (hasBuilding("dock"))
+	if (hasBuilding(BUILDING_dock))
 	{
 		building_weight++;
 	}
 
-	if (hasBuilding("drydock"))
+	if (hasBuilding(BUILDING_drydock))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("shipyard"))
+	if (hasBuilding(BUILDING_shipyard))
 	{
 		building_weight += 3;
 	}
 
-	if (hasBuilding("grand_shipyard"))
+	if (hasBuilding(BUILDING_grand_shipyard))
 	{
 		building_weight += 4;
 	}
 
-	if (hasBuilding("naval_arsenal"))
+	if (hasBuilding(BUILDING_naval_arsenal))
 	{
 		building_weight += 5;
 	}
 
-	if (hasBuilding("naval_base"))
+	if (hasBuilding(BUILDING_naval_base))
 	{
 		building_weight += 6;
 	}
 
-	if (hasBuilding("temple"))
+	if (hasBuilding(BUILDING_temple))
 	{
 		building_weight += 1;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("courthouse"))
+	if (hasBuilding(BUILDING_courthouse))
 	{
 		building_weight += 2;
 		building_tx_eff += 0.10;
 	}
 
-	if (hasBuilding("spy_agency"))
+	if (hasBuilding(BUILDING_spy_agency))
 	{
 		building_weight += 3;
 		building_tx_eff += 0.20;
 	}
 
-	if (hasBuilding("town_hall"))
+	if (hasBuilding(BUILDING_town_hall))
 	{
 		building_weight += 4;
 		building_tx_eff += 0.25;
 	}
 
-	if (hasBuilding("college"))
+	if (hasBuilding(BUILDING_college))
 	{
 		building_weight += 5;
 		building_tx_eff += 0.50;
 	}
 
-	if (hasBuilding("cathedral"))
+	if (hasBuilding(BUILDING_cathedral))
 	{
 		building_weight += 6;
 		building_tx_income += 3.0;
 	}
 
-	if (hasBuilding("armory"))
+	if (hasBuilding(BUILDING_armory))
 	{
 		building_weight += 1;
 		manpower_modifier += 25;
 	}
 
-	if (hasBuilding("training_fields"))
+	if (hasBuilding(BUILDING_training_fields))
 	{
 		building_weight += 2;
 		manpower_modifier += 25;
 	}
 
-	if (hasBuilding("barracks"))
+	if (hasBuilding(BUILDING_barracks))
 	{
 		building_weight += 3;
 		manpower_modifier += 25;
 		manpower_eff += 0.10;
 	}
 
-	if (hasBuilding("regimental_camp"))
+	if (hasBuilding(BUILDING_regimental_camp))
 	{
 		building_weight += 4;
 		manpower_eff += 0.20;
 	}
 
-	if (hasBuilding("arsenal"))
+	if (hasBuilding(BUILDING_arsenal))
 	{
 		building_weight += 5;
 		manpower_modifier += 50;
 	}
 
-	if (hasBuilding("conscription_center"))
+	if (hasBuilding(BUILDING_conscription_center))
 	{
 		building_weight += 6;
 		manpower_modifier += 50;
 		manpower_eff += 0.50;
 	}
-	if (hasBuilding("constable"))
+	if (hasBuilding(BUILDING_constable))
 	{
 		building_weight += 1;
 		production_eff += 0.2;
 	}
 
-	if (hasBuilding("workshop"))
+	if (hasBuilding(BUILDING_workshop))
 	{
 		building_weight += 2;
 		goods_produced_perc_mod += 0.2;
 	}
 
-	if (hasBuilding("counting_house"))
+	if (hasBuilding(BUILDING_counting_house))
 	{
 		building_weight += 3;
 	}
 
-	if (hasBuilding("treasury_office"))
+	if (hasBuilding(BUILDING_treasury_office))
 	{
 		building_weight += 4;
 	}
 
-	if (hasBuilding("mint"))
+	if (hasBuilding(BUILDING_mint))
 	{
 		building_weight += 5;
 		production_eff += 0.5;
 	}
 
-	if (hasBuilding("stock_exchange"))
+	if (hasBuilding(BUILDING_stock_exchange))
 	{
 		building_weight += 6;
 		goods_produced_perc_mod += 0.50;
 	}
-	if (hasBuilding("customs_house"))
+	if (hasBuilding(BUILDING_customs_house))
 	{
 		building_weight += 6;
 		trade_power += 10;
 		trade_value += 2;
 	}
 
-	if (hasBuilding("marketplace"))
+	if (hasBuilding(BUILDING_marketplace))
 	{
 		building_weight++;
 		trade_power += 2;
 	}
 
-	if (hasBuilding("trade_depot"))
+	if (hasBuilding(BUILDING_trade_depot))
 	{
 		building_weight += 2;
 		trade_value += 1;
 		trade_power_eff += 0.25;
 	}
-	if (hasBuilding("canal"))
+	if (hasBuilding(BUILDING_canal))
 	{
 		building_weight += 3;
 		trade_power += 2;
 		trade_value_eff += 0.25;
 	}
-	if (hasBuilding("road_network"))
+	if (hasBuilding(BUILDING_road_network))
 	{
 		building_weight += 4;
 		trade_power_eff += 0.25;
 	}
 
-	if (hasBuilding("post_office"))
+	if (hasBuilding(BUILDING_post_office))
 	{
 		building_weight += 5;
 		trade_power += 3;
 		trade_power_eff += 0.5;
 	}*/
 
-	if (hasBuilding("march"))
+	if (hasBuilding(BUILDING_march))
 	{
 		building_weight += 2;
 		manpower_modifier += 75;
 	}
 
-	if (hasBuilding("glorious_monument"))
+	if (hasBuilding(BUILDING_glorious_monument))
 	{
 		building_weight += 2;
 		building_tx_income += 1;
 		manpower_eff += 0.05;
 	}
 
-	if (hasBuilding("royal_palace"))
+	if (hasBuilding(BUILDING_royal_palace))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("admiralty"))
+	if (hasBuilding(BUILDING_admiralty))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("war_college"))
+	if (hasBuilding(BUILDING_war_college))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("embassy"))
+	if (hasBuilding(BUILDING_embassy))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("tax_assessor"))
+	if (hasBuilding(BUILDING_tax_assessor))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("grain_depot"))
+	if (hasBuilding(BUILDING_grain_depot))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("university"))
+	if (hasBuilding(BUILDING_university))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("fine_arts_academy"))
+	if (hasBuilding(BUILDING_fine_arts_academy))
 	{
 		building_weight += 2;
 	}
 
 	// manfacturies building
-	if (hasBuilding("weapons"))
+	if (hasBuilding(BUILDING_weapons))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("wharf"))
+	if (hasBuilding(BUILDING_wharf))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("textile"))
+	if (hasBuilding(BUILDING_textile))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("refinery"))
+	if (hasBuilding(BUILDING_refinery))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("plantations"))
+	if (hasBuilding(BUILDING_plantations))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("farm_estate"))
+	if (hasBuilding(BUILDING_farm_estate))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
-	if (hasBuilding("tradecompany"))
+	if (hasBuilding(BUILDING_tradecompany))
 	{
 		building_weight += 5;
 		manu_gp_mod = 1.0;
 	}
 
 	// Base buildings
-	if (hasBuilding("fort1"))
+	if (hasBuilding(BUILDING_fort1))
 	{
 		building_weight += 1;
 	}
-	if (hasBuilding("fort2"))
+	if (hasBuilding(BUILDING_fort2))
 	{
 		building_weight += 2;
 	}
-	if (hasBuilding("fort3"))
+	if (hasBuilding(BUILDING_fort3))
 	{
 		building_weight += 3;
 	}
-	if (hasBuilding("fort4"))
+	if (hasBuilding(BUILDING_fort4))
 	{
 		building_weight += 4;
 
 	}
-	if (hasBuilding("fort5"))
+	if (hasBuilding(BUILDING_fort5))
 	{
 		building_weight += 5;
 	}
-	if (hasBuilding("fort6"))
+	if (hasBuilding(BUILDING_fort6))
 	{
 		building_weight += 6;
 	}
-	if (hasBuilding("dock"))
+	if (hasBuilding(BUILDING_dock))
 	{
 		building_weight++;
 	}
 
-	if (hasBuilding("drydock"))
+	if (hasBuilding(BUILDING_drydock))
 	{
 		building_weight += 2;
 	}
 
-	if (hasBuilding("shipyard"))
+	if (hasBuilding(BUILDING_shipyard))
 	{
 		building_weight += 3;
 	}
 
-	if (hasBuilding("grand_shipyard"))
+	if (hasBuilding(BUILDING_grand_shipyard))
 	{
 		building_weight += 4;
 	}
 
-	if (hasBuilding("naval_arsenal"))
+	if (hasBuilding(BUILDING_naval_arsenal))
 	{
 		building_weight += 5;
 	}
 
-	if (hasBuilding("naval_base"))
+	if (hasBuilding(BUILDING_naval_base))
 	{
 		building_weight += 6;
 	}
 
-	if (hasBuilding("temple"))
+	if (hasBuilding(BUILDING_temple))
 	{
 		building_weight += 1;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("courthouse"))
+	if (hasBuilding(BUILDING_courthouse))
 	{
 		building_weight += 2;
 		building_tx_eff += 0.10;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("spy_agency"))
+	if (hasBuilding(BUILDING_spy_agency))
 	{
 		building_weight += 3;
 		building_tx_eff += 0.30;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("town_hall"))
+	if (hasBuilding(BUILDING_town_hall))
 	{
 		building_weight += 4;
 		building_tx_eff += 0.55;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("college"))
+	if (hasBuilding(BUILDING_college))
 	{
 		building_weight += 5;
 		building_tx_eff += 1.05;
 		building_tx_income += 1.0;
 	}
 
-	if (hasBuilding("cathedral"))
+	if (hasBuilding(BUILDING_cathedral))
 	{
 		building_weight += 6;
 		building_tx_eff += 1.05;
 		building_tx_income += 4.0;
 	}
 
-	if (hasBuilding("armory"))
+	if (hasBuilding(BUILDING_armory))
 	{
 		building_weight += 1;
 		manpower_modifier += 25;
 	}
 
-	if (hasBuilding("training_fields"))
+	if (hasBuilding(BUILDING_training_fields))
 	{
 		building_weight += 2;
 		manpower_modifier += 50;
 	}
 
-	if (hasBuilding("barracks"))
+	if (hasBuilding(BUILDING_barracks))
 	{
 		building_weight += 3;
 		manpower_modifier += 75;
 		manpower_eff += 0.10;
 	}
 
-	if (hasBuilding("regimental_camp"))
+	if (hasBuilding(BUILDING_regimental_camp))
 	{
 		building_weight += 4;
 		manpower_eff += 0.30;
 		manpower_modifier += 75;
 	}
 
-	if (hasBuilding("arsenal"))
+	if (hasBuilding(BUILDING_arsenal))
 	{
 		building_weight += 5;
 		manpower_eff += 0.30;
 		manpower_modifier += 125;
 	}
 
-	if (hasBuilding("conscription_center"))
+	if (hasBuilding(BUILDING_conscription_center))
 	{
 		building_weight += 6;
 		manpower_modifier += 175;
 		manpower_eff += 0.80;
 	}
-	if (hasBuilding("constable"))
+	if (hasBuilding(BUILDING_constable))
 	{
 		building_weight += 1;
 		production_eff += 0.2;
 	}
 
-	if (hasBuilding("workshop"))
+	if (hasBuilding(BUILDING_workshop))
 	{
 		building_weight += 2;
 		goods_produced_perc_mod += 0.2;
 		production_eff += 0.2;
 	}
 
-	if (hasBuilding("counting_house"))
+	if (hasBuilding(BUILDING_counting_house))
 	{
 		goods_produced_perc_mod += 0.2;
 		production_eff += 0.2;
 		building_weight += 3;
 	}
 
-	if (hasBuilding("treasury_office"))
+	if (hasBuilding(BUILDING_treasury_office))
 	{
 		building_weight += 4;
 		goods_produced_perc_mod += 0.2;
 		production_eff += 0.2;
 	}
 
-	if (hasBuilding("mint"))
+	if (hasBuilding(BUILDING_mint))
 	{
 		building_weight += 5;
 		goods_produced_perc_mod += 0.2;
 		production_eff += 0.7;
 	}
 
-	if (hasBuilding("stock_exchange"))
+	if (hasBuilding(BUILDING_stock_exchange))
 	{
 		building_weight += 6;
 		production_eff += 0.7;
 		goods_produced_perc_mod += 0.70;
 	}
-	if (hasBuilding("customs_house"))
+	if (hasBuilding(BUILDING_customs_house))
 	{
 		building_weight += 6;
 		trade_value_eff += 0.25;
@@ -1479,20 +1526,20 @@ std::vector<double> EU3Province::getProvBuildingWeight() const
 		trade_power += 17;
 	}
 
-	if (hasBuilding("marketplace"))
+	if (hasBuilding(BUILDING_marketplace))
 	{
 		building_weight++;
 		trade_power += 2;
 	}
 
-	if (hasBuilding("trade_depot"))
+	if (hasBuilding(BUILDING_trade_depot))
 	{
 		building_weight += 2;
 		trade_value += 1;
 		trade_power_eff += 0.25;
 		trade_power += 2;
 	}
-	if (hasBuilding("canal"))
+	if (hasBuilding(BUILDING_canal))
 	{
 		building_weight += 3;
 		trade_value_eff += 0.25;
@@ -1500,7 +1547,7 @@ std::vector<double> EU3Province::getProvBuildingWeight() const
 		trade_power_eff += 0.25;
 		trade_power += 4;
 	}
-	if (hasBuilding("road_network"))
+	if (hasBuilding(BUILDING_road_network))
 	{
 		building_weight += 4;
 		trade_value_eff += 0.25;
@@ -1509,7 +1556,7 @@ std::vector<double> EU3Province::getProvBuildingWeight() const
 		trade_power += 4;
 	}
 
-	if (hasBuilding("post_office"))
+	if (hasBuilding(BUILDING_post_office))
 	{
 		building_weight += 5;
 		trade_value_eff += 0.25;
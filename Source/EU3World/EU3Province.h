@@ -25,7 +25,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #define EU3PROVINCE_H_
 
 
+#include "../CountryTag.h"
 #include "../Date.h"
+#include "../Symbol.h"
+#include "EU3Buildings.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -34,12 +37,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 class Object;
 class EU3Country;
+class SnapshotReader;
+class SnapshotWriter;
 
 
 
 struct EU3PopRatio {
-	std::string culture;
-	std::string religion;
+	Symbol culture;
+	Symbol religion;
 	double popRatio;
 };
 
@@ -47,26 +52,30 @@ struct EU3PopRatio {
 class EU3Province {
 	public:
 		EU3Province(const wiz::load_data::UserType* obj);
+		EU3Province(SnapshotReader& snapshot);					// the owner is left for EU3World to set
+		void						writeSnapshot(SnapshotWriter& snapshot) const;
 
-		void						addCore(const std::string& tag);
-		void						removeCore(const std::string& tag);
+		void						addCore(CountryTag tag);
+		void						removeCore(CountryTag tag);
 		void						determineProvinceWeight();
 
 		bool						wasColonised() const;
 		bool						wasInfidelConquest() const;
-		bool						hasBuilding(const std::string& building) const;
+		bool						hasBuilding(EU3Building building)	const noexcept { return buildings.test(building); }
+		bool						hasBuilding(const std::string& building) const;		// for buildings named in rule files
+		const EU3BuildingSet&	getBuildings()								const noexcept { return buildings; }
 
-		std::vector<EU3Country*>	getCores(const std::map<std::string, EU3Country*>& countries) const;
-		date						getLastPossessedDate(const std::string& tag) const;
+		std::vector<EU3Country*>	getCores(const std::map<CountryTag, EU3Country*>& countries) const;
+		date						getLastPossessedDate(CountryTag tag) const;
 
 		int						getNum()					const noexcept { return num; };
 		double					getBaseTax()			const noexcept { return baseTax; }
-		std::string					getOwnerString()		const noexcept { return ownerString; };
+		CountryTag					getOwnerString()		const noexcept { return ownerString; };
 		EU3Country*				getOwner()				const noexcept { return owner; };
 		int						getPopulation()		const noexcept { return population; };
 		bool						isColony()				const noexcept { return colony; };
 		bool						isCOT()					const noexcept { return centerOfTrade; };
-		std::vector<EU3PopRatio>	getPopRatios()			const noexcept { return popRatios; };
+		const std::vector<EU3PopRatio>&	getPopRatios()	const noexcept { return popRatios; };
 		double					getTotalWeight()		const noexcept { return totalWeight; }
 		int						getNumDestV2Provs()	const noexcept { return numV2Provs; };
 
@@ -84,12 +93,13 @@ class EU3Province {
 		double						getProvMPWeight()					const	noexcept { return provMPWeight; }
 		double						getProvTotalBuildingWeight()	const	noexcept { return provBuildingWeight; }
 		double						getCurrTradeGoodWeight()		const	noexcept { return provTradeGoodWeight; }
-		std::vector<double>		getProvProductionVec()			const	noexcept { return provProductionVec; }
-		std::string						getTradeGoods()					const noexcept { return tradeGoods; }
+		const std::vector<double>&	getProvProductionVec()		const	noexcept { return provProductionVec; }
+		Symbol						getTradeGoods()					const noexcept { return tradeGoods; }
+		date							getFirstOwnershipDate()			const noexcept { return ownershipHistory.empty() ? date() : ownershipHistory[0].first; }
 
 		void						setCOT(bool isCOT)	noexcept				{ centerOfTrade = isCOT; };
 	private:
-		void	checkBuilding(const wiz::load_data::UserType* provinceObj, const std::string& building);
+		void	readHistory(wiz::load_data::UserType* historyObj);
 		void	buildPopRatios();
 		void	decayPopRatios(date olddate, date newdate, EU3PopRatio& currentPop);
 
@@ -100,21 +110,21 @@ class EU3Province {
 		int									num;
 		double								baseTax;
 		double								totalWeight;
-		std::string								ownerString;
+		CountryTag							ownerString;
 		std::string								provName;
 		EU3Country*							owner;
-		std::vector<std::string>						cores;
+		std::vector<CountryTag>					cores;
 		int									population;
 		bool									colony;
 		bool									centerOfTrade;
-		std::vector< std::pair<date, std::string> >	ownershipHistory;
-		std::map<std::string, date>					lastPossessedDate;
-		std::vector< std::pair<date, std::string> >	religionHistory;
-		std::vector< std::pair<date, std::string> >	cultureHistory;
+		std::vector< std::pair<date, CountryTag> >	ownershipHistory;
+		std::map<CountryTag, date>					lastPossessedDate;
+		std::vector< std::pair<date, Symbol> >	religionHistory;
+		std::vector< std::pair<date, Symbol> >	cultureHistory;
 		std::vector<EU3PopRatio>				popRatios;
-		std::map<std::string, bool>					buildings;
+		EU3BuildingSet							buildings;
 		double								manpower;
-		std::string								tradeGoods;
+		Symbol								tradeGoods;
 		int									numV2Provs;
 
 		// province attributes for weights
@@ -23,6 +23,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "EU3Relations.h"
+#include "../Snapshot.h"
 
 
 
@@ -69,3 +70,23 @@ EU3Relations::EU3Relations(const wiz::load_data::UserType* obj) {
 		last_war = date();
 	}
 }
+
+
+EU3Relations::EU3Relations(SnapshotReader& snapshot)
+{
+	tag						= snapshot.readTag();
+	value						= static_cast<int>(snapshot.readInt());
+	military_access		= snapshot.readBool();
+	last_send_diplomat	= snapshot.readDate();
+	last_war					= snapshot.readDate();
+}
+
+
+void EU3Relations::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(tag);
+	snapshot.writeInt(value);
+	snapshot.writeBool(military_access);
+	snapshot.writeDate(last_send_diplomat);
+	snapshot.writeDate(last_war);
+}
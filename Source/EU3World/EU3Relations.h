@@ -25,22 +25,28 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #define EU3RELATIONS_H_
 
 
+#include "../CountryTag.h"
 #include "../Date.h"
 #include <string>
 
 #include "wiz/load_data_types.h"
 
+class SnapshotReader;
+class SnapshotWriter;
+
 class EU3Relations
 {
 	public:
 		EU3Relations(const wiz::load_data::UserType* obj);
-		std::string	getCountry() const noexcept { return tag; };
+		EU3Relations(SnapshotReader& snapshot);
+		void	writeSnapshot(SnapshotWriter& snapshot) const;
+		CountryTag	getCountry() const noexcept { return tag; };
 		int		getRelations() const noexcept { return value; };
 		bool	hasMilitaryAccess() const noexcept { return military_access; };
 		date	getDiplomatLastSent() const noexcept { return last_send_diplomat; };
 		date	getLastWar() const noexcept { return last_war; };
 	private:
-		std::string	tag;
+		CountryTag	tag;
 		int		value;
 		bool	military_access;
 		date	last_send_diplomat;
@@ -47,7 +47,7 @@ public:
 	static void parseReligions(wiz::load_data::UserType* obj);
 	static EU3Religion* getReligion(const std::string& name);
 
-	static std::map<std::string, EU3Religion*> getAllReligions() noexcept { return all_religions; }
+	static const std::map<std::string, EU3Religion*>& getAllReligions() noexcept { return all_religions; }
 
 private:
 	std::string name;
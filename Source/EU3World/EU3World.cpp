@@ -24,9 +24,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "EU3World.h"
 #include <algorithm>
 #include <fstream>
+#include <new>
+#include <stdexcept>
 #include "../Log.h"
+#include "../Diagnostics.h"
 #include "../Configuration.h"
+#include "../CultureRuleEngine.h"
 #include "../Mapper.h"
+#include "../Parallel.h"
+#include "../Snapshot.h"
 #include "EU3Province.h"
 #include "EU3Country.h"
 #include "EU3Diplomacy.h"
@@ -52,6 +58,8 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 	*/
 	provinces.clear();
 	countries.clear();
+	std::vector<wiz::load_data::UserType*> provinceObjs;
+	std::vector<wiz::load_data::UserType*> countryObjs;
 	for (int i = 0; i < obj->GetUserTypeListSize(); ++i)
 	{
 		key = obj->GetUserTypeList(i)->GetName().ToString();
@@ -59,8 +67,7 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 		// Is this a numeric value? If so, must be a province
 		if (wiz::load_data::Utility::IsInteger(key)) 
 		{
-			EU3Province* province = new EU3Province(obj->GetUserTypeList(i));
-			provinces.insert(std::make_pair(province->getNum(), province));
+			provinceObjs.push_back(obj->GetUserTypeList(i));
 		}
 
 		// Countries are three uppercase characters
@@ -76,42 +83,44 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 			}
 			else
 			{
-				EU3Country* country = new EU3Country(obj->GetUserTypeList(i));
-				
-				countries.insert(std::make_pair(country->getTag(), country));
+				countryObjs.push_back(obj->GetUserTypeList(i));
 			}
 		}
 	}
 
-	// add province owner info to countries
-	for (std::map<int, EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	// the provinces and countries only read their own part of the save, so they can be built side by side
+	std::vector<EU3Province*> newProvinces(provinceObjs.size());
+	std::vector<EU3Country*> newCountries(countryObjs.size());
+	ParallelFor(provinceObjs.size() + countryObjs.size(), [&](size_t i)
 	{
-		std::map<std::string, EU3Country*>::iterator j = countries.find( i->second->getOwnerString() );
-		if (j != countries.end())
+		if (i < provinceObjs.size())
 		{
-			j->second->addProvince(i->second);
-			i->second->setOwner(j->second);
+			newProvinces[i] = arena.make<EU3Province>(provinceObjs[i]);
 		}
-	}
-
-	// add province core info to countries
-	for (std::map<int, EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
-	{
-		std::vector<EU3Country*> cores = i->second->getCores(countries);
-		for (std::vector<EU3Country*>::iterator j = cores.begin(); j != cores.end(); ++j)
+		else
 		{
-			(*j)->addCore(i->second);
+			newCountries[i - provinceObjs.size()] = arena.make<EU3Country>(countryObjs[i - provinceObjs.size()], arena, regimentPool);
 		}
+	});
+	for (std::vector<EU3Province*>::iterator itr = newProvinces.begin(); itr != newProvinces.end(); ++itr)
+	{
+		provinces.insert(std::make_pair((*itr)->getNum(), *itr));
 	}
+	for (std::vector<EU3Country*>::iterator itr = newCountries.begin(); itr != newCountries.end(); ++itr)
+	{
+		countries.insert(std::make_pair((*itr)->getTag(), *itr));
+	}
+
+	linkProvinces();
 
 	std::vector<wiz::load_data::UserType*> diploObj = obj->GetUserTypeItem("diplomacy");
 	if (diploObj.size() > 0)
 	{
-		diplomacy = new EU3Diplomacy(diploObj[0]);
+		diplomacy = arena.make<EU3Diplomacy>(diploObj[0]);
 	}
 	else
 	{
-		diplomacy = new EU3Diplomacy;
+		diplomacy = arena.make<EU3Diplomacy>();
 	}
 
 	std::vector<wiz::load_data::UserType*> tradeObj = obj->GetUserTypeItem("trade");
@@ -121,7 +130,7 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 		for (std::vector<wiz::load_data::UserType*>::iterator i = COTsObj.begin(); i != COTsObj.end(); ++i)
 		{
 			int location = (*i)->GetItem("location")[0].Get(0).ToInt();
-			std::map<int, EU3Province*>::iterator j = provinces.find(location);
+			ProvinceTable<EU3Province*>::iterator j = provinces.find(location);
 			if (j != provinces.end())
 			{
 				j->second->setCOT(true);
@@ -131,15 +140,10 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 
 	// calculate total province weights
 	worldWeightSum = 0;
-	std::vector<double> provEconVec;
-	std::map<std::string, std::vector<double> > world_tag_weights;
-	for (std::map<int, EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	std::map<CountryTag, std::vector<double> > world_tag_weights;
+	for (ProvinceTable<EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
 	{
 		i->second->determineProvinceWeight();
-		// 0: Goods produced; 1 trade goods price; 2: trade value efficiency; 3: production effiency; 4: trade value; 5: production income
-		// 6: base tax; 7: building tax income 8: building tax eff; 9: total tax income; 10: total_trade_value
-
-		provEconVec = i->second->getProvProductionVec();
 		worldWeightSum += i->second->getTotalWeight();
 
 		std::vector<double> map_values;
@@ -165,7 +169,7 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 			
 		}
 		else {
-			world_tag_weights.insert(std::pair<std::string, std::vector<double> >(i->second->getOwnerString(), std::move(map_values)));
+			world_tag_weights.insert(std::pair<CountryTag, std::vector<double> >(i->second->getOwnerString(), std::move(map_values)));
 		}
 	}
 
@@ -176,9 +180,101 @@ EU3World::EU3World(const wiz::load_data::UserType* obj)
 }
 
 
+EU3World* EU3World::readSnapshot(SnapshotReader& snapshot)
+{
+	EU3World* world = new EU3World;
+
+	try
+	{
+		size_t numProvinces = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numProvinces); ++i)
+		{
+			EU3Province* province = world->arena.make<EU3Province>(snapshot);
+			world->provinces.insert(std::make_pair(province->getNum(), province));
+		}
+		size_t numCountries = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numCountries); ++i)
+		{
+			EU3Country* country = world->arena.make<EU3Country>(snapshot, world->arena, world->regimentPool);
+			world->countries.insert(std::make_pair(country->getTag(), country));
+		}
+		world->diplomacy			= world->arena.make<EU3Diplomacy>(snapshot);
+		world->worldWeightSum	= snapshot.readDouble();
+	}
+	catch (const std::bad_alloc&)
+	{
+		snapshot.fail();
+	}
+	catch (const std::length_error&)
+	{
+		snapshot.fail();
+	}
+
+	if (!snapshot.good())
+	{
+		// the half-built objects are all in the world's arena, so they go with it
+		delete world;
+		return nullptr;
+	}
+
+	world->linkProvinces();
+	LOG(LogLevel::Info) << "Sum of all Province Weights: " << world->worldWeightSum;
+	return world;
+}
+
+
+void EU3World::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeInt(provinces.size());
+	for (ProvinceTable<EU3Province*>::const_iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	{
+		itr->second->writeSnapshot(snapshot);
+	}
+	snapshot.writeInt(countries.size());
+	for (std::map<CountryTag, EU3Country*>::const_iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	{
+		itr->second->writeSnapshot(snapshot);
+	}
+	diplomacy->writeSnapshot(snapshot);
+	snapshot.writeDouble(worldWeightSum);
+}
+
+
+void EU3World::linkProvinces()
+{
+	// the first owner of province 1 marks when the EU3 game started
+	ProvinceTable<EU3Province*>::iterator firstProvince = provinces.find(1);
+	if (firstProvince != provinces.end())
+	{
+		Configuration::setFirstEU3Date(firstProvince->second->getFirstOwnershipDate());
+	}
+
+	// add province owner info to countries
+	for (ProvinceTable<EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	{
+		std::map<CountryTag, EU3Country*>::iterator j = countries.find( i->second->getOwnerString() );
+		if (j != countries.end())
+		{
+			j->second->addProvince(i->second);
+			i->second->setOwner(j->second);
+		}
+	}
+
+	// add province core info to countries
+	for (ProvinceTable<EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	{
+		std::vector<EU3Country*> cores = i->second->getCores(countries);
+		for (std::vector<EU3Country*>::iterator j = cores.begin(); j != cores.end(); ++j)
+		{
+			(*j)->addCore(i->second);
+		}
+	}
+}
+
+
 void EU3World::setEU3WorldProvinceMappings(const inverseProvinceMapping& inverseProvinceMap)
 {
-	for (std::map<int, EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	for (ProvinceTable<EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
 	{
 		i->second->setNumDestV2Provs(inverseProvinceMap.find(i->first)->second.size());
 	}
@@ -203,7 +299,7 @@ void EU3World::readCommonCountries(std::istream& in, const std::string& rootPath
 		{
 			// First three characters must be the tag.
 			std::string tag = countryLine.substr(0, 3);
-			std::map<std::string, EU3Country*>::iterator findIter = countries.find(tag);
+			std::map<CountryTag, EU3Country*>::iterator findIter = countries.find(tag);
 			if (findIter != countries.end())
 			{
 				EU3Country* country = findIter->second;
@@ -235,9 +331,9 @@ void EU3World::readCommonCountries(std::istream& in, const std::string& rootPath
 }
 
 
-EU3Country* EU3World::getCountry(std::string tag) const
+EU3Country* EU3World::getCountry(CountryTag tag) const
 {
-	std::map<std::string, EU3Country*>::const_iterator i = countries.find(tag);
+	std::map<CountryTag, EU3Country*>::const_iterator i = countries.find(tag);
 	if (i != countries.end())
 	{
 		return i->second;
@@ -251,7 +347,7 @@ EU3Country* EU3World::getCountry(std::string tag) const
 
 EU3Province* EU3World::getProvince(int provNum) const
 {
-	std::map<int, EU3Province*>::const_iterator i = provinces.find(provNum);
+	ProvinceTable<EU3Province*>::const_iterator i = provinces.find(provNum);
 	if (i != provinces.end())
 	{
 		return i->second;
@@ -263,7 +359,7 @@ EU3Province* EU3World::getProvince(int provNum) const
 }
 
 
-void EU3World::removeCountry(std::string tag)
+void EU3World::removeCountry(CountryTag tag)
 {
 	countries.erase(tag);
 }
@@ -271,7 +367,7 @@ void EU3World::removeCountry(std::string tag)
 
 void EU3World::resolveRegimentTypes(const RegimentTypeMap& rtMap)
 {
-	for (std::map<std::string, EU3Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	for (std::map<CountryTag, EU3Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
 	{
 		itr->second->resolveRegimentTypes(rtMap);
 	}
@@ -286,7 +382,7 @@ WorldType EU3World::getWorldType()
 	}
 
 	int maxProvinceID = 0;
-	for (std::map<int, EU3Province*>::iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	for (ProvinceTable<EU3Province*>::iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
 	{
 		if ( itr->first > maxProvinceID )
 		{
@@ -307,7 +403,7 @@ WorldType EU3World::getWorldType()
 		cachedWorldType = DivineWind;
 		break;
 	default:
-		Log(LogLevel::Warning) << "Unrecognized max province ID: " << maxProvinceID;
+		LOG(LogLevel::Warning) << "Unrecognized max province ID: " << maxProvinceID;
 		if (maxProvinceID < 1774)
 		{
 			cachedWorldType = VeryOld; // pre-IN
@@ -341,12 +437,12 @@ WorldType EU3World::getWorldType()
 
 	if ((cachedWorldType != forcedWorldType) && (cachedWorldType != unknown))
 	{
-		Log(LogLevel::Warning) << "World type was detected successfuly, but a different type was specified in the configuration file!";
+		LOG(LogLevel::Warning) << "World type was detected successfuly, but a different type was specified in the configuration file!";
 	}
 
 	if (cachedWorldType == unknown)
 	{
-		Log(LogLevel::Warning) << "World type unknown!";
+		LOG(LogLevel::Warning) << "World type unknown!";
 	}
 
 	if (forcedWorldType != unknown)
@@ -360,32 +456,23 @@ WorldType EU3World::getWorldType()
 
 void EU3World::checkAllProvincesMapped(const inverseProvinceMapping& inverseProvinceMap) const
 {
-	for (std::map<int, EU3Province*>::const_iterator i = provinces.begin(); i != provinces.end(); ++i)
+	for (ProvinceTable<EU3Province*>::const_iterator i = provinces.begin(); i != provinces.end(); ++i)
 	{
 		inverseProvinceMapping::const_iterator j = inverseProvinceMap.find(i->first);
 		if (j == inverseProvinceMap.end())
 		{
-			LOG(LogLevel::Warning) << "No mapping for province " << i->first;
+			DIAGNOSE(LogLevel::Warning, "No mapping for province") << i->first;
 		}
 	}
 }
 
 
-void EU3World::checkAllEU3CulturesMapped(const cultureMapping& cultureMap, const inverseUnionCulturesMap& inverseUnionCultures) const
+void EU3World::checkAllEU3CulturesMapped(const CultureRuleEngine& cultureRules, const inverseUnionCulturesMap& inverseUnionCultures) const
 {
 	for (auto cultureItr = inverseUnionCultures.begin(); cultureItr != inverseUnionCultures.end(); ++cultureItr)
 	{
 		std::string	EU3Culture	= cultureItr->first;
-		bool		matched		= false;
-		for (auto mapItr = cultureMap.begin(); mapItr != cultureMap.end(); mapItr++)
-		{
-			if (mapItr->srcCulture == EU3Culture)
-			{
-				matched = true;
-				break;
-			}
-		}
-		if (!matched)
+		if (!cultureRules.hasRules(EU3Culture))
 		{
 			LOG(LogLevel::Warning) << "No culture mapping for EU3 culture " << EU3Culture;
 		}
@@ -395,13 +482,13 @@ void EU3World::checkAllEU3CulturesMapped(const cultureMapping& cultureMap, const
 
 void EU3World::checkAllEU3ReligionsMapped(const religionMapping& religionMap) const
 {
-	std::map<std::string, EU3Religion*> allReligions = EU3Religion::getAllReligions();
+	const std::map<std::string, EU3Religion*>& allReligions = EU3Religion::getAllReligions();
 	for (auto religionItr = allReligions.begin(); religionItr != allReligions.end(); ++religionItr)
 	{
 		auto mapItr = religionMap.find(religionItr->first);
 		if (mapItr == religionMap.end())
 		{
-			Log(LogLevel::Warning) << "No religion mapping for EU3 religion " << religionItr->first;
+			LOG(LogLevel::Warning) << "No religion mapping for EU3 religion " << religionItr->first;
 		}
 	}
 }
@@ -409,7 +496,7 @@ void EU3World::checkAllEU3ReligionsMapped(const religionMapping& religionMap) co
 
 void EU3World::setLocalisations(const EU3Localisation& localisation)
 {
-	for (std::map<std::string, EU3Country*>::iterator countryItr = countries.begin(); countryItr != countries.end(); ++countryItr)
+	for (std::map<CountryTag, EU3Country*>::iterator countryItr = countries.begin(); countryItr != countries.end(); ++countryItr)
 	{
 		const auto& nameLocalisations = localisation.GetTextInEachLanguage(countryItr->first);
 		for (const auto& nameLocalisation : nameLocalisations)
@@ -29,13 +29,18 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <istream>
 #include "EU3Army.h"
+#include "../Arena.h"
 #include "../Mapper.h"
+#include "../ProvinceTable.h"
 
 class EU3Country;
 class EU3Province;
 class EU3Diplomacy;
 class EU3Localisation;
+class CultureRuleEngine;
 struct EU3Agreement;
+class SnapshotReader;
+class SnapshotWriter;
 
 #include "wiz/load_data_types.h"
 
@@ -53,29 +58,38 @@ enum WorldType
 class EU3World {
 	public:
 		EU3World(const wiz::load_data::UserType* obj);
+		static EU3World* readSnapshot(SnapshotReader& snapshot);	// nullptr if the snapshot is damaged
+		void writeSnapshot(SnapshotWriter& snapshot) const;
 		void setEU3WorldProvinceMappings(const inverseProvinceMapping& inverseProvinceMap);
 
 		void	readCommonCountries(std::istream&, const std::string& rootPath);
 		void	readCountryLocalisation(std::istream&); // remove?
 
-		EU3Country*						getCountry(std::string tag) const;
+		EU3Country*						getCountry(CountryTag tag) const;
 		EU3Province*					getProvince(int provNum) const;
-		void								removeCountry(std::string tag);
+		void								removeCountry(CountryTag tag);
 		void								resolveRegimentTypes(const RegimentTypeMap& map);
 		WorldType						getWorldType();
 		void								checkAllProvincesMapped(const inverseProvinceMapping& inverseProvinceMap) const;
-		void								checkAllEU3CulturesMapped(const cultureMapping& cultureMap, 
+		void								checkAllEU3CulturesMapped(const CultureRuleEngine& cultureRules, 
 														const inverseUnionCulturesMap& inverseUnionCultures) const;
 		void								checkAllEU3ReligionsMapped(const religionMapping& religionMap) const;
 		void								setLocalisations(const EU3Localisation& localisation);
 
-		std::map<std::string, EU3Country*>	getCountries()	const noexcept { return countries; };
+		const std::map<CountryTag, EU3Country*>&	getCountries()	const noexcept { return countries; };
 		EU3Diplomacy*					getDiplomacy()	const noexcept { return diplomacy; };
 		double							getWorldWeightSum() const noexcept { return worldWeightSum; };
 	private:
+		EU3World(): cachedWorldType(unknown), diplomacy(nullptr), worldWeightSum(0.0) {};
+		void								linkProvinces();
+
+		// everything in the world is made here, and goes when the world does
+		Arena								arena;
+		ObjectPool<EU3Regiment>			regimentPool;
+
 		WorldType						cachedWorldType;
-		std::map<int, EU3Province*>		provinces;
-		std::map<std::string, EU3Country*>	countries;
+		ProvinceTable<EU3Province*>		provinces;
+		std::map<CountryTag, EU3Country*>	countries;
 		EU3Diplomacy*					diplomacy;
 		double							worldWeightSum;
 };
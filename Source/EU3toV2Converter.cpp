@@ -25,10 +25,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <io.h>
 #include <stdexcept>
 #include <fstream>
+#include <set>
+#include <memory>
 #include <sys/stat.h>
 #include <io.h>
+#include "EU3toV2Converter.h"
 #include "Configuration.h"
 #include "Log.h"
+#include "Diagnostics.h"
+#include "StageTimer.h"
+#include "Snapshot.h"
+#include "WinUtils.h"
 #include "EU3World/EU3World.h"
 #include "EU3World/EU3Religion.h"
 #include "EU3World/EU3Localisation.h"
@@ -39,13 +46,54 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "wiz/load_data.h"
 
-// Converts the given EU3 save into a V2 mod.
+// The game data and mapping rules a conversion reads.  None of it depends on the save, so batch
+// mode loads it once and converts every save against it.
+struct conversionData
+{
+	conversionData() : baseWorld(nullptr), factoryBuilder(nullptr), leaderTraits(nullptr), demographicCache(nullptr) {}
+	~conversionData()
+	{
+		delete baseWorld;
+		delete factoryBuilder;
+		delete leaderTraits;
+		delete demographicCache;
+	}
+
+	std::string						fullModPath;
+	EU3Localisation				localisation;
+	RegimentTypeMap				regimentTypes;
+	wiz::load_data::UserType	mergeNationsObj;
+	V2World*							baseWorld;			// the unconverted V2 world, copied for each save
+	V2FactoryFactory*				factoryBuilder;
+	wiz::load_data::UserType	provinceMappingsObj;	// read per save, as the mappings depend on the EU3 game type
+	CountryMapping					countryRules;
+	AdjacencyGraph					adjacencyMap;
+	continentMapping				continentMap;
+	stateMapping					stateMap;
+	stateIndexMapping				stateIndexMap;
+	CultureRuleEngine				cultureRules;
+	CultureRuleEngine				slaveCultureRules;
+	unionCulturesMap				unionCultures;
+	inverseUnionCulturesMap		inverseUnionCultures;
+	religionMapping				religionMap;
+	unionMapping					unionMap;
+	governmentMapping				governmentMap;
+	std::vector<techSchool>		techSchools;
+	V2LeaderTraits*				leaderTraits;
+	EU3RegionsMapping				EU3RegionsMap;
+	DemographicCache*				demographicCache;	// shared by every save, as it only depends on the rules
+};
+
+
+// Reads the configuration, the game data and the mapping rules.
 // Returns 0 on success or a non-zero failure code on error.
-int ConvertEU3ToV2(const std::string& EU3SaveFileName)
+static int LoadConversionData(conversionData& data)
 {
 	wiz::load_data::UserType obj;				// generic object
 	std::ifstream	read;				// std::ifstream for reading files
 
+	StageTimer stage("Reading configuration");
+
 	char curDir[MAX_PATH];
 	GetCurrentDirectory(MAX_PATH, curDir);
 	LOG(LogLevel::Debug) << "Current directory is " << curDir;
@@ -94,105 +142,34 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 
 	// Get EU3 Mod
 	LOG(LogLevel::Debug) << "Get EU3 Mod";
-	std::string fullModPath;
 	std::string modName = Configuration::getEU3Mod();
 	if (modName != "")
 	{
-		fullModPath = EU3Loc + "\\mod\\" + modName;
-		if (fullModPath.empty() || (_stat(fullModPath.c_str(), &st) != 0))
+		data.fullModPath = EU3Loc + "\\mod\\" + modName;
+		if (data.fullModPath.empty() || (_stat(data.fullModPath.c_str(), &st) != 0))
 		{
 			LOG(LogLevel::Error) << modName << " could not be found at the specified directory.  A valid path and mod must be specified.";
 			return (-1);
 		}
 		else
 		{
-			LOG(LogLevel::Debug) << "EU3 Mod directory is " << fullModPath;
+			LOG(LogLevel::Debug) << "EU3 Mod directory is " << data.fullModPath;
 		}
 	}
 
-	//get output name
-	const int slash	= EU3SaveFileName.find_last_of("\\");				// the last slash in the save's filename
-	std::string outputName	= EU3SaveFileName.substr(slash + 1, EU3SaveFileName.length());
-	const int length	= outputName.find_first_of(".");						// the first period after the slash
-	outputName			= outputName.substr(0, length);						// the name to use to output the mod
-	int dash = outputName.find_first_of('-');
-	while (dash != std::string::npos)
-	{
-		outputName.replace(dash, 1, "_");
-		dash = outputName.find_first_of('-');
-	}
-	int space = outputName.find_first_of(' ');
-	while (space != std::string::npos)
-	{
-		outputName.replace(space, 1, "_");
-		space = outputName.find_first_of(' ');
-	}
-	Configuration::setOutputName(outputName);
-	LOG(LogLevel::Info) << "Using output name " << outputName;
-
-	LOG(LogLevel::Info) << "* Importing EU3 save *";
-
-	// Parse EU3 Save
-	LOG(LogLevel::Info) << "Parsing save";
-
-	if (!wiz::load_data::LoadData::LoadDataFromFile3(EU3SaveFileName, obj, -1, 0))
-	{
-		LOG(LogLevel::Error) << "Could not parse file " << EU3SaveFileName;
-		exit(-1);
-	}
-	
 	// Read all localisations.
+	stage.next("Reading localisation");
 	LOG(LogLevel::Info) << "Reading localisation";
-	EU3Localisation localisation;
-	localisation.ReadFromAllFilesInFolder(Configuration::getEU3Path() + "\\localisation");
-	if (!fullModPath.empty())
+	data.localisation.ReadFromAllFilesInFolder(Configuration::getEU3Path() + "\\localisation");
+	if (!data.fullModPath.empty())
 	{
 		LOG(LogLevel::Debug) << "Reading mod localisation";
-		localisation.ReadFromAllFilesInFolder(fullModPath + "\\localisation");
-	}
-
-	// Construct world from EU3 save.
-	LOG(LogLevel::Info) << "Building world";
-	EU3World sourceWorld(&obj);
-
-	// Read EU3 common\countries
-	LOG(LogLevel::Info) << "Reading EU3 common\\countries";
-	{
-		std::ifstream commonCountries(Configuration::getEU3Path() + "\\common\\countries.txt");
-		sourceWorld.readCommonCountries(commonCountries, Configuration::getEU3Path());
-		if (!fullModPath.empty())
-		{
-			std::ifstream convertedCommonCountries(fullModPath + "\\common\\countries.txt");
-			sourceWorld.readCommonCountries(convertedCommonCountries, fullModPath);
-		}
-	}
-
-	// Figure out what EU3 gametype we're using
-	WorldType game = sourceWorld.getWorldType();
-	switch (game)
-	{
-		case VeryOld:
-			LOG(LogLevel::Error) << "EU3 game appears to be from an old version; only IN, HttT, and DW are supported.";
-			exit(1);
-		case InNomine:
-			LOG(LogLevel::Info) << "Game type is: EU3 In Nomine.  EXPERIMENTAL.";
-			break;
-		case HeirToTheThrone:
-			LOG(LogLevel::Info) << "Game type is: EU3 Heir to the Throne.";
-			break;
-		case DivineWind:
-			LOG(LogLevel::Info) << "Game type is: EU3 Divine Wind.";
-			break;
-		default:
-			LOG(LogLevel::Error) << "Error: Could not determine savegame type.";
-			exit(1);
+		data.localisation.ReadFromAllFilesInFolder(data.fullModPath + "\\localisation");
 	}
 
-	sourceWorld.setLocalisations(localisation);
-
-	// Resolve unit types
-	LOG(LogLevel::Info) << "Resolving unit types.";
-	RegimentTypeMap rtm;
+	// Read unit types
+	stage.next("Reading unit types");
+	LOG(LogLevel::Info) << "Reading unit types.";
 	read.open("unit_strength.txt");
 	if (read.is_open())
 	{
@@ -207,7 +184,7 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		}
 		for (int i = 0; i < num_reg_categories; ++i)
 		{
-			AddCategoryToRegimentTypeMap(&obj,  (RegimentCategory)i, RegimentCategoryNames[i], rtm);
+			AddCategoryToRegimentTypeMap(&obj,  (RegimentCategory)i, RegimentCategoryNames[i], data.regimentTypes);
 		}
 	}
 	else
@@ -228,69 +205,64 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 			}
 			std::string unitFilename = unitFileData.name;
 			std::string unitName = unitFilename.substr(0, unitFilename.find_first_of('.'));
-			AddUnitFileToRegimentTypeMap((EU3Loc + "\\common\\units"), unitName, rtm);
+			AddUnitFileToRegimentTypeMap((EU3Loc + "\\common\\units"), unitName, data.regimentTypes);
 		} while(_findnext(fileListing, &unitFileData) == 0);
 		_findclose(fileListing);
 	}
 	read.close();
 	read.clear();
-	sourceWorld.resolveRegimentTypes(rtm);
 
-
-	// Merge nations
-	LOG(LogLevel::Info) << "Merging nations.";
-	
-	if (!wiz::load_data::LoadData::LoadDataFromFile3("merge_nations.txt", obj, -1, 0))
+	// Read nation merging rules
+	stage.next("Reading nation merging rules");
+	LOG(LogLevel::Info) << "Reading nation merging rules.";
+	if (!wiz::load_data::LoadData::LoadDataFromFile3("merge_nations.txt", data.mergeNationsObj, -1, 0))
 	{
 		LOG(LogLevel::Error) << "Could not parse file merge_nations.txt";
 		exit(-1);
 	}
-	mergeNations(sourceWorld, &obj);
 
 
 	// Parse V2 input file
+	stage.next("Parsing Vicky2 data");
 	LOG(LogLevel::Info) << "Parsing Vicky2 data";
 	std::vector<std::pair<std::string, std::string>> minorityPops;
 	minorityPops.push_back(std::make_pair("ashkenazi","jewish"));
 	minorityPops.push_back(std::make_pair("sephardic","jewish"));
 	minorityPops.push_back(std::make_pair("","jewish"));
-	V2World destWorld(minorityPops);
+	data.baseWorld = new V2World(minorityPops);
 
 
 	// Construct factory factory
+	stage.next("Determining factory allocation rules");
 	LOG(LogLevel::Info) << "Determining factory allocation rules.";
-	V2FactoryFactory factoryBuilder;
+	data.factoryBuilder = new V2FactoryFactory;
 
 
 	// Parse province mappings
+	stage.next("Parsing province mappings");
 	LOG(LogLevel::Info) << "Parsing province mappings";
 
-	if (!wiz::load_data::LoadData::LoadDataFromFile3("province_mappings.txt", obj, -1, 0))
+	if (!wiz::load_data::LoadData::LoadDataFromFile3("province_mappings.txt", data.provinceMappingsObj, -1, 0))
 	{
 		LOG(LogLevel::Error) << "Could not parse file province_mappings.txt";
 		exit(-1);
 	}
-	provinceMapping			provinceMap;
-	inverseProvinceMapping	inverseProvinceMap;
-	resettableMap				resettableProvinces;
-	initProvinceMap(&obj,  sourceWorld.getWorldType(), provinceMap, inverseProvinceMap, resettableProvinces);
-	sourceWorld.checkAllProvincesMapped(inverseProvinceMap);
-	sourceWorld.setEU3WorldProvinceMappings(inverseProvinceMap);
 
 
 	// Get country mappings
+	stage.next("Getting country mappings");
 	LOG(LogLevel::Info) << "Getting country mappings";
-	CountryMapping countryMap;
-	countryMap.ReadRules("country_mappings.txt");
+	data.countryRules.ReadRules("country_mappings.txt");
 
 	// Get adjacencies
+	stage.next("Importing adjacencies");
 	LOG(LogLevel::Info) << "Importing adjacencies";
-	adjacencyMapping adjacencyMap = initAdjacencyMap();
+	data.adjacencyMap = initAdjacencyMap();
 
 	// Generate continent mapping
+	stage.next("Finding Continents");
 	LOG(LogLevel::Info) << "Finding Continents";
 	std::string EU3Mod = Configuration::getEU3Mod();
-	continentMapping continentMap;
 	if (EU3Mod != "")
 	{
 		std::string continentFile = Configuration::getEU3Path() + "\\mod\\" + EU3Mod + "\\map\\continent.txt";
@@ -298,11 +270,11 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		{
 			if (!wiz::load_data::LoadData::LoadDataFromFile3(continentFile, obj, -1, 0))
 			{
-				initContinentMap(&obj,  continentMap);
+				initContinentMap(&obj,  data.continentMap);
 			}
 		}
 	}
-	if (continentMap.size() == 0)
+	if (data.continentMap.size() == 0)
 	{
 		if (!wiz::load_data::LoadData::LoadDataFromFile3((EU3Loc + "\\map\\continent.txt"), obj, -1, 0))
 		{
@@ -314,42 +286,62 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 			LOG(LogLevel::Error) << "Failed to parse continent.txt";
 			return 1;
 		}
-		initContinentMap(&obj,  continentMap);
+		initContinentMap(&obj,  data.continentMap);
 	}
-	if (continentMap.size() == 0)
+	if (data.continentMap.size() == 0)
 	{
 		LOG(LogLevel::Warning) << "No continent mappings found - may lead to problems later";
 	}
 	
 	// Generate region mapping
-	LOG(LogLevel::Info) << "Parsing region structure";
-	/*if (_stat(".\\blankMod\\output\\map\\region.txt", &st) == 0)
+	stage.next("Parsing region structure");
+	SnapshotKey stateSnapshotKey;
+	stateSnapshotKey.addFile(V2Loc + "\\map\\region.txt");
+	SnapshotReader stateSnapshot;
+	if (	Configuration::getStaticDataCache() &&
+			stateSnapshot.open("V2States.snapshot", stateSnapshotKey) &&
+			readStateMapSnapshot(stateSnapshot, data.stateMap, data.stateIndexMap)
+		)
 	{
-		if (!wiz::load_data::LoadData::LoadDataFromFile3(".\\blankMod\\output\\map\\region.txt", obj, -1, 0))
-		{
-			LOG(LogLevel::Error) << "Could not parse file .\\blankMod\\output\\map\\region.txt";
-			exit(-1);
-		}
+		LOG(LogLevel::Info) << "Reading region structure from V2States.snapshot";
 	}
-	else*/
+	else
 	{
-		if (!wiz::load_data::LoadData::LoadDataFromFile3((V2Loc + "\\map\\region.txt"), obj, -1, 0))
+		stateSnapshot.close();
+		LOG(LogLevel::Info) << "Parsing region structure";
+		/*if (_stat(".\\blankMod\\output\\map\\region.txt", &st) == 0)
 		{
-			LOG(LogLevel::Error) << "Could not parse file " << V2Loc << "\\map\\region.txt";
-			exit(-1);
+			if (!wiz::load_data::LoadData::LoadDataFromFile3(".\\blankMod\\output\\map\\region.txt", obj, -1, 0))
+			{
+				LOG(LogLevel::Error) << "Could not parse file .\\blankMod\\output\\map\\region.txt";
+				exit(-1);
+			}
+		}
+		else*/
+		{
+			if (!wiz::load_data::LoadData::LoadDataFromFile3((V2Loc + "\\map\\region.txt"), obj, -1, 0))
+			{
+				LOG(LogLevel::Error) << "Could not parse file " << V2Loc << "\\map\\region.txt";
+				exit(-1);
+			}
+		}
+		if (obj.GetIListSize() < 1)
+		{
+			LOG(LogLevel::Error) << "Could not parse region.txt";
+			return 1;
+		}
+		initStateMap(&obj,  data.stateMap, data.stateIndexMap);
+		if (Configuration::getStaticDataCache())
+		{
+			SnapshotWriter newSnapshot;
+			writeStateMapSnapshot(newSnapshot, data.stateMap, data.stateIndexMap);
+			newSnapshot.save("V2States.snapshot", stateSnapshotKey);
 		}
 	}
-	if (obj.GetIListSize() < 1)
-	{
-		LOG(LogLevel::Error) << "Could not parse region.txt";
-		return 1;
-	}
-	stateMapping		stateMap;
-	stateIndexMapping stateIndexMap;
-	initStateMap(&obj,  stateMap, stateIndexMap);
 
 
 	// Parse Culture Mappings
+	stage.next("Parsing culture mappings");
 	LOG(LogLevel::Info) << "Parsing culture mappings";
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("cultureMap.txt", obj, -1, 0))
@@ -362,8 +354,7 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Failed to parse cultureMap.txt";
 		return 1;
 	}
-	cultureMapping cultureMap;
-	cultureMap = initCultureMap(obj.GetUserTypeList(0));
+	cultureMapping cultureMap = initCultureMap(obj.GetUserTypeList(0));
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("slaveCultureMap.txt", obj, -1, 0))
 	{
@@ -375,11 +366,8 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Failed to parse slaveCultureMap.txt";
 		return 1;
 	}
-	cultureMapping slaveCultureMap;
-	slaveCultureMap = initCultureMap(obj.GetUserTypeList(0));
+	cultureMapping slaveCultureMap = initCultureMap(obj.GetUserTypeList(0));
 
-	unionCulturesMap			unionCultures;
-	inverseUnionCulturesMap	inverseUnionCultures;
 	if (EU3Mod != "")
 	{
 		std::string modCultureFile = Configuration::getEU3Path() + "\\mod\\" + EU3Mod + "\\common\\cultures.txt";
@@ -387,22 +375,22 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		{
 			if (wiz::load_data::LoadData::LoadDataFromFile3(modCultureFile, obj, -1, 0) && (obj.GetIListSize() > 0))
 			{
-				initUnionCultures(&obj,  unionCultures, inverseUnionCultures);
+				initUnionCultures(&obj,  data.unionCultures, data.inverseUnionCultures);
 			}
 		}
 	}
-	if (unionCultures.size() == 0)
+	if (data.unionCultures.size() == 0)
 	{
 		if (!wiz::load_data::LoadData::LoadDataFromFile3(EU3Loc + "\\common\\cultures.txt", obj, -1, 0))
 		{
 			LOG(LogLevel::Error) << "Could not parse file " << EU3Loc << "\\common\\cultures.txt";
 			exit(-1);
 		}
-		initUnionCultures(&obj,  unionCultures, inverseUnionCultures);
+		initUnionCultures(&obj,  data.unionCultures, data.inverseUnionCultures);
 	}
-	sourceWorld.checkAllEU3CulturesMapped(cultureMap, inverseUnionCultures);
 
 	// Parse EU3 Religions
+	stage.next("Parsing EU3 religions");
 	LOG(LogLevel::Info) << "Parsing EU3 religions";
 	bool parsedReligions = false;
 	if (EU3Mod != "")
@@ -433,6 +421,7 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 	}
 
 	// Parse Religion Mappings
+	stage.next("Parsing religion mappings");
 	LOG(LogLevel::Info) << "Parsing religion mappings";
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("religionMap.txt", obj, -1, 0))
@@ -445,12 +434,11 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Failed to parse religionMap.txt";
 		return 1;
 	}
-	religionMapping religionMap;
-	religionMap = initReligionMap(obj.GetUserTypeList(0));
-	sourceWorld.checkAllEU3ReligionsMapped(religionMap);
+	data.religionMap = initReligionMap(obj.GetUserTypeList(0));
 
 
 	//Parse unions mapping
+	stage.next("Parsing union mappings");
 	LOG(LogLevel::Info) << "Parsing union mappings";
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("unions.txt", obj, -1, 0))
@@ -463,11 +451,11 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Failed to parse unions.txt";
 		return 1;
 	}
-	unionMapping unionMap;
-	unionMap = initUnionMap(obj.GetUserTypeList(0));
+	data.unionMap = initUnionMap(obj.GetUserTypeList(0));
 
 
 	//Parse government mapping
+	stage.next("Parsing governments mappings");
 	LOG(LogLevel::Info) << "Parsing governments mappings";
 	
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("governmentMapping.txt", obj, -1, 0))
@@ -475,11 +463,11 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Could not parse file governmentMapping.txt";
 		exit(-1);
 	}
-	governmentMapping governmentMap;
-	governmentMap = initGovernmentMap(obj.GetUserTypeList(0));
+	data.governmentMap = initGovernmentMap(obj.GetUserTypeList(0));
 
 
 	//Parse tech schools
+	stage.next("Parsing tech schools");
 	LOG(LogLevel::Info) << "Parsing tech schools.";
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3("blocked_tech_schools.txt", obj, -1, 0))
@@ -495,16 +483,16 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Could not parse file " << V2Loc << "\\common\\technology.txt";
 		exit(-1);
 	}
-	std::vector<techSchool> techSchools;
-	techSchools = initTechSchools(&obj,  blockedTechSchools);
+	data.techSchools = initTechSchools(&obj,  blockedTechSchools);
 
 
 	// Get Leader traits
+	stage.next("Getting leader traits");
 	LOG(LogLevel::Info) << "Getting leader traits";
-	V2LeaderTraits lt;
-	std::map<int, int> leaderIDMap; // <EU3, V2>
+	data.leaderTraits = new V2LeaderTraits;
 
 	// Parse EU4 Regions
+	stage.next("Parsing EU4 regions");
 	LOG(LogLevel::Info) << "Parsing EU4 regions";
 
 	if (!wiz::load_data::LoadData::LoadDataFromFile3((EU3Loc + "\\map\\region.txt"), obj, -1, 0))
@@ -517,8 +505,7 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		LOG(LogLevel::Error) << "Failed to parse region.txt";
 		return 1;
 	}
-	EU3RegionsMapping EU3RegionsMap;
-	initEU3RegionMap(&obj,  EU3RegionsMap);
+	initEU3RegionMap(&obj,  data.EU3RegionsMap);
 	if (EU3Mod != "")
 	{
 		std::string modRegionFile = Configuration::getEU3Path() + "\\mod\\" + EU3Mod + "\\map\\region.txt";
@@ -533,7 +520,165 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 		}
 	}
 
+	// the culture rules name regions, so they are compiled once the regions are known; only the main
+	// culture map lets a matching region override the distinguishers before it
+	data.cultureRules			= CultureRuleEngine(cultureMap, data.EU3RegionsMap, true);
+	data.slaveCultureRules	= CultureRuleEngine(slaveCultureMap, data.EU3RegionsMap, false);
+	data.demographicCache	= new DemographicCache(data.cultureRules, data.slaveCultureRules, data.religionMap, data.EU3RegionsMap);
+
+	return 0;
+}
+
+
+// Converts one save against the loaded data and writes the mod to Output.
+// Returns 0 on success or a non-zero failure code on error.
+static int ConvertSave(const std::string& EU3SaveFileName, const conversionData& data)
+{
+	//get output name
+	const int slash	= EU3SaveFileName.find_last_of("\\");				// the last slash in the save's filename
+	std::string outputName	= EU3SaveFileName.substr(slash + 1, EU3SaveFileName.length());
+	const int length	= outputName.find_first_of(".");						// the first period after the slash
+	outputName			= outputName.substr(0, length);						// the name to use to output the mod
+	int dash = outputName.find_first_of('-');
+	while (dash != std::string::npos)
+	{
+		outputName.replace(dash, 1, "_");
+		dash = outputName.find_first_of('-');
+	}
+	int space = outputName.find_first_of(' ');
+	while (space != std::string::npos)
+	{
+		outputName.replace(space, 1, "_");
+		space = outputName.find_first_of(' ');
+	}
+	Configuration::setOutputName(outputName);
+	LOG(LogLevel::Info) << "Using output name " << outputName;
+
+	LOG(LogLevel::Info) << "* Importing EU3 save *";
+
+	// A snapshot of the built world is keyed by the full contents of the save, so any edit to it forces a rebuild
+	StageTimer stage("Reading world snapshot");
+	const std::string worldSnapshotFile = outputName + ".eu3world.snapshot";
+	SnapshotKey worldSnapshotKey;
+	SnapshotReader worldSnapshot;
+	std::unique_ptr<EU3World> world;
+	if (Configuration::getWorldSnapshot())
+	{
+		worldSnapshotKey.addFileContents(EU3SaveFileName);
+		if (worldSnapshot.open(worldSnapshotFile, worldSnapshotKey))
+		{
+			LOG(LogLevel::Info) << "Reading world from " << worldSnapshotFile;
+			world.reset(EU3World::readSnapshot(worldSnapshot));
+			if (!world)
+			{
+				LOG(LogLevel::Warning) << worldSnapshotFile << " is damaged; parsing the save instead";
+				worldSnapshot.close();	// so the new snapshot can replace it
+			}
+		}
+	}
+
+	if (!world)
+	{
+		// the parsed save is only needed to build the world, so release it as soon as that is done
+		wiz::load_data::UserType obj;
+
+		// Parse EU3 Save
+		stage.next("Parsing save");
+		LOG(LogLevel::Info) << "Parsing save";
+
+		if (!wiz::load_data::LoadData::LoadDataFromFile3(EU3SaveFileName, obj, -1, 0))
+		{
+			LOG(LogLevel::Error) << "Could not parse file " << EU3SaveFileName;
+			exit(-1);
+		}
+
+		// Construct world from EU3 save.
+		stage.next("Building world");
+		LOG(LogLevel::Info) << "Building world";
+		world.reset(new EU3World(&obj));
+
+		if (Configuration::getWorldSnapshot())
+		{
+			SnapshotWriter newSnapshot;
+			world->writeSnapshot(newSnapshot);
+			newSnapshot.save(worldSnapshotFile, worldSnapshotKey);
+		}
+	}
+	EU3World& sourceWorld = *world;
+
+	// Read EU3 common\countries
+	stage.next("Reading EU3 common\\countries");
+	LOG(LogLevel::Info) << "Reading EU3 common\\countries";
+	{
+		std::ifstream commonCountries(Configuration::getEU3Path() + "\\common\\countries.txt");
+		sourceWorld.readCommonCountries(commonCountries, Configuration::getEU3Path());
+		if (!data.fullModPath.empty())
+		{
+			std::ifstream convertedCommonCountries(data.fullModPath + "\\common\\countries.txt");
+			sourceWorld.readCommonCountries(convertedCommonCountries, data.fullModPath);
+		}
+	}
+
+	// Figure out what EU3 gametype we're using
+	WorldType game = sourceWorld.getWorldType();
+	switch (game)
+	{
+		case VeryOld:
+			LOG(LogLevel::Error) << "EU3 game appears to be from an old version; only IN, HttT, and DW are supported.";
+			exit(1);
+		case InNomine:
+			LOG(LogLevel::Info) << "Game type is: EU3 In Nomine.  EXPERIMENTAL.";
+			break;
+		case HeirToTheThrone:
+			LOG(LogLevel::Info) << "Game type is: EU3 Heir to the Throne.";
+			break;
+		case DivineWind:
+			LOG(LogLevel::Info) << "Game type is: EU3 Divine Wind.";
+			break;
+		default:
+			LOG(LogLevel::Error) << "Error: Could not determine savegame type.";
+			exit(1);
+	}
+
+	sourceWorld.setLocalisations(data.localisation);
+
+	// Resolve unit types
+	stage.next("Resolving unit types");
+	LOG(LogLevel::Info) << "Resolving unit types.";
+	sourceWorld.resolveRegimentTypes(data.regimentTypes);
+
+
+	// Merge nations
+	stage.next("Merging nations");
+	LOG(LogLevel::Info) << "Merging nations.";
+	mergeNations(sourceWorld, &data.mergeNationsObj);
+
+
+	// Copy the V2 data
+	stage.next("Copying Vicky2 data");
+	LOG(LogLevel::Info) << "Copying Vicky2 data";
+	V2World destWorld(*data.baseWorld);
+
+
+	// Map provinces
+	stage.next("Mapping provinces");
+	LOG(LogLevel::Info) << "Mapping provinces";
+	provinceMapping			provinceMap;
+	inverseProvinceMapping	inverseProvinceMap;
+	resettableMap				resettableProvinces;
+	initProvinceMap(&data.provinceMappingsObj,  sourceWorld.getWorldType(), provinceMap, inverseProvinceMap, resettableProvinces);
+	sourceWorld.checkAllProvincesMapped(inverseProvinceMap);
+	sourceWorld.setEU3WorldProvinceMappings(inverseProvinceMap);
+
+
+	// Check cultures and religions
+	stage.next("Checking culture and religion mappings");
+	LOG(LogLevel::Info) << "Checking culture and religion mappings";
+	sourceWorld.checkAllEU3CulturesMapped(data.cultureRules, data.inverseUnionCultures);
+	sourceWorld.checkAllEU3ReligionsMapped(data.religionMap);
+
 	// Create Country Mapping
+	stage.next("Creating country mapping");
 	removeEmptyNations(sourceWorld);
 	if (Configuration::getRemovetype() == "dead")
 	{
@@ -543,35 +688,50 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 	{
 		removeLandlessNations(sourceWorld);
 	}
+	CountryMapping countryMap = data.countryRules;
+	std::map<int, int> leaderIDMap; // <EU3, V2>
 	countryMap.CreateMapping(sourceWorld, destWorld);
 
 
 	// Convert
+	stage.next("Converting countries");
 	LOG(LogLevel::Info) << "Converting countries";
-	destWorld.convertCountries(sourceWorld, countryMap, cultureMap, unionCultures, religionMap, governmentMap, inverseProvinceMap, techSchools, leaderIDMap, lt, EU3RegionsMap);
+	destWorld.convertCountries(sourceWorld, countryMap, data.cultureRules, data.unionCultures, data.religionMap, data.governmentMap, inverseProvinceMap, data.techSchools, leaderIDMap, *data.leaderTraits);
 	destWorld.scalePrestige();
+	stage.next("Converting provinces");
 	LOG(LogLevel::Info) << "Converting provinces";
-	destWorld.convertProvinces(sourceWorld, provinceMap, resettableProvinces, countryMap, cultureMap, slaveCultureMap, religionMap, stateIndexMap, EU3RegionsMap);
+	destWorld.convertProvinces(sourceWorld, provinceMap, resettableProvinces, countryMap, *data.demographicCache, data.stateIndexMap);
+	data.demographicCache->logStatistics();
+	stage.next("Converting diplomacy");
 	LOG(LogLevel::Info) << "Converting diplomacy";
 	destWorld.convertDiplomacy(sourceWorld, countryMap);
+	stage.next("Setting colonies");
 	LOG(LogLevel::Info) << "Setting colonies";
-	destWorld.setupColonies(adjacencyMap, continentMap);
+	destWorld.setupColonies(data.adjacencyMap, data.continentMap);
+	stage.next("Creating states");
 	LOG(LogLevel::Info) << "Creating states";
-	destWorld.setupStates(stateMap);
+	destWorld.setupStates(data.stateMap);
+	stage.next("Setting unciv reforms");
 	LOG(LogLevel::Info) << "Setting unciv reforms";
 	destWorld.convertUncivReforms();
+	stage.next("Converting techs");
 	LOG(LogLevel::Info) << "Converting techs";
 	destWorld.convertTechs(sourceWorld);
+	stage.next("Allocating starting factories");
 	LOG(LogLevel::Info) << "Allocating starting factories";
-	destWorld.allocateFactories(sourceWorld, factoryBuilder);
+	destWorld.allocateFactories(sourceWorld, *data.factoryBuilder);
+	stage.next("Creating pops");
 	LOG(LogLevel::Info) << "Creating pops";
 	destWorld.setupPops(sourceWorld);
+	stage.next("Adding unions");
 	LOG(LogLevel::Info) << "Adding unions";
-	destWorld.addUnions(unionMap);
+	destWorld.addUnions(data.unionMap);
+	stage.next("Converting armies and navies");
 	LOG(LogLevel::Info) << "Converting armies and navies";
-	destWorld.convertArmies(sourceWorld, inverseProvinceMap, leaderIDMap, adjacencyMap);
+	destWorld.convertArmies(sourceWorld, inverseProvinceMap, leaderIDMap, data.adjacencyMap);
 
 	// Output results
+	stage.next("Outputting mod");
 	LOG(LogLevel::Info) << "Outputting mod";
 	system("%systemroot%\\System32\\xcopy blankMod output /E /Q /Y /I");
 	FILE* modFile;
@@ -599,12 +759,126 @@ int ConvertEU3ToV2(const std::string& EU3SaveFileName)
 	std::string renameCommand = "move /Y output\\output output\\" + Configuration::getOutputName();
 	system(renameCommand.c_str());
 	destWorld.output();
+	stage.stop();
 
 	LOG(LogLevel::Info) << "* Conversion complete *";
 	return 0;
 }
 
 
+// Writes the diagnostics and stage timings collected since the last clear, prefixing the files with the given name.
+static void WriteReports(const std::string& prefix)
+{
+	Diagnostics::writeSummary(prefix + "diagnostics.json");
+	StageTimings::writeSummary();
+	if (Configuration::getStageTrace())
+	{
+		StageTimings::writeTrace(prefix + "stage_trace.json");
+	}
+}
+
+
+int ConvertEU3ToV2(const std::string& EU3SaveFileName)
+{
+	StageTimer conversionTimer("Conversion");
+
+	conversionData data;
+	int result = LoadConversionData(data);
+	if (result == 0)
+	{
+		result = ConvertSave(EU3SaveFileName, data);
+	}
+	conversionTimer.stop();
+
+	WriteReports("");
+	return result;
+}
+
+
+int ConvertEU3ToV2Batch(const std::string& batchSource)
+{
+	std::vector<std::string> saveFileNames;
+	struct _stat st;
+	if ((_stat(batchSource.c_str(), &st) == 0) && (st.st_mode & _S_IFDIR))
+	{
+		std::set<std::string> fileNames;
+		WinUtils::GetAllFilesInFolder(batchSource, fileNames);
+		for (std::set<std::string>::iterator itr = fileNames.begin(); itr != fileNames.end(); ++itr)
+		{
+			saveFileNames.push_back(batchSource + "\\" + *itr);
+		}
+	}
+	else
+	{
+		std::ifstream saveList(batchSource);
+		if (!saveList.is_open())
+		{
+			LOG(LogLevel::Error) << "Could not open batch list " << batchSource;
+			return -1;
+		}
+		std::string line;
+		while (std::getline(saveList, line))
+		{
+			if (!line.empty() && (line[line.size() - 1] == '\r'))
+			{
+				line.erase(line.size() - 1);
+			}
+			if (!line.empty())
+			{
+				saveFileNames.push_back(line);
+			}
+		}
+	}
+	if (saveFileNames.empty())
+	{
+		LOG(LogLevel::Error) << "No saves found in " << batchSource;
+		return -1;
+	}
+
+	StageTimer loadTimer("Loading conversion data");
+	conversionData data;
+	int result = LoadConversionData(data);
+	loadTimer.stop();
+	WriteReports("Output\\batch_");
+	if (result != 0)
+	{
+		return result;
+	}
+
+	int failures = 0;
+	for (std::vector<std::string>::iterator itr = saveFileNames.begin(); itr != saveFileNames.end(); ++itr)
+	{
+		LOG(LogLevel::Info) << "* Batch conversion of " << *itr << " *";
+		Diagnostics::clear();
+		StageTimings::clear();
+
+		StageTimer conversionTimer("Conversion");
+		int saveResult;
+		try
+		{
+			saveResult = ConvertSave(*itr, data);
+		}
+		catch (const std::exception& e)
+		{
+			LOG(LogLevel::Error) << e.what();
+			saveResult = -1;
+		}
+		conversionTimer.stop();
+
+		WriteReports("Output\\" + Configuration::getOutputName() + "_");
+		if (saveResult != 0)
+		{
+			LOG(LogLevel::Error) << "Could not convert " << *itr;
+			++failures;
+		}
+	}
+
+	LOG(LogLevel::Info) << "* Batch complete: " << (saveFileNames.size() - failures) << " of " << saveFileNames.size() << " saves converted *";
+	return (failures == 0) ? 0 : 1;
+}
+
+
+#ifndef EU3V2_BENCHMARK
 int main(int argc, char * argv[])
 {
 	try
@@ -613,6 +887,12 @@ int main(int argc, char * argv[])
 		wiz::USE_EMPTY_VECTOR_IN_LOAD_DATA_TYPES = true;
 
 		LOG(LogLevel::Info) << "Converter version 3.0";
+		if ((argc >= 3) && (strcmp(argv[1], "--batch") == 0))
+		{
+			LOG(LogLevel::Info) << "Using batch input " << argv[2];
+			return ConvertEU3ToV2Batch(argv[2]);
+		}
+
 		const char* const defaultEU3SaveFileName = "input.eu3";
 		std::string EU3SaveFileName;
 		if (argc >= 2)
@@ -640,4 +920,5 @@ int main(int argc, char * argv[])
 		LOG(LogLevel::Error) << e;
 		return -1;
 	}
-}
\ No newline at end of file
+}
+#endif // EU3V2_BENCHMARK
\ No newline at end of file
@@ -0,0 +1,37 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef EU3TOV2CONVERTER_H_
+#define EU3TOV2CONVERTER_H_
+
+#include <string>
+
+// Converts the given EU3 save into a V2 mod.
+// Returns 0 on success or a non-zero failure code on error.
+int ConvertEU3ToV2(const std::string& EU3SaveFileName);
+
+// Converts every save in the given folder, or listed one per line in the given file, loading
+// the game data only once.  Each save's reports are written to Output with the save's name.
+// Returns 0 when every save converted or a non-zero failure code otherwise.
+int ConvertEU3ToV2Batch(const std::string& batchSource);
+
+#endif // EU3TOV2CONVERTER_H_
@@ -0,0 +1,258 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef FIELDTABLE_H_
+#define FIELDTABLE_H_
+
+
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CountryTag.h"
+#include "Date.h"
+#include "Symbol.h"
+
+#include "wiz/load_data_types.h"
+
+
+
+// The items and children a FieldTable collected from one object, by key, in the order they appear
+class fieldMatches
+{
+	public:
+		typedef std::vector<const wiz::load_data::ItemType<wiz::DataType>*>	itemList;
+		typedef std::vector<wiz::load_data::UserType*>							userTypeList;
+
+		fieldMatches(const std::unordered_map<std::string, size_t>* _slots) : slots(_slots), items(_slots->size()), userTypes(_slots->size()) {}
+
+		// the first matching item, or nullptr; the equivalent of GetItem(key)[0]
+		const wiz::load_data::ItemType<wiz::DataType>* getItem(const std::string& key) const
+		{
+			const itemList& found = getItems(key);
+			return found.empty() ? nullptr : found[0];
+		}
+		const itemList& getItems(const std::string& key) const
+		{
+			static const itemList none;
+			std::unordered_map<std::string, size_t>::const_iterator itr = slots->find(key);
+			return (itr == slots->end()) ? none : items[itr->second];
+		}
+		const userTypeList& getUserTypes(const std::string& key) const
+		{
+			static const userTypeList none;
+			std::unordered_map<std::string, size_t>::const_iterator itr = slots->find(key);
+			return (itr == slots->end()) ? none : userTypes[itr->second];
+		}
+
+	private:
+		template<class T> friend class FieldTable;
+
+		const std::unordered_map<std::string, size_t>*	slots;
+		std::vector<itemList>									items;
+		std::vector<userTypeList>								userTypes;
+};
+
+
+// Binds the keys of a parsed object to the members of a class once, so that an object is read
+// in a single pass over its items and children instead of one GetItem() scan per key.
+// The table is built once per class, e.g.
+//		static const FieldTable<EU3Army> fields = FieldTable<EU3Army>()
+//			.field("name", &EU3Army::name)
+//			.field("location", &EU3Army::location)
+//			.collect("regiment");
+//		fieldMatches found = fields.apply(obj, *this);
+// Bindings only run for keys that are present, so members need their defaults set beforehand.
+// Like GetItem(key)[0], single-valued bindings take the first occurrence of their key;
+// repeated bindings run for every occurrence, in the order they appear in the object.
+template<class T>
+class FieldTable
+{
+	public:
+		typedef std::function<void(T&, const wiz::load_data::ItemType<wiz::DataType>&)>	itemHandler;
+		typedef std::function<void(T&, wiz::load_data::UserType*)>							userTypeHandler;
+
+		// custom handlers
+		FieldTable&	item(const std::string& key, const itemHandler& handler, bool repeated = false)
+		{
+			binding& bound		= bind(key);
+			bound.onItem		= handler;
+			bound.itemRepeated	= repeated;
+			return *this;
+		}
+		FieldTable&	userType(const std::string& key, const userTypeHandler& handler, bool repeated = false)
+		{
+			binding& bound				= bind(key);
+			bound.onUserType			= handler;
+			bound.userTypeRepeated	= repeated;
+			return *this;
+		}
+		// runs for every child whose key has no binding of its own
+		FieldTable&	otherUserTypes(const userTypeHandler& handler)
+		{
+			onOtherUserType = handler;
+			return *this;
+		}
+		// keeps every item and child with this key in the fieldMatches, for the caller to read afterwards
+		FieldTable&	collect(const std::string& key)
+		{
+			binding& bound = bind(key);
+			if (bound.slot == noSlot)
+			{
+				bound.slot = slots.size();
+				slots.insert(std::make_pair(key, bound.slot));
+			}
+			return *this;
+		}
+
+		// members read directly from the first occurrence of a key
+		FieldTable&	field(const std::string& key, std::string T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = value.Get(0).ToString(); });
+		}
+		FieldTable&	field(const std::string& key, Symbol T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = value.Get(0).ToString(); });
+		}
+		FieldTable&	field(const std::string& key, CountryTag T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = value.Get(0).ToString(); });
+		}
+		FieldTable&	field(const std::string& key, int T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = static_cast<int>(value.Get(0).ToInt()); });
+		}
+		FieldTable&	field(const std::string& key, double T::* member, double scale = 1.0)
+		{
+			return item(key, [member, scale](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = scale * value.Get(0).ToFloat(); });
+		}
+		FieldTable&	field(const std::string& key, date T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = date(value.Get(0).ToString()); });
+		}
+		// true for "yes"
+		FieldTable&	field(const std::string& key, bool T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { object.*member = (value.Get(0).ToString() == "yes"); });
+		}
+		// every occurrence of a key, appended in order
+		FieldTable&	list(const std::string& key, std::vector<std::string> T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { (object.*member).push_back(value.Get(0).ToString()); }, true);
+		}
+		FieldTable&	list(const std::string& key, std::vector<Symbol> T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { (object.*member).push_back(value.Get(0).ToString()); }, true);
+		}
+		FieldTable&	list(const std::string& key, std::vector<CountryTag> T::* member)
+		{
+			return item(key, [member](T& object, const wiz::load_data::ItemType<wiz::DataType>& value) { (object.*member).push_back(value.Get(0).ToString()); }, true);
+		}
+
+		fieldMatches apply(const wiz::load_data::UserType* obj, T& object) const
+		{
+			fieldMatches found(&slots);
+			std::vector<bool> seenItem(bindings.size(), false);
+			std::vector<bool> seenUserType(bindings.size(), false);
+
+			for (long long i = 0; i < obj->GetItemListSize(); ++i)
+			{
+				const wiz::load_data::ItemType<wiz::DataType>& value = obj->GetItemList(i);
+				std::unordered_map<std::string, size_t>::const_iterator itr = index.find(value.GetName().ToString());
+				if (itr == index.end())
+				{
+					continue;
+				}
+				const binding& bound = bindings[itr->second];
+				if (bound.onItem && (bound.itemRepeated || !seenItem[itr->second]))
+				{
+					seenItem[itr->second] = true;
+					bound.onItem(object, value);
+				}
+				if (bound.slot != noSlot)
+				{
+					found.items[bound.slot].push_back(&value);
+				}
+			}
+
+			for (long long i = 0; i < obj->GetUserTypeListSize(); ++i)
+			{
+				wiz::load_data::UserType* child = obj->GetUserTypeList(i);
+				std::unordered_map<std::string, size_t>::const_iterator itr = index.find(child->GetName().ToString());
+				if (itr == index.end())
+				{
+					if (onOtherUserType)
+					{
+						onOtherUserType(object, child);
+					}
+					continue;
+				}
+				const binding& bound = bindings[itr->second];
+				if (bound.onUserType && (bound.userTypeRepeated || !seenUserType[itr->second]))
+				{
+					seenUserType[itr->second] = true;
+					bound.onUserType(object, child);
+				}
+				if (bound.slot != noSlot)
+				{
+					found.userTypes[bound.slot].push_back(child);
+				}
+			}
+
+			return found;
+		}
+
+	private:
+		static const size_t noSlot = static_cast<size_t>(-1);
+
+		struct binding
+		{
+			binding() : itemRepeated(false), userTypeRepeated(false), slot(noSlot) {}
+
+			itemHandler			onItem;
+			bool					itemRepeated;
+			userTypeHandler	onUserType;
+			bool					userTypeRepeated;
+			size_t				slot;			// where collect() keeps matches, or noSlot
+		};
+
+		binding& bind(const std::string& key)
+		{
+			std::unordered_map<std::string, size_t>::iterator itr = index.find(key);
+			if (itr == index.end())
+			{
+				itr = index.insert(std::make_pair(key, bindings.size())).first;
+				bindings.push_back(binding());
+			}
+			return bindings[itr->second];
+		}
+
+		std::vector<binding>							bindings;
+		std::unordered_map<std::string, size_t>	index;		// key -> bindings
+		std::unordered_map<std::string, size_t>	slots;		// collected key -> fieldMatches lists
+		userTypeHandler								onOtherUserType;
+};
+
+
+
+#endif // FIELDTABLE_H_
@@ -22,29 +22,294 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "Log.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <Windows.h>
 
-Log::Log(LogLevel level)
-: logLevel(level)
+
+// A message waiting to be written by the background thread
+struct LogRecord
+{
+	std::atomic<LogRecord*>	next;
+	LogLevel						level;
+	time_t						time;
+	std::string					message;
+};
+
+
+// Owns log.txt and the thread that writes to it.  Producers push onto an intrusive
+// multi-producer/single-consumer queue (Vyukov) without taking a lock; the writer drains
+// it into a single large-buffered stream and only flushes to disk when asked to.
+class LogWriter
+{
+	public:
+		static LogWriter*	getInstance();
+
+		void	push(LogRecord* record);
+		void	flush();
+
+	private:
+		LogWriter();
+		static void	shutdown();
+
+		void			run();
+		void			link(LogRecord* record);
+		LogRecord*	pop();
+		void			write(const LogRecord* record);
+
+		std::atomic<LogRecord*>	head;					// last record pushed; producers swap themselves in here
+		LogRecord*					tail;					// next record to write; only touched by the writer thread
+		LogRecord					stub;
+
+		std::ofstream				logFile;
+		std::vector<char>			fileBuffer;
+		time_t						cachedTime;			// the second timeStamp was formatted for
+		char							timeStamp[64];
+
+		std::atomic<unsigned long long>	pushed;		// records fully linked into the queue
+		unsigned long long					written;		// records written by the writer thread
+		unsigned long long					flushed;		// records known to be on disk
+
+		std::mutex						wakeMutex;
+		std::condition_variable		wakeSignal;
+		std::condition_variable		flushedSignal;
+		bool								flushRequested;
+		bool								running;
+		std::thread						writer;
+
+		static std::atomic<bool>	closed;
+};
+
+
+std::atomic<bool> LogWriter::closed(false);
+
+
+LogWriter* LogWriter::getInstance()
+{
+	static LogWriter* instance = new LogWriter();
+	if (closed.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	return instance;
+}
+
+
+LogWriter::LogWriter()
+: head(&stub), tail(&stub), fileBuffer(1 << 20), cachedTime(-1), pushed(0), written(0), flushed(0), flushRequested(false), running(true)
+{
+	stub.next.store(nullptr, std::memory_order_relaxed);
+	timeStamp[0] = '\0';
+
+	logFile.rdbuf()->pubsetbuf(fileBuffer.data(), fileBuffer.size());
+	logFile.open("log.txt", std::ofstream::trunc);
+
+	writer = std::thread(&LogWriter::run, this);
+	atexit(&LogWriter::shutdown);
+}
+
+
+void LogWriter::shutdown()
+{
+	LogWriter* instance = getInstance();
+	if (instance == nullptr)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(instance->wakeMutex);
+		instance->running = false;
+	}
+	instance->wakeSignal.notify_one();
+	instance->writer.join();
+	instance->logFile.close();
+
+	// anything logged from here on is written directly
+	closed.store(true, std::memory_order_release);
+}
+
+
+void LogWriter::push(LogRecord* record)
+{
+	link(record);
+	pushed.fetch_add(1, std::memory_order_release);
+}
+
+
+void LogWriter::link(LogRecord* record)
+{
+	record->next.store(nullptr, std::memory_order_relaxed);
+	LogRecord* prev = head.exchange(record, std::memory_order_acq_rel);
+	prev->next.store(record, std::memory_order_release);
+}
+
+
+LogRecord* LogWriter::pop()
+{
+	LogRecord* first	= tail;
+	LogRecord* next	= first->next.load(std::memory_order_acquire);
+	if (first == &stub)
+	{
+		if (next == nullptr)
+		{
+			return nullptr;
+		}
+		tail	= next;
+		first	= next;
+		next	= next->next.load(std::memory_order_acquire);
+	}
+	if (next != nullptr)
+	{
+		tail = next;
+		return first;
+	}
+
+	// first is the last record; if a producer is mid-push, pick it up on the next pass
+	if (first != head.load(std::memory_order_acquire))
+	{
+		return nullptr;
+	}
+	link(&stub);
+	next = first->next.load(std::memory_order_acquire);
+	if (next != nullptr)
+	{
+		tail = next;
+		return first;
+	}
+	return nullptr;
+}
+
+
+void LogWriter::flush()
+{
+	unsigned long long target = pushed.load(std::memory_order_acquire);
+
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	while (running && (flushed < target))
+	{
+		flushRequested = true;
+		wakeSignal.notify_one();
+		flushedSignal.wait_for(lock, std::chrono::milliseconds(50));
+	}
+}
+
+
+void LogWriter::run()
+{
+	std::unique_lock<std::mutex> lock(wakeMutex);
+	while (true)
+	{
+		bool flushNow	= flushRequested || !running;
+		bool stopping	= !running;
+		flushRequested	= false;
+		lock.unlock();
+
+		LogRecord* record;
+		while ((record = pop()) != nullptr)
+		{
+			write(record);
+			delete record;
+			++written;
+		}
+		if (flushNow)
+		{
+			logFile.flush();
+		}
+
+		lock.lock();
+		if (flushNow)
+		{
+			flushed = written;
+			flushedSignal.notify_all();
+		}
+		if (stopping)
+		{
+			break;
+		}
+		wakeSignal.wait_for(lock, std::chrono::milliseconds(100), [this] { return flushRequested || !running; });
+	}
+}
+
+
+void LogWriter::write(const LogRecord* record)
 {
-	static bool logFileCreated = false;
-	if (!logFileCreated)
+	// formatting the time is far more expensive than reading it, so only redo it when the second changes
+	if (record->time != cachedTime)
 	{
-		std::ofstream logFile("log.txt", std::ofstream::trunc);
-		logFileCreated = true;
+		cachedTime = record->time;
+		tm timeInfo;
+		if ((localtime_s(&timeInfo, &cachedTime) != 0) || (strftime(timeStamp, sizeof(timeStamp), "%Y-%m-%d %H:%M:%S ", &timeInfo) == 0))
+		{
+			timeStamp[0] = '\0';
+		}
 	}
+
+	Log::WriteToConsole(record->level, record->message);
+	Log::WriteToFile(logFile, record->level, timeStamp, record->message);
+}
+
+
+LogLevel Log::minLevel = LogLevel::Debug;
+
+
+Log::Log(LogLevel level)
+: logLevel(level)
+{
 }
 
 Log::~Log()
 {
+	if (!IsEnabled(logLevel))
+	{	// Only reachable when a Log is built directly rather than through LOG().
+		return;
+	}
 	logMessageStream << std::endl;
-	std::string logMessage = logMessageStream.str();
-	WriteToConsole(logLevel, logMessage);
-	WriteToFile(logLevel, logMessage);
+
+	LogRecord* record	= new LogRecord;
+	record->level		= logLevel;
+	record->time		= time(nullptr);
+	record->message	= logMessageStream.str();
+
+	LogWriter* writer = LogWriter::getInstance();
+	if (writer == nullptr)
+	{	// The writer has already shut down during exit; write synchronously.
+		char timeBuffer[64] = "";
+		tm timeInfo;
+		if (localtime_s(&timeInfo, &record->time) == 0)
+		{
+			strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S ", &timeInfo);
+		}
+		std::ofstream logFile("log.txt", std::ofstream::app);
+		WriteToConsole(record->level, record->message);
+		WriteToFile(logFile, record->level, timeBuffer, record->message);
+		delete record;
+		return;
+	}
+
+	writer->push(record);
+	if (logLevel == LogLevel::Error)
+	{	// Errors are usually followed by exit(), so make sure they are on disk first.
+		writer->flush();
+	}
+}
+
+void Log::Flush()
+{
+	LogWriter* writer = LogWriter::getInstance();
+	if (writer != nullptr)
+	{
+		writer->flush();
+	}
 }
 
 void Log::WriteToConsole(LogLevel level, const std::string& logMessage)
@@ -94,23 +359,9 @@ void Log::WriteToConsole(LogLevel level, const std::string& logMessage)
 	std::cout << logMessage;
 }
 
-void Log::WriteToFile(LogLevel level, const std::string& logMessage)
+void Log::WriteToFile(std::ostream& logFile, LogLevel level, const char* timeStamp, const std::string& logMessage)
 {
-	std::ofstream logFile("log.txt", std::ofstream::app);
-
-	time_t rawtime;
-	time(&rawtime);
-	tm timeInfo;
-	errno_t error = localtime_s(&timeInfo, &rawtime);
-	if (error == 0)
-	{
-		char timeBuffer[64];
-		size_t bytesWritten = strftime(timeBuffer, 64, "%Y-%m-%d %H:%M:%S ", &timeInfo);
-		if (bytesWritten != 0)
-		{
-			logFile << timeBuffer;
-		}
-	}
+	logFile << timeStamp;
 
 	switch (level)
 	{
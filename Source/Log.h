@@ -26,7 +26,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <sstream>
 #include <string>
 
-#define LOG(LOG_LEVEL) Log(LOG_LEVEL)
+// The least severe level that is compiled in at all (0 = Error, 1 = Warning, 2 = Info, 3 = Debug).
+// Build with -DEU3V2_MIN_LOG_LEVEL=2 to strip every Debug message out of the binary.
+#ifndef EU3V2_MIN_LOG_LEVEL
+#define EU3V2_MIN_LOG_LEVEL 3
+#endif
+
+// Messages below the configured level cost a single branch; the stream is never built
+#define LOG(LOG_LEVEL) if (!Log::IsEnabled(LOG_LEVEL)) ; else Log(LOG_LEVEL)
 
 enum class LogLevel
 {
@@ -49,9 +56,22 @@ public:
 		return *this;
 	}
 
+	// blocks until every message logged so far has reached the console and log.txt
+	static void Flush();
+
+	static bool IsEnabled(LogLevel level)
+	{
+		return (static_cast<int>(level) <= EU3V2_MIN_LOG_LEVEL) && (level <= minLevel);
+	}
+	static void SetMinLevel(LogLevel level)	{ minLevel = level; }
+
 private:
+	friend class LogWriter;
+
 	static void WriteToConsole(LogLevel, const std::string& logMessage);
-	static void WriteToFile(LogLevel, const std::string& logMessage);
+	static void WriteToFile(std::ostream& logFile, LogLevel, const char* timeStamp, const std::string& logMessage);
+
+	static LogLevel minLevel;	// the least severe level written at runtime, from configuration.txt
 
 	LogLevel logLevel;
 	std::ostringstream logMessageStream;
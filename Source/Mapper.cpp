@@ -25,12 +25,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "Mapper.h"
 #include "Log.h"
 #include "Configuration.h"
+#include "Snapshot.h"
 #include "EU3World/EU3World.h"
 #include "EU3World/EU3Country.h"
 #include "EU3World/EU3Province.h"
 #include "V2World/V2World.h"
 #include "V2World/V2Country.h"
 #include <algorithm>
+#include <new>
+#include <stdexcept>
 #include <sys/stat.h>
 
 
@@ -78,7 +81,7 @@ void initProvinceMap(const wiz::load_data::UserType* obj, WorldType worldType, p
 			case VeryOld:
 			default:
 			{
-				Log(LogLevel::Error) << "Unsupported world type. Cannot map provinces!";
+				LOG(LogLevel::Error) << "Unsupported world type. Cannot map provinces!";
 				exit(-1);
 			}
 		}
@@ -189,9 +192,8 @@ typedef struct {
 	int unknown1;		// still unknown
 	int unknown2;		// still unknown
 } VanillaAdjacency;	// an entry in the vanilla adjacencies.bin format
-adjacencyMapping initAdjacencyMap()
+AdjacencyGraph initAdjacencyMap()
 {
-	FILE* adjacenciesBin = nullptr;
 	std::string filename = Configuration::getV2DocumentsPath() + "\\map\\cache\\adjacencies.bin";
 	struct _stat st;
 	if ((_stat(filename.c_str(), &st) != 0))
@@ -199,53 +201,36 @@ adjacencyMapping initAdjacencyMap()
 		LOG(LogLevel::Warning) << "Could not find " << filename << " - looking in install folder";
 		filename = Configuration::getV2Path() + "\\map\\cache\\adjacencies.bin";
 	}
-	fopen_s(&adjacenciesBin, filename.c_str(), "rb");
-	if (adjacenciesBin == nullptr)
+
+	// the record layout depends on the game, so it is picked once for the whole file
+	size_t recordSize = 0;
+	switch (Configuration::getV2Gametype())
 	{
-		LOG(LogLevel::Error) << "Could not open " << filename;
-		exit(1);
+		case V2Vanilla:
+			recordSize = sizeof(VanillaAdjacency);
+			break;
+		case V2AHD:
+			recordSize = sizeof(AHDAdjacency);
+			break;
+		case V2HOD:
+		case V2HODNNM:
+			recordSize = sizeof(HODAdjacency);
+			break;
 	}
 
-	adjacencyMapping adjacencyMap;
-	while (!feof(adjacenciesBin))
+	AdjacencyGraph adjacencyMap;
+	if (!adjacencyMap.readFile(filename, recordSize))
 	{
-		int numAdjacencies;
-		if (fread(&numAdjacencies, sizeof(numAdjacencies), 1, adjacenciesBin) != 1)
-		{
-			break;
-		}
-		std::vector<int> adjacencies;	// the adjacencies for the current province
-		for (int i = 0; i < numAdjacencies; i++)
-		{
-			if (Configuration::getV2Gametype() == "vanilla")
-			{
-				VanillaAdjacency readAdjacency;
-				fread(&readAdjacency, sizeof(readAdjacency), 1, adjacenciesBin);
-				adjacencies.push_back(readAdjacency.to);
-			}
-			else if (Configuration::getV2Gametype() == "AHD")
-			{
-				AHDAdjacency readAdjacency;
-				fread(&readAdjacency, sizeof(readAdjacency), 1, adjacenciesBin);
-				adjacencies.push_back(readAdjacency.to);
-			}
-			if ((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM"))
-			{
-				HODAdjacency readAdjacency;
-				fread(&readAdjacency, sizeof(readAdjacency), 1, adjacenciesBin);
-				adjacencies.push_back(readAdjacency.to);
-			}
-		}
-		adjacencyMap.push_back(adjacencies);
+		LOG(LogLevel::Error) << "Could not open " << filename;
+		exit(1);
 	}
-	fclose(adjacenciesBin);
 
 	/*FILE* adjacenciesData;
 	fopen_s(&adjacenciesData, "adjacenciesData.csv", "w");
 	fprintf(adjacenciesData, "From,To\n");
 	for (unsigned int from = 0; from < adjacencyMap.size(); from++)
 	{
-		std::vector<int> adjacencies = adjacencyMap[from];
+		AdjacencySpan adjacencies = adjacencyMap.neighbors(from);
 		for (unsigned int i = 0; i < adjacencies.size(); i++)
 		{
 			fprintf(adjacenciesData, "%d,%d\n", from, adjacencies[i]);
@@ -296,8 +281,8 @@ void mergeNations(EU3World& world, const wiz::load_data::UserType *mergeObj)
 
 	for (int i=0; i < rules[0]->GetUserTypeListSize(); ++i)
 	{
-		std::string masterTag;
-		std::vector<std::string> slaveTags;
+		CountryTag masterTag;
+		std::vector<CountryTag> slaveTags;
 		bool enabled = false;
 		for (int j=0; j < rules[0]->GetUserTypeList(i)->GetItemListSize(); ++j)
 		{
@@ -319,7 +304,7 @@ void mergeNations(EU3World& world, const wiz::load_data::UserType *mergeObj)
 		EU3Country* master = world.getCountry(masterTag);
 		if ( enabled && (master != nullptr) && (slaveTags.size() > 0) )
 		{
-			for (std::vector<std::string>::iterator sitr = slaveTags.begin(); sitr != slaveTags.end(); ++sitr)
+			for (std::vector<CountryTag>::iterator sitr = slaveTags.begin(); sitr != slaveTags.end(); ++sitr)
 			{
 				master->eatCountry(world.getCountry(*sitr));
 			}
@@ -340,8 +325,8 @@ void uniteJapan(EU3World& world)
 		return;
 	}
 
-	std::map<std::string, EU3Country*> countries = world.getCountries();
-	for (std::map<std::string, EU3Country*>::iterator i = countries.begin(); i != countries.end(); ++i)
+	const std::map<CountryTag, EU3Country*>& countries = world.getCountries();
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
 	{
 		if ( i->second->getPossibleDaimyo() )
 		{
@@ -353,40 +338,44 @@ void uniteJapan(EU3World& world)
 
 void removeEmptyNations(EU3World& world)
 {
-	std::map<std::string, EU3Country*> countries = world.getCountries();
-	for (std::map<std::string, EU3Country*>::iterator i = countries.begin(); i != countries.end(); ++i)
+	// removing a country would invalidate the iterator, so the tags are gathered first
+	std::vector<CountryTag> emptyNations;
+	const std::map<CountryTag, EU3Country*>& countries = world.getCountries();
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
 	{
-		std::vector<EU3Province*> provinces	= i->second->getProvinces();
-		std::vector<EU3Province*> cores			= i->second->getCores();
-		if ( (provinces.size()) == 0 && (cores.size() == 0) )
+		if ( (i->second->getProvinces().size() == 0) && (i->second->getCores().size() == 0) )
 		{
-			world.removeCountry(i->first);
-			LOG(LogLevel::Debug) << "Removing empty nation " << i->first;
+			emptyNations.push_back(i->first);
 		}
 	}
+
+	for (std::vector<CountryTag>::iterator i = emptyNations.begin(); i != emptyNations.end(); ++i)
+	{
+		world.removeCountry(*i);
+		LOG(LogLevel::Debug) << "Removing empty nation " << *i;
+	}
 }
 
 
 void removeDeadLandlessNations(EU3World& world)
 {
-	std::map<std::string, EU3Country*> allCountries = world.getCountries();
+	const std::map<CountryTag, EU3Country*>& allCountries = world.getCountries();
 
-	std::map<std::string, EU3Country*> landlessCountries;
-	for (std::map<std::string, EU3Country*>::iterator i = allCountries.begin(); i != allCountries.end(); ++i)
+	std::map<CountryTag, EU3Country*> landlessCountries;
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = allCountries.begin(); i != allCountries.end(); ++i)
 	{
-		std::vector<EU3Province*> provinces = i->second->getProvinces();
-		if (provinces.size() == 0)
+		if (i->second->getProvinces().size() == 0)
 		{
 			landlessCountries.insert(*i);
 		}
 	}
 
-	for (std::map<std::string, EU3Country*>::iterator countryItr = landlessCountries.begin(); countryItr != landlessCountries.end(); ++countryItr)
+	for (std::map<CountryTag, EU3Country*>::iterator countryItr = landlessCountries.begin(); countryItr != landlessCountries.end(); ++countryItr)
 	{
-		std::string primaryCulture		= countryItr->second->getPrimaryCulture();
-		std::vector<EU3Province*> cores	= countryItr->second->getCores();
+		Symbol primaryCulture			= countryItr->second->getPrimaryCulture();
+		const std::vector<EU3Province*>& cores	= countryItr->second->getCores();
 		bool cultureSurvives			= false;
-		for (std::vector<EU3Province*>::iterator coreItr = cores.begin(); coreItr != cores.end(); ++coreItr)
+		for (std::vector<EU3Province*>::const_iterator coreItr = cores.begin(); coreItr != cores.end(); ++coreItr)
 		{
 			if ( (*coreItr)->getOwner() == nullptr)
 			{
@@ -397,9 +386,9 @@ void removeDeadLandlessNations(EU3World& world)
 				continue;
 			}
 
-			std::vector<EU3PopRatio> popRatios = (*coreItr)->getPopRatios();
+			const std::vector<EU3PopRatio>& popRatios = (*coreItr)->getPopRatios();
 			double culturePercent = 0.0f;
-			for (std::vector<EU3PopRatio>::iterator popItr = popRatios.begin(); popItr != popRatios.end(); ++popItr)
+			for (std::vector<EU3PopRatio>::const_iterator popItr = popRatios.begin(); popItr != popRatios.end(); ++popItr)
 			{
 				if (popItr->culture == primaryCulture)
 				{
@@ -424,17 +413,22 @@ void removeDeadLandlessNations(EU3World& world)
 
 void removeLandlessNations(EU3World& world)
 {
-	std::map<std::string, EU3Country*> countries = world.getCountries();
-
-	for (std::map<std::string, EU3Country*>::iterator i = countries.begin(); i != countries.end(); ++i)
+	// removing a country would invalidate the iterator, so the tags are gathered first
+	std::vector<CountryTag> landlessNations;
+	const std::map<CountryTag, EU3Country*>& countries = world.getCountries();
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
 	{
-		std::vector<EU3Province*> provinces = i->second->getProvinces();
-		if (provinces.empty())
+		if (i->second->getProvinces().empty())
 		{
-			world.removeCountry(i->first);
-			LOG(LogLevel::Debug) << "Removing landless nation " << i->first;
+			landlessNations.push_back(i->first);
 		}
 	}
+
+	for (std::vector<CountryTag>::iterator i = landlessNations.begin(); i != landlessNations.end(); ++i)
+	{
+		world.removeCountry(*i);
+		LOG(LogLevel::Debug) << "Removing landless nation " << *i;
+	}
 }
 
 
@@ -458,14 +452,76 @@ void initStateMap(const wiz::load_data::UserType* obj, stateMapping& stateMap, s
 }
 
 
+void writeStateMapSnapshot(SnapshotWriter& snapshot, const stateMapping& stateMap, const stateIndexMapping& stateIndexMap)
+{
+	snapshot.writeInt(stateMap.size());
+	for (stateMapping::const_iterator itr = stateMap.begin(); itr != stateMap.end(); ++itr)
+	{
+		snapshot.writeInt(itr->first);
+		snapshot.writeInt(itr->second.size());
+		for (std::vector<int>::const_iterator j = itr->second.begin(); j != itr->second.end(); ++j)
+		{
+			snapshot.writeInt(*j);
+		}
+	}
+	snapshot.writeInt(stateIndexMap.size());
+	for (stateIndexMapping::const_iterator itr = stateIndexMap.begin(); itr != stateIndexMap.end(); ++itr)
+	{
+		snapshot.writeInt(itr->first);
+		snapshot.writeInt(itr->second);
+	}
+}
+
+
+bool readStateMapSnapshot(SnapshotReader& snapshot, stateMapping& stateMap, stateIndexMapping& stateIndexMap)
+{
+	try
+	{
+		size_t numProvinces = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numProvinces); ++i)
+		{
+			int province = static_cast<int>(snapshot.readInt());
+			std::vector<int> neighbors(snapshot.readCount(sizeof(long long)));
+			for (std::vector<int>::iterator j = neighbors.begin(); snapshot.good() && (j != neighbors.end()); ++j)
+			{
+				*j = static_cast<int>(snapshot.readInt());
+			}
+			stateMap.insert(std::make_pair(province, neighbors));
+		}
+		size_t numIndices = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numIndices); ++i)
+		{
+			int province = static_cast<int>(snapshot.readInt());
+			stateIndexMap.insert(std::make_pair(province, static_cast<int>(snapshot.readInt())));
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		snapshot.fail();
+	}
+	catch (const std::length_error&)
+	{
+		snapshot.fail();
+	}
+
+	if (!snapshot.good())
+	{
+		stateMap.clear();
+		stateIndexMap.clear();
+		return false;
+	}
+	return true;
+}
+
+
 cultureMapping initCultureMap(const wiz::load_data::UserType* obj) // TODO: consider cleaning up the distinguishers
 {
 	cultureMapping cultureMap;
 
 	for (int i=0; i < obj->GetUserTypeListSize(); ++i)
 	{
-		std::vector<std::string>		srcCultures;
-		std::string						dstCulture;
+		std::vector<Symbol>			srcCultures;
+		Symbol							dstCulture;
 		std::vector< distinguisher >	distinguishers;
 		for (int j = 0; j < obj->GetUserTypeList(i)->GetItemListSize(); ++j)
 		{
@@ -503,7 +559,7 @@ cultureMapping initCultureMap(const wiz::load_data::UserType* obj) // TODO: cons
 			}
 		}
 
-		for (std::vector<std::string>::iterator j = srcCultures.begin(); j != srcCultures.end(); ++j)
+		for (std::vector<Symbol>::iterator j = srcCultures.begin(); j != srcCultures.end(); ++j)
 		{
 			cultureStruct rule;
 			rule.srcCulture		= (*j);
@@ -523,8 +579,8 @@ religionMapping initReligionMap(const wiz::load_data::UserType* obj)
 	
 	for (int i=0; i < obj->GetUserTypeListSize(); ++i)
 	{
-		std::string					dstReligion;
-		std::vector<std::string>	srcReligion;
+		Symbol					dstReligion;
+		std::vector<Symbol>	srcReligion;
 
 		for (int j=0; j < obj->GetUserTypeList(i)->GetItemListSize(); ++j)
 		{
@@ -533,15 +589,15 @@ religionMapping initReligionMap(const wiz::load_data::UserType* obj)
 
 			if (type == "vic" )
 			{
-				dstReligion = std::move(value);
+				dstReligion = value;
 			}
 			else if (type == "eu3" )
 			{
-				srcReligion.push_back(std::move(value));
+				srcReligion.push_back(value);
 			}
 		}
 
-		for (std::vector<std::string>::iterator j = srcReligion.begin(); j != srcReligion.end(); ++j)
+		for (std::vector<Symbol>::iterator j = srcReligion.begin(); j != srcReligion.end(); ++j)
 		{
 			religionMap.insert(std::make_pair((*j), dstReligion));
 		}
@@ -557,8 +613,8 @@ unionMapping initUnionMap(const wiz::load_data::UserType* obj)
 
 	for (int i=0; i < obj->GetUserTypeListSize(); ++i)
 	{
-		std::string tag;
-		std::string culture;
+		CountryTag tag;
+		Symbol culture;
 
 		for (int j=0; j < obj->GetUserTypeList(i)->GetItemListSize(); ++j)
 		{
@@ -568,15 +624,15 @@ unionMapping initUnionMap(const wiz::load_data::UserType* obj)
 
 			if (name == "tag" )
 			{
-				tag = std::move(value);
+				tag = value;
 			}
 			if (name == "culture" )
 			{
-				culture = std::move(value);
+				culture = value;
 			}
 		}
 
-		unionMap.push_back(std::make_pair(std::move(culture), std::move(tag)));
+		unionMap.push_back(std::make_pair(culture, tag));
 	}
 
 	return unionMap;
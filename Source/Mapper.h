@@ -30,13 +30,19 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <map>
 #include <set>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
+#include "AdjacencyGraph.h"
+#include "CountryTag.h"
+#include "Symbol.h"
 
 
 #include "wiz/load_data_types.h"
 
 class V2World;
 class EU3World;
+class SnapshotReader;
+class SnapshotWriter;
 enum WorldType;
 
 
@@ -49,8 +55,7 @@ typedef std::unordered_set<int>			resettableMap;
 void initProvinceMap(const wiz::load_data::UserType* obj, WorldType worldType, provinceMapping& provinceMap, inverseProvinceMapping& inverseProvinceMap, resettableMap& resettableProvinces);
 const std::vector<int>& getV2ProvinceNums(const inverseProvinceMapping& invProvMap, int eu3ProvinceNum);
 
-typedef std::vector< std::vector<int> > adjacencyMapping;
-adjacencyMapping initAdjacencyMap();
+AdjacencyGraph initAdjacencyMap();
 
 
 typedef std::map<int, std::string>	continentMapping;	// <province, continent>
@@ -68,6 +73,8 @@ void removeLandlessNations(EU3World&);
 typedef std::map< int, std::vector<int> >	stateMapping;	// < province, all other provinces in state >
 typedef std::map< int, int >				stateIndexMapping; // < province, state index >
 void initStateMap(const wiz::load_data::UserType* obj, stateMapping& stateMap, stateIndexMapping& stateIndexMap);
+void writeStateMapSnapshot(SnapshotWriter& snapshot, const stateMapping& stateMap, const stateIndexMapping& stateIndexMap);
+bool readStateMapSnapshot(SnapshotReader& snapshot, stateMapping& stateMap, stateIndexMapping& stateIndexMap);
 
 
 // Culture Mappings
@@ -77,10 +84,10 @@ enum distinguisherType
 	DTReligion,
 	DTRegion
 };
-typedef std::pair<distinguisherType, std::string> distinguisher;
+typedef std::pair<distinguisherType, Symbol> distinguisher;
 typedef struct {
-	std::string srcCulture;
-	std::string dstCulture;
+	Symbol srcCulture;
+	Symbol dstCulture;
 	std::vector<distinguisher> distinguishers;
 } cultureStruct;
 typedef std::vector<cultureStruct> cultureMapping;
@@ -88,12 +95,12 @@ cultureMapping initCultureMap(const wiz::load_data::UserType* obj);
 
 
 // Religion Mappings
-typedef std::map<std::string, std::string> religionMapping;		// <srcReligion, destReligion>
+typedef std::unordered_map<Symbol, Symbol> religionMapping;		// <srcReligion, destReligion>
 religionMapping initReligionMap(const wiz::load_data::UserType* obj);
 
 
 // Union Mappings
-typedef std::vector< std::pair<std::string, std::string> > unionMapping;	// <cultures, tag>
+typedef std::vector< std::pair<Symbol, CountryTag> > unionMapping;	// <cultures, tag>
 unionMapping initUnionMap(const wiz::load_data::UserType* obj);
 
 
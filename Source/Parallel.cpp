@@ -0,0 +1,107 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Configuration.h"
+
+
+
+unsigned int ParallelThreadCount()
+{
+	unsigned int threads = Configuration::getThreads();
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	return (threads == 0) ? 1 : threads;
+}
+
+
+void ParallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	size_t threadCount = std::min<size_t>(ParallelThreadCount(), count);
+	if (threadCount <= 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			body(i);
+		}
+		return;
+	}
+
+	// hand out small batches of indices so uneven items still balance across the threads
+	const size_t batchSize = std::max<size_t>(1, count / (threadCount * 16));
+	std::atomic<size_t>	nextIndex(0);
+	std::exception_ptr	firstError;
+	std::mutex				errorMutex;
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			size_t start = nextIndex.fetch_add(batchSize);
+			if (start >= count)
+			{
+				return;
+			}
+			size_t end = std::min(start + batchSize, count);
+			try
+			{
+				for (size_t i = start; i < end; ++i)
+				{
+					body(i);
+				}
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!firstError)
+				{
+					firstError = std::current_exception();
+				}
+				nextIndex = count;
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < threadCount; ++i)
+	{
+		threads.push_back(std::thread(worker));
+	}
+	worker();
+	for (std::vector<std::thread>::iterator itr = threads.begin(); itr != threads.end(); ++itr)
+	{
+		itr->join();
+	}
+
+	if (firstError)
+	{
+		std::rethrow_exception(firstError);
+	}
+}
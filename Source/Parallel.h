@@ -0,0 +1,41 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <cstddef>
+#include <functional>
+
+
+
+// How many threads ParallelFor runs on: the configured thread count, or one per core
+unsigned int ParallelThreadCount();
+
+// Calls body(0) ... body(count - 1) spread over ParallelThreadCount() threads and returns once
+// every call has finished.  The calls run in no particular order, so each must only write
+// what belongs to its own index.  If any call throws, the first exception is rethrown here.
+void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+
+
+#endif // PARALLEL_H_
@@ -0,0 +1,189 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef PROVINCETABLE_H_
+#define PROVINCETABLE_H_
+
+
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+
+// Province ids are small and dense, so a ProvinceTable keeps one slot per id in a contiguous array,
+// with a bitmap saying which slots hold a province.  Lookups are an index and a bit test rather than
+// a tree walk, and iteration visits ids in ascending order, as a std::map<int, T> would, e.g.
+//		ProvinceTable<V2Province*> provinces;
+//		provinces.insert(std::make_pair(province->getNum(), province));
+//		ProvinceTable<V2Province*>::iterator itr = provinces.find(num);
+//		for (ProvinceTable<V2Province*>::iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+// The interface is the part of std::map the converter uses.  Ids must not be negative.
+template<class T>
+class ProvinceTable
+{
+	public:
+		typedef std::pair<int, T>	value_type;
+
+		template<class table, class value>
+		class basicIterator
+		{
+			public:
+				typedef std::forward_iterator_tag	iterator_category;
+				typedef std::pair<int, T>				value_type;
+				typedef std::ptrdiff_t					difference_type;
+				typedef value*								pointer;
+				typedef value&								reference;
+
+				basicIterator() noexcept: owner(nullptr), index(0) {}
+				basicIterator(table* _owner, size_t _index) noexcept: owner(_owner), index(_index) {}
+				template<class otherTable, class otherValue>
+				basicIterator(const basicIterator<otherTable, otherValue>& other) noexcept: owner(other.owner), index(other.index) {}
+
+				reference		operator*()		const noexcept	{ return owner->slots[index]; }
+				pointer			operator->()	const noexcept	{ return &owner->slots[index]; }
+				basicIterator&	operator++()	noexcept			{ index = owner->nextOccupied(index + 1); return *this; }
+				basicIterator	operator++(int)	noexcept			{ basicIterator old = *this; ++*this; return old; }
+
+				template<class otherTable, class otherValue>
+				bool operator==(const basicIterator<otherTable, otherValue>& rhs)	const noexcept	{ return index == rhs.index; }
+				template<class otherTable, class otherValue>
+				bool operator!=(const basicIterator<otherTable, otherValue>& rhs)	const noexcept	{ return index != rhs.index; }
+
+			private:
+				template<class, class> friend class basicIterator;
+				friend class ProvinceTable;
+
+				table*	owner;
+				size_t	index;
+		};
+		typedef basicIterator<ProvinceTable, value_type>					iterator;
+		typedef basicIterator<const ProvinceTable, const value_type>	const_iterator;
+
+		ProvinceTable() noexcept: numProvinces(0) {}
+
+		iterator			begin()					noexcept	{ return iterator(this, nextOccupied(0)); }
+		iterator			end()						noexcept	{ return iterator(this, slots.size()); }
+		const_iterator	begin()			const	noexcept	{ return const_iterator(this, nextOccupied(0)); }
+		const_iterator	end()				const	noexcept	{ return const_iterator(this, slots.size()); }
+		size_t			size()			const	noexcept	{ return numProvinces; }
+		bool				empty()			const	noexcept	{ return numProvinces == 0; }
+		size_t			count(int id)	const	noexcept	{ return isOccupied(id) ? 1 : 0; }
+
+		iterator			find(int id)			noexcept	{ return isOccupied(id) ? iterator(this, id) : end(); }
+		const_iterator	find(int id)	const	noexcept	{ return isOccupied(id) ? const_iterator(this, id) : end(); }
+
+		// like std::map, an existing province is kept and the returned flag is false
+		std::pair<iterator, bool> insert(const value_type& province)
+		{
+			if (province.first < 0)
+			{
+				return std::make_pair(end(), false);
+			}
+			if (isOccupied(province.first))
+			{
+				return std::make_pair(iterator(this, province.first), false);
+			}
+			occupy(province.first);
+			slots[province.first].second = province.second;
+			return std::make_pair(iterator(this, province.first), true);
+		}
+		T& operator[](int id)
+		{
+			if (!isOccupied(id))
+			{
+				occupy(id);
+			}
+			return slots[id].second;
+		}
+
+		size_t erase(int id) noexcept
+		{
+			if (!isOccupied(id))
+			{
+				return 0;
+			}
+			occupied[id / 64]		&= ~(uint64_t(1) << (id % 64));
+			slots[id].second		= T();
+			--numProvinces;
+			return 1;
+		}
+		void erase(const_iterator itr) noexcept	{ erase(static_cast<int>(itr.index)); }
+		void clear() noexcept
+		{
+			slots.clear();
+			occupied.clear();
+			numProvinces = 0;
+		}
+
+	private:
+		bool isOccupied(int id) const noexcept
+		{
+			return (id >= 0) && (static_cast<size_t>(id) < slots.size()) && ((occupied[id / 64] >> (id % 64)) & 1);
+		}
+		void occupy(int id)
+		{
+			if (static_cast<size_t>(id) >= slots.size())
+			{
+				size_t oldSize = slots.size();
+				slots.resize(id + 1);
+				for (size_t i = oldSize; i < slots.size(); ++i)
+				{
+					slots[i].first = static_cast<int>(i);
+				}
+				occupied.resize((slots.size() + 63) / 64, 0);
+			}
+			occupied[id / 64] |= (uint64_t(1) << (id % 64));
+			++numProvinces;
+		}
+		// the first occupied slot at or after index, or slots.size(); empty words are skipped whole
+		size_t nextOccupied(size_t index) const noexcept
+		{
+			while (index < slots.size())
+			{
+				uint64_t word = occupied[index / 64] >> (index % 64);
+				if (word == 0)
+				{
+					index = (index / 64 + 1) * 64;
+					continue;
+				}
+				while ((word & 1) == 0)
+				{
+					word >>= 1;
+					++index;
+				}
+				return index;
+			}
+			return slots.size();
+		}
+
+		std::vector<value_type>	slots;			// slot i holds province i, when its bit is set
+		std::vector<uint64_t>	occupied;
+		size_t						numProvinces;
+};
+
+
+
+#endif // PROVINCETABLE_H_
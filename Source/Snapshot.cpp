@@ -0,0 +1,372 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "Snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <io.h>
+#include <sys/stat.h>
+#include <Windows.h>
+#include "Log.h"
+
+
+
+static const char snapshotMagic[8] = { 'E', 'U', '3', 'V', '2', 'S', 'N', 'P' };
+
+
+SnapshotKey::SnapshotKey()
+{
+	hash = 14695981039346656037ULL;	// FNV-1a offset basis
+	addBytes(&snapshotVersion, sizeof(snapshotVersion));
+}
+
+
+void SnapshotKey::addBytes(const void* bytes, size_t size)
+{
+	const unsigned char* data = static_cast<const unsigned char*>(bytes);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ULL;		// FNV-1a prime
+	}
+}
+
+
+void SnapshotKey::addString(const std::string& text)
+{
+	size_t length = text.size();
+	addBytes(&length, sizeof(length));
+	addBytes(text.data(), length);
+}
+
+
+void SnapshotKey::addFile(const std::string& path)
+{
+	addString(path);
+
+	long long size			= -1;
+	long long writeTime	= -1;
+	struct _stat st;
+	if (_stat(path.c_str(), &st) == 0)
+	{
+		size			= st.st_size;
+		writeTime	= st.st_mtime;
+	}
+	addBytes(&size, sizeof(size));
+	addBytes(&writeTime, sizeof(writeTime));
+}
+
+
+void SnapshotKey::addFileContents(const std::string& path)
+{
+	addString(path);
+
+	std::ifstream input(path, std::ios::binary);
+	std::vector<char> block(1 << 20);
+	while (input.good())
+	{
+		input.read(&block[0], block.size());
+		addBytes(&block[0], static_cast<size_t>(input.gcount()));
+	}
+}
+
+
+void SnapshotKey::addFolder(const std::string& path)
+{
+	struct _finddata_t	fileData;
+	intptr_t					fileListing = _findfirst((path + "\\*.*").c_str(), &fileData);
+	if (fileListing == -1L)
+	{
+		addString(path);
+		return;
+	}
+	do
+	{
+		if (strcmp(fileData.name, ".") == 0 || strcmp(fileData.name, "..") == 0)
+		{
+			continue;
+		}
+		if (fileData.attrib & _A_SUBDIR)
+		{
+			addFolder(path + "\\" + fileData.name);
+		}
+		else
+		{
+			addFile(path + "\\" + fileData.name);
+		}
+	} while (_findnext(fileListing, &fileData) == 0);
+	_findclose(fileListing);
+}
+
+
+void SnapshotWriter::writeInt(long long value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+void SnapshotWriter::writeDouble(double value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+void SnapshotWriter::writeBool(bool value)
+{
+	buffer.push_back(value ? 1 : 0);
+}
+
+
+void SnapshotWriter::writeString(const std::string& value)
+{
+	writeInt(value.size());
+	buffer.append(value);
+}
+
+
+void SnapshotWriter::writeDate(const date& value)
+{
+	writeInt(value.year);
+	writeInt(value.month);
+	writeInt(value.day);
+}
+
+
+bool SnapshotWriter::save(const std::string& fileName, const SnapshotKey& key) const
+{
+	// written under another name first, so a failed write never leaves a truncated snapshot behind
+	const std::string tempFileName = fileName + ".tmp";
+	std::ofstream output(tempFileName, std::ios::binary | std::ios::trunc);
+	if (!output.is_open())
+	{
+		LOG(LogLevel::Warning) << "Could not create snapshot " << tempFileName;
+		return false;
+	}
+	unsigned long long keyValue = key.get();
+	output.write(snapshotMagic, sizeof(snapshotMagic));
+	output.write(reinterpret_cast<const char*>(&snapshotVersion), sizeof(snapshotVersion));
+	output.write(reinterpret_cast<const char*>(&keyValue), sizeof(keyValue));
+	output.write(buffer.data(), buffer.size());
+	output.close();
+	if (output.fail())
+	{
+		LOG(LogLevel::Warning) << "Could not write snapshot " << tempFileName;
+		remove(tempFileName.c_str());
+		return false;
+	}
+
+	remove(fileName.c_str());
+	if (rename(tempFileName.c_str(), fileName.c_str()) != 0)
+	{
+		LOG(LogLevel::Warning) << "Could not replace snapshot " << fileName;
+		remove(tempFileName.c_str());
+		return false;
+	}
+	LOG(LogLevel::Debug) << "Wrote snapshot " << fileName << " (" << buffer.size() << " bytes)";
+	return true;
+}
+
+
+SnapshotReader::SnapshotReader()
+{
+	file		= INVALID_HANDLE_VALUE;
+	mapping	= nullptr;
+	view		= nullptr;
+	size		= 0;
+	position	= 0;
+	failed	= true;
+}
+
+
+SnapshotReader::~SnapshotReader()
+{
+	close();
+}
+
+
+void SnapshotReader::close()
+{
+	if (view != nullptr)
+	{
+		UnmapViewOfFile(view);
+		view = nullptr;
+	}
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+	size		= 0;
+	position	= 0;
+	failed	= true;
+}
+
+
+bool SnapshotReader::open(const std::string& fileName, const SnapshotKey& key)
+{
+	close();
+
+	file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart < static_cast<LONGLONG>(sizeof(snapshotMagic) + sizeof(snapshotVersion) + sizeof(unsigned long long))))
+	{
+		close();
+		return false;
+	}
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		close();
+		return false;
+	}
+	view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (view == nullptr)
+	{
+		close();
+		return false;
+	}
+	size		= static_cast<size_t>(fileSize.QuadPart);
+	position	= 0;
+	failed	= false;
+
+	char magic[sizeof(snapshotMagic)];
+	unsigned int version = 0;
+	unsigned long long keyValue = 0;
+	read(magic, sizeof(magic));
+	read(&version, sizeof(version));
+	read(&keyValue, sizeof(keyValue));
+	if ((memcmp(magic, snapshotMagic, sizeof(snapshotMagic)) != 0) || (version != snapshotVersion))
+	{
+		LOG(LogLevel::Debug) << "Snapshot " << fileName << " was written by another version";
+		close();
+		return false;
+	}
+	if (keyValue != key.get())
+	{
+		LOG(LogLevel::Debug) << "Snapshot " << fileName << " is out of date";
+		close();
+		return false;
+	}
+
+	LOG(LogLevel::Debug) << "Reading snapshot " << fileName;
+	return true;
+}
+
+
+bool SnapshotReader::read(void* dest, size_t count)
+{
+	if (failed || (count > size - position))
+	{
+		failed = true;
+		memset(dest, 0, count);
+		return false;
+	}
+	memcpy(dest, view + position, count);
+	position += count;
+	return true;
+}
+
+
+long long SnapshotReader::readInt()
+{
+	long long value;
+	read(&value, sizeof(value));
+	return value;
+}
+
+
+// A count is checked against what is left of the snapshot before anything is allocated for it, so a
+// damaged count fails the reader instead of asking for more memory than the snapshot could fill
+size_t SnapshotReader::readCount(size_t elementSize)
+{
+	long long count = readInt();
+	size_t maxCount = (size - position) / ((elementSize > 0) ? elementSize : 1);
+	if (failed || (count < 0) || (static_cast<unsigned long long>(count) > maxCount))
+	{
+		failed = true;
+		return 0;
+	}
+	return static_cast<size_t>(count);
+}
+
+
+double SnapshotReader::readDouble()
+{
+	double value;
+	read(&value, sizeof(value));
+	return value;
+}
+
+
+bool SnapshotReader::readBool()
+{
+	char value;
+	read(&value, sizeof(value));
+	return (value != 0);
+}
+
+
+std::string SnapshotReader::readString()
+{
+	long long length = readInt();
+	if (failed || (length < 0) || (static_cast<size_t>(length) > size - position))
+	{
+		failed = true;
+		return "";
+	}
+	std::string value(view + position, static_cast<size_t>(length));
+	position += static_cast<size_t>(length);
+	return value;
+}
+
+
+CountryTag SnapshotReader::readTag()
+{
+	std::string tag = readString();
+	if (tag.size() > 4)
+	{
+		failed = true;
+		return CountryTag();
+	}
+	return CountryTag(tag);
+}
+
+
+date SnapshotReader::readDate()
+{
+	date value;
+	value.year	= static_cast<int>(readInt());
+	value.month	= static_cast<int>(readInt());
+	value.day	= static_cast<int>(readInt());
+	return value;
+}
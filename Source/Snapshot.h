@@ -0,0 +1,113 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <string>
+#include "CountryTag.h"
+#include "Date.h"
+
+
+
+// Binary snapshots of parsed game data.  A snapshot is stamped with a key built from the files it
+// was parsed from, so it is only read back while those files are unchanged.  Bump snapshotVersion
+// whenever the layout of any snapshot changes.
+const unsigned int snapshotVersion = 4;
+
+
+class SnapshotKey
+{
+	public:
+		SnapshotKey();
+		void	addString(const std::string& text);
+		void	addFile(const std::string& path);		// by size and write time; a missing file counts as well
+		void	addFolder(const std::string& path);		// every file in the folder and its subfolders
+		void	addFileContents(const std::string& path);	// every byte of the file, for files that are replaced in place
+
+		unsigned long long	get() const noexcept { return hash; }
+	private:
+		void	addBytes(const void* bytes, size_t size);
+
+		unsigned long long	hash;
+};
+
+
+class SnapshotWriter
+{
+	public:
+		void	writeInt(long long value);
+		void	writeDouble(double value);
+		void	writeBool(bool value);
+		void	writeString(const std::string& value);
+		void	writeDate(const date& value);
+
+		// Writes the snapshot to the given file.  Returns false and logs a warning on failure.
+		bool	save(const std::string& fileName, const SnapshotKey& key) const;
+	private:
+		std::string	buffer;
+};
+
+
+class SnapshotReader
+{
+	public:
+		SnapshotReader();
+		~SnapshotReader();
+
+		// Maps the given snapshot into memory.  Returns false if it is missing, was written by another
+		// version or was made from other files.
+		bool			open(const std::string& fileName, const SnapshotKey& key);
+
+		// Unmaps the snapshot and lets go of the file, so that a damaged one can be written over
+		void			close();
+
+		long long	readInt();
+		size_t		readCount(size_t elementSize);	// of the elements that follow, each at least elementSize bytes
+		double		readDouble();
+		bool			readBool();
+		std::string	readString();
+		CountryTag	readTag();		// a string too long to be a tag fails the reader instead of the conversion
+		date			readDate();
+
+		// Whether every read so far was in bounds.  Reads past the end return zeros and empty strings.
+		bool			good() const noexcept { return !failed; }
+
+		// Marks the snapshot as damaged, for a loader that could not use what it read
+		void			fail() noexcept { failed = true; }
+	private:
+		SnapshotReader(const SnapshotReader&) = delete;
+		SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+		bool			read(void* dest, size_t count);
+
+		void*			file;			// the snapshot file's HANDLE
+		void*			mapping;		// the file mapping's HANDLE
+		const char*	view;
+		size_t		size;
+		size_t		position;
+		bool			failed;
+};
+
+
+
+#endif // SNAPSHOT_H_
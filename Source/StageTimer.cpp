@@ -0,0 +1,200 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "StageTimer.h"
+#include "Diagnostics.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include <Windows.h>
+#include <Psapi.h>
+
+#pragma comment(lib, "psapi.lib")
+
+
+
+static std::mutex						timingsLock;
+static std::vector<stageTiming>	timings;
+static thread_local int				stageDepth = 0;
+
+
+static long long WallMicros()
+{
+	static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+
+static long long CPUMicros()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+	{
+		return 0;
+	}
+	// FILETIMEs count 100ns intervals
+	unsigned long long kernel	= (static_cast<unsigned long long>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+	unsigned long long user		= (static_cast<unsigned long long>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+	return static_cast<long long>((kernel + user) / 10);
+}
+
+
+static long long PeakRSS()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return static_cast<long long>(counters.PeakWorkingSetSize);
+}
+
+
+StageTimer::StageTimer(const std::string& name)
+: running(false)
+{
+	start(name);
+}
+
+
+StageTimer::~StageTimer()
+{
+	stop();
+}
+
+
+void StageTimer::next(const std::string& name)
+{
+	stop();
+	start(name);
+}
+
+
+void StageTimer::start(const std::string& name)
+{
+	timing.name				= name;
+	timing.depth			= stageDepth++;
+	timing.startMicros	= WallMicros();
+	startCPU					= CPUMicros();
+	startPeakRSS			= PeakRSS();
+	running					= true;
+}
+
+
+void StageTimer::stop()
+{
+	if (!running)
+	{
+		return;
+	}
+	running = false;
+	--stageDepth;
+
+	timing.wallMicros		= WallMicros() - timing.startMicros;
+	timing.cpuMicros		= CPUMicros() - startCPU;
+	timing.peakRSSDelta	= PeakRSS() - startPeakRSS;
+	StageTimings::record(timing);
+}
+
+
+void StageTimings::record(const stageTiming& timing)
+{
+	std::lock_guard<std::mutex> lock(timingsLock);
+	timings.push_back(timing);
+}
+
+
+std::vector<stageTiming> StageTimings::getTimings()
+{
+	std::lock_guard<std::mutex> lock(timingsLock);
+	return timings;
+}
+
+
+static bool StageStartPredicate(const stageTiming& lhs, const stageTiming& rhs)
+{
+	if (lhs.startMicros != rhs.startMicros)
+	{
+		return lhs.startMicros < rhs.startMicros;
+	}
+	return lhs.depth < rhs.depth;
+}
+
+
+void StageTimings::writeSummary()
+{
+	// stages are recorded as they finish; list them as they started so nested stages follow their parents
+	std::vector<stageTiming> sortedTimings = getTimings();
+	std::stable_sort(sortedTimings.begin(), sortedTimings.end(), StageStartPredicate);
+
+	LOG(LogLevel::Info) << "Stage timings:";
+	LOG(LogLevel::Info) << "     wall (s)     cpu (s)  peak RSS +MB  stage";
+	for (std::vector<stageTiming>::const_iterator itr = sortedTimings.begin(); itr != sortedTimings.end(); ++itr)
+	{
+		std::ostringstream row;
+		row << std::fixed << std::setprecision(3);
+		row << std::setw(13) << (itr->wallMicros / 1000000.0);
+		row << std::setw(12) << (itr->cpuMicros / 1000000.0);
+		row << std::setprecision(1) << std::setw(14) << (itr->peakRSSDelta / (1024.0 * 1024.0));
+		row << "  " << std::string(2 * itr->depth, ' ') << itr->name;
+		LOG(LogLevel::Info) << row.str();
+	}
+}
+
+
+void StageTimings::writeTrace(const std::string& traceFileName)
+{
+	std::vector<stageTiming> sortedTimings = getTimings();
+	std::stable_sort(sortedTimings.begin(), sortedTimings.end(), StageStartPredicate);
+
+	FILE* traceFile;
+	if (fopen_s(&traceFile, traceFileName.c_str(), "w") != 0)
+	{
+		LOG(LogLevel::Warning) << "Could not create stage trace file " << traceFileName;
+		return;
+	}
+	fprintf(traceFile, "{\n");
+	fprintf(traceFile, "\t\"displayTimeUnit\": \"ms\",\n");
+	fprintf(traceFile, "\t\"traceEvents\": [");
+	for (std::vector<stageTiming>::const_iterator itr = sortedTimings.begin(); itr != sortedTimings.end(); ++itr)
+	{
+		fprintf(traceFile, "%s\n\t\t{ \"name\": \"%s\", \"cat\": \"stage\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %lld, \"dur\": %lld, ",
+			(itr == sortedTimings.begin()) ? "" : ",", JSONEscape(itr->name).c_str(), itr->startMicros, itr->wallMicros);
+		fprintf(traceFile, "\"args\": { \"cpu_us\": %lld, \"peak_rss_delta_bytes\": %lld } }", itr->cpuMicros, itr->peakRSSDelta);
+	}
+	fprintf(traceFile, "\n\t]\n");
+	fprintf(traceFile, "}\n");
+	fclose(traceFile);
+}
+
+
+void StageTimings::clear()
+{
+	std::lock_guard<std::mutex> lock(timingsLock);
+	timings.clear();
+}
@@ -0,0 +1,88 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+#ifndef STAGETIMER_H_
+#define STAGETIMER_H_
+
+#include <string>
+#include <vector>
+
+
+
+// The measurements for one finished stage
+struct stageTiming
+{
+	std::string	name;
+	int			depth;				// how many stages enclose this one
+	long long	startMicros;		// wall time since the first stage started
+	long long	wallMicros;
+	long long	cpuMicros;			// user + kernel time of the whole process, across all threads
+	long long	peakRSSDelta;		// growth of the process' peak working set, in bytes
+};
+
+
+// Times a stage of the conversion from construction until destruction, e.g.
+//		StageTimer timer("Converting provinces");
+// Stages can nest.  next() ends the current stage and starts another in its place,
+// for sequential stages whose results are needed after the stage is over.
+class StageTimer
+{
+	public:
+		explicit StageTimer(const std::string& name);
+		~StageTimer();
+
+		void	next(const std::string& name);
+		void	stop();
+
+	private:
+		StageTimer(const StageTimer&) = delete;
+		StageTimer& operator=(const StageTimer&) = delete;
+
+		void	start(const std::string& name);
+
+		bool			running;
+		stageTiming	timing;
+		long long	startCPU;
+		long long	startPeakRSS;
+};
+
+
+class StageTimings // Singleton
+{
+	public:
+		static void	record(const stageTiming& timing);
+
+		// every stage finished so far, in the order they finished
+		static std::vector<stageTiming>	getTimings();
+
+		// logs a table of every finished stage
+		static void	writeSummary();
+
+		// writes every finished stage as Chrome trace events (chrome://tracing, Perfetto)
+		static void	writeTrace(const std::string& traceFileName);
+
+		// forgets every stage recorded so far
+		static void	clear();
+};
+
+
+
+#endif // STAGETIMER_H_
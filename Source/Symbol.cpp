@@ -0,0 +1,104 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#include "Symbol.h"
+#include <cstdlib>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include "Log.h"
+
+
+
+// The pool hands out names in fixed-size chunks that are never moved or freed, so str() can
+// read any id it was given without taking the lock; only interning a new name locks.
+static const unsigned int	chunkBits	= 12;
+static const unsigned int	chunkSize	= 1 << chunkBits;
+static const unsigned int	maxChunks	= 4096;
+
+namespace
+{
+	struct symbolPool
+	{
+		symbolPool(): chunks(), numSymbols(1)
+		{
+			chunks[0]	= new std::string[chunkSize];
+			ids.insert(std::make_pair(std::string_view(chunks[0][0]), 0));
+		}
+
+		std::mutex													lock;
+		std::string*												chunks[maxChunks];	// the arena - ids index into these
+		unsigned int												numSymbols;
+		std::unordered_map<std::string_view, unsigned int>	ids;					// views into the arena
+	};
+}
+
+
+static symbolPool& GetPool()
+{
+	static symbolPool* pool = new symbolPool;	// never destroyed, so Symbols stay valid during shutdown
+	return *pool;
+}
+
+
+const std::string& Symbol::str() const noexcept
+{
+	return GetPool().chunks[id >> chunkBits][id & (chunkSize - 1)];
+}
+
+
+size_t Symbol::poolSize()
+{
+	symbolPool& pool = GetPool();
+	std::lock_guard<std::mutex> guard(pool.lock);
+	return pool.numSymbols;
+}
+
+
+unsigned int Symbol::intern(const std::string& name)
+{
+	symbolPool& pool = GetPool();
+	std::lock_guard<std::mutex> guard(pool.lock);
+
+	std::unordered_map<std::string_view, unsigned int>::const_iterator itr = pool.ids.find(name);
+	if (itr != pool.ids.end())
+	{
+		return itr->second;
+	}
+
+	unsigned int newId = pool.numSymbols;
+	if ((newId >> chunkBits) >= maxChunks)
+	{
+		LOG(LogLevel::Error) << "Too many distinct names to intern (" << newId << ")";
+		exit(-1);
+	}
+	std::string*& chunk = pool.chunks[newId >> chunkBits];
+	if (chunk == nullptr)
+	{
+		chunk = new std::string[chunkSize];
+	}
+	std::string& slot = chunk[newId & (chunkSize - 1)];
+	slot = name;
+	pool.ids.insert(std::make_pair(std::string_view(slot), newId));
+	++pool.numSymbols;
+	return newId;
+}
@@ -0,0 +1,91 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef SYMBOL_H_
+#define SYMBOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+
+
+// An interned name - a culture, religion, pop type, trade good and the like.  Each distinct
+// string is stored once in a global pool for the life of the program and a Symbol is just its
+// 32-bit index, so copying one is free and two Symbols compare equal exactly when their ids do.
+// Interning is thread-safe, so Symbols can be made while the save is parsed in parallel.
+class Symbol
+{
+	public:
+		Symbol() noexcept: id(0) {}						// the empty string
+		Symbol(const std::string& name): id(intern(name)) {}
+		Symbol(const char* name): id(intern(name)) {}
+
+		const std::string&	str()		const noexcept;
+		const char*			c_str()	const noexcept	{ return str().c_str(); }
+		bool					empty()	const noexcept	{ return id == 0; }
+		unsigned int		getId()	const noexcept	{ return id; }
+		operator const std::string&()	const noexcept	{ return str(); }
+
+		bool operator==(Symbol rhs)					const noexcept	{ return id == rhs.id; }
+		bool operator!=(Symbol rhs)					const noexcept	{ return id != rhs.id; }
+		bool operator==(const std::string& rhs)	const noexcept	{ return str() == rhs; }
+		bool operator!=(const std::string& rhs)	const noexcept	{ return str() != rhs; }
+		bool operator==(const char* rhs)				const noexcept	{ return str() == rhs; }
+		bool operator!=(const char* rhs)				const noexcept	{ return str() != rhs; }
+
+		// alphabetical, so maps keyed by Symbol keep the order (and the output) they had as strings
+		bool operator<(Symbol rhs)						const noexcept	{ return (id != rhs.id) && (str() < rhs.str()); }
+
+		// how many distinct names have been interned, the empty string included
+		static size_t poolSize();
+
+	private:
+		static unsigned int intern(const std::string& name);
+
+		unsigned int id;
+};
+
+
+inline bool operator==(const std::string& lhs, Symbol rhs) noexcept	{ return rhs == lhs; }
+inline bool operator!=(const std::string& lhs, Symbol rhs) noexcept	{ return rhs != lhs; }
+inline bool operator==(const char* lhs, Symbol rhs) noexcept			{ return rhs == lhs; }
+inline bool operator!=(const char* lhs, Symbol rhs) noexcept			{ return rhs != lhs; }
+inline std::string operator+(const std::string& lhs, Symbol rhs)		{ return lhs + rhs.str(); }
+inline std::string operator+(Symbol lhs, const std::string& rhs)		{ return lhs.str() + rhs; }
+inline std::string operator+(const char* lhs, Symbol rhs)				{ return lhs + rhs.str(); }
+inline std::string operator+(Symbol lhs, const char* rhs)				{ return lhs.str() + rhs; }
+inline std::ostream& operator<<(std::ostream& out, Symbol symbol)		{ return out << symbol.str(); }
+
+
+namespace std
+{
+	template<> struct hash<Symbol>
+	{
+		size_t operator()(Symbol symbol) const noexcept { return symbol.getId(); }
+	};
+}
+
+
+
+#endif // SYMBOL_H_
@@ -28,13 +28,10 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-static int nextArmyID = 0;
-
-
-V2ArmyID::V2ArmyID()
+V2ArmyID::V2ArmyID(int _id)
 {
 	type = 40; // seems to be always 40, for army, navy, ship and regiment
-	id = ++nextArmyID;
+	id = _id;
 }
 
 
@@ -49,7 +46,7 @@ void V2ArmyID::output(FILE* out, int indentlevel) const
 }
 
 
-V2Regiment::V2Regiment(RegimentCategory rc) : category(rc)
+V2Regiment::V2Regiment(RegimentCategory rc, int _id) : id(_id), category(rc)
 {
 	name		= "\"\"";
 	switch (rc)
@@ -107,7 +104,7 @@ void V2Regiment::output(FILE* out) const
 }
 
 
-V2Army::V2Army(EU3Army* oldArmy, const std::map<int, int>& leaderIDMap)
+V2Army::V2Army(EU3Army* oldArmy, const std::map<int, int>& leaderIDMap, int _id) : id(_id)
 {
 	name			= oldArmy->getName();
 	location		= -1;
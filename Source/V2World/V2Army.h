@@ -33,7 +33,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 struct V2ArmyID
 {
 	public:
-		V2ArmyID();
+		V2ArmyID(int _id);
 		void output(FILE* out, int indentlevel) const;
 
 		int id;
@@ -44,7 +44,7 @@ struct V2ArmyID
 class V2Regiment // also Ship
 {
 	public:
-		V2Regiment(RegimentCategory rc);
+		V2Regiment(RegimentCategory rc, int _id);
 		void output(FILE* out) const;
 
 		void setName(const std::string& _name)	noexcept { name = _name; };
@@ -71,7 +71,7 @@ class V2Army // also Navy
 			valid = false;
 		}
 	public:
-		V2Army(EU3Army* oldArmy, const std::map<int, int>& leaderIDMap);
+		V2Army(EU3Army* oldArmy, const std::map<int, int>& leaderIDMap, int _id);
 		void					output(FILE* out) const;
 		void					addRegiment(V2Regiment reg);
 
@@ -31,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <sstream>
 #include <queue>
 #include "../Log.h"
+#include "../Diagnostics.h"
 #include "../Configuration.h"
 #include "../EU3World/EU3World.h"
 #include "../EU3World/EU3Province.h"
@@ -53,7 +54,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 const int MONEYFACTOR = 30;	// ducat to pound conversion rate
 
 
-V2Country::V2Country(const std::string& _tag, const std::string& _commonCountryFile, const std::vector<V2Party*>& _parties,
+V2Country::V2Country(CountryTag _tag, const std::string& _commonCountryFile, const std::vector<V2Party*>& _parties,
 	V2World* _theWorld, bool _newCountry, bool _dynamicCountry)
 {
 	theWorld			= _theWorld;
@@ -74,18 +75,7 @@ V2Country::V2Country(const std::string& _tag, const std::string& _commonCountryF
 	states.clear();
 	provinces.clear();
 
-	for (unsigned int i = 0; i < VANILLA_naval_exercises; i++)
-	{
-		vanillaInventions[i] = illegal;
-	}
-	for (unsigned int i = 0; i < HOD_naval_exercises; i++)
-	{
-		HODInventions[i] = illegal;
-	}
-	for (unsigned int i = 0; i < HOD_NNM_naval_exercises; i++)
-	{
-		HODNNMInventions[i] = illegal;
-	}
+	inventions.assign(getV2NumInventions(), illegal);
 
 	leadership		= 0.0;
 	plurality		= 0.0;
@@ -97,8 +87,8 @@ V2Country::V2Country(const std::string& _tag, const std::string& _commonCountryF
 	techSchool		= "traditional_academic";
 	researchPoints	= 0.0;
 	civilized		= false;
-	primaryCulture	= "";
-	religion			= "";
+	primaryCulture	= Symbol();
+	religion			= Symbol();
 	government		= "";
 	nationalValue	= "";
 	lastBankrupt	= date();
@@ -134,7 +124,7 @@ V2Country::V2Country(const std::string& _tag, const std::string& _commonCountryF
 		for (size_t i = 0; i < ideologies.size(); ++i)
 		{
 			std::string partyKey = tag + '_' + ideologies[i];
-			parties.push_back(new V2Party(partyKey, ideologies[i]));
+			parties.push_back(theWorld->getArena().make<V2Party>(partyKey, ideologies[i]));
 			localisation.SetPartyKey(i, partyKey);
 			localisation.SetPartyName(i, "english", partyNames[i]);
 		}
@@ -149,6 +139,14 @@ V2Country::V2Country(const std::string& _tag, const std::string& _commonCountryF
 }
 
 
+V2Country::V2Country(const V2Country& base, V2World* _theWorld)
+	: V2Country(base)
+{
+	// the parties are only read once the country exists, so the copies share them
+	theWorld = _theWorld;
+}
+
+
 void V2Country::output() const
 {
 	if(!dynamicCountry)
@@ -164,15 +162,15 @@ void V2Country::output() const
 		{
 			fprintf(output, "capital=%d\n", capital);
 		}
-		if (primaryCulture.size() > 0)
+		if (!primaryCulture.empty())
 		{
 			fprintf(output, "primary_culture = %s\n", primaryCulture.c_str());
 		}
-		for (std::set<std::string>::iterator i = acceptedCultures.begin(); i != acceptedCultures.end(); i++)
+		for (std::set<Symbol>::iterator i = acceptedCultures.begin(); i != acceptedCultures.end(); i++)
 		{
 			fprintf(output, "culture = %s\n", i->c_str());
 		}
-		if (religion != "")
+		if (!religion.empty())
 		{
 			fprintf(output, "religion = %s\n", religion.c_str());
 		}
@@ -278,7 +276,7 @@ void V2Country::output() const
 
 void V2Country::outputToCommonCountriesFile(FILE* output) const
 {
-	fprintf(output, "%s = \"countries%s\"\n", tag.c_str(), commonCountryFile.c_str());
+	fprintf(output, "%s = \"countries%s\"\n", tag.str().c_str(), commonCountryFile.c_str());
 }
 
 
@@ -332,7 +330,7 @@ void V2Country::outputOOB() const
 
 	fprintf(output, "#Sphere of Influence\n");
 	fprintf(output, "\n");
-	for (std::map<std::string, V2Relations*>::const_iterator relationsItr = relations.begin(); relationsItr != relations.end(); ++relationsItr)
+	for (std::map<CountryTag, V2Relations*>::const_iterator relationsItr = relations.begin(); relationsItr != relations.end(); ++relationsItr)
 	{
 		relationsItr->second->output(output);
 	}
@@ -355,10 +353,10 @@ void V2Country::outputOOB() const
 }
 
 
-void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vector<std::string>& outputOrder,
-	const CountryMapping& countryMap, const cultureMapping& cultureMap, const religionMapping& religionMap, 
+void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vector<CountryTag>& outputOrder,
+	const CountryMapping& countryMap, const CultureRuleEngine& cultureRules, const religionMapping& religionMap, 
 	const unionCulturesMap& unionCultures, const governmentMapping& governmentMap, const inverseProvinceMapping& inverseProvinceMap,
-	const std::vector<V2TechSchool>& techSchools, const std::map<int, int>& leaderMap, const V2LeaderTraits& lt, const EU3RegionsMapping& regionsMap)
+	const std::vector<V2TechSchool>& techSchools, const std::map<int, int>& leaderMap, const V2LeaderTraits& lt)
 {
 	srcCountry = _srcCountry;
 
@@ -414,8 +412,8 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	}
 
 	// religion
-	std::string srcReligion = srcCountry->getReligion();
-	if (srcReligion.size() > 0)
+	Symbol srcReligion = srcCountry->getReligion();
+	if (!srcReligion.empty())
 	{
 		religionMapping::const_iterator i = religionMap.find(srcReligion);
 		if (i != religionMap.end())
@@ -429,63 +427,18 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	}
 
 	// primary culture
-	std::string srcCulture = srcCountry->getPrimaryCulture();
-	if (srcCulture.size() > 0)
+	Symbol srcCulture = srcCountry->getPrimaryCulture();
+	if (!srcCulture.empty())
 	{
-		bool matched = false;
-		for (cultureMapping::const_iterator i = cultureMap.begin(); (i != cultureMap.end()) && (!matched); i++)
-		{
-			if (i->srcCulture == srcCulture)
-			{
-				bool match = true;
-				for (std::vector<distinguisher>::const_iterator j = i->distinguishers.begin(); j != i->distinguishers.end(); j++)
-				{
-					if (j->first == DTOwner)
-					{
-						if (tag != j->second)
-						{
-								match = false;
-						}
-					}
-					else if (j->first == DTReligion)
-					{
-						if (religion != j->second)
-						{
-							match = false;
-						}
-					}
-					else if (j->first == DTRegion)
-					{
-						auto regions = regionsMap.find(oldCapital);
-						if ((regions == regionsMap.end()) || (regions->second.find(j->second) == regions->second.end()))
-						{
-							match = false;
-						}
-						else
-						{
-							match = true;
-						}
-					}
-					else
-					{
-						LOG(LogLevel::Warning) << "Unhandled distinguisher type in culture rules";
-					}
-				}
-				if (match)
-				{
-					primaryCulture = i->dstCulture;
-					matched = true;
-				}
-			}
-		}
-		if (!matched)
+		primaryCulture = cultureRules.resolve(srcCulture, religion, tag, oldCapital);
+		if (primaryCulture.empty())
 		{
 			LOG(LogLevel::Warning) << "No culture mapping defined for " << srcCulture << " (" << srcCountry->getTag() << " -> " << tag << ')';
 		}
 	}
 
 	//accepted cultures
-	std::vector<std::string> srcAceptedCultures = srcCountry->getAcceptedCultures();
+	std::vector<Symbol> srcAceptedCultures = srcCountry->getAcceptedCultures();
 	unionCulturesMap::const_iterator unionItr = unionCultures.find(srcCountry->getTag());
 	if (unionItr != unionCultures.end())
 	{
@@ -494,55 +447,14 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 			srcAceptedCultures.push_back(*j);
 		}
 	}
-	for (std::vector<std::string>::const_iterator i = srcAceptedCultures.begin(); i != srcAceptedCultures.end(); i++)
+	for (std::vector<Symbol>::const_iterator i = srcAceptedCultures.begin(); i != srcAceptedCultures.end(); i++)
 	{
-		bool matched = false;
-		for (cultureMapping::const_iterator j = cultureMap.begin(); (j != cultureMap.end()) && (!matched); j++)
+		Symbol acceptedCulture = cultureRules.resolve(*i, religion, tag, oldCapital);
+		if (!acceptedCulture.empty())
 		{
-			if (j->srcCulture == *i)
-			{
-				bool match = true;
-				for (std::vector<distinguisher>::const_iterator k = j->distinguishers.begin(); k != j->distinguishers.end(); k++)
-				{
-					if (k->first == DTOwner)
-					{
-						if (tag != k->second)
-						{
-							match = false;
-						}
-					}
-					else if (k->first == DTReligion)
-					{
-						if (religion != k->second)
-						{
-							match = false;
-						}
-					}
-					else if (k->first == DTRegion)
-					{
-						auto regions = regionsMap.find(oldCapital);
-						if ((regions == regionsMap.end()) || (regions->second.find(k->second) == regions->second.end()))
-						{
-							match = false;
-						}
-						else
-						{
-							match = true;
-						}
-					}
-					else
-					{
-						LOG(LogLevel::Warning) << "Unhandled distinguisher type in culture rules";
-					}
-				}
-				if (match)
-				{
-					acceptedCultures.insert(j->dstCulture);
-					matched = true;
-				}
-			}
+			acceptedCultures.insert(acceptedCulture);
 		}
-		if (!matched)
+		else
 		{
 			LOG(LogLevel::Warning) << "No culture mapping defined for " << *i << " (" << srcCountry->getTag() << " -> " << tag << ')';
 		}
@@ -643,19 +555,19 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	LOG(LogLevel::Warning) << tag << " ruling party is " << rulingParty << "//";
 
 	// Reforms
-	reforms		=  new V2Reforms(this, srcCountry);
+	reforms		=  theWorld->getArena().make<V2Reforms>(this, srcCountry);
 
 	// Relations
-	std::vector<EU3Relations*> srcRelations = srcCountry->getRelations();
+	const std::vector<EU3Relations*>& srcRelations = srcCountry->getRelations();
 	if (srcRelations.size() > 0)
 	{
-		for (std::vector<EU3Relations*>::iterator itr = srcRelations.begin(); itr != srcRelations.end(); ++itr)
+		for (std::vector<EU3Relations*>::const_iterator itr = srcRelations.begin(); itr != srcRelations.end(); ++itr)
 		{
-			const std::string& V2Tag = countryMap[(*itr)->getCountry()];
+			CountryTag V2Tag = countryMap[(*itr)->getCountry()];
 			if (!V2Tag.empty())
 			{
-				V2Relations* v2r = new V2Relations(V2Tag, *itr);
-				relations.insert(make_pair(V2Tag, v2r));
+				V2Relations* v2r = theWorld->getArena().make<V2Relations>(V2Tag, *itr);
+				relations.insert(std::make_pair(V2Tag, v2r));
 			}
 		}
 	}
@@ -712,11 +624,11 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	}
 	int numProvinces = 0;
 	int numUniversities = 0;
-	std::vector<EU3Province*> provinces = srcCountry->getProvinces();
+	const std::vector<EU3Province*>& provinces = srcCountry->getProvinces();
 	numUniversities = provinces.size();
-	for (std::vector<EU3Province*>::iterator i = provinces.begin(); i != provinces.end(); i++)
+	for (std::vector<EU3Province*>::const_iterator i = provinces.begin(); i != provinces.end(); i++)
 	{
-		if ( (*i)->hasBuilding("university") )
+		if ( (*i)->hasBuilding(BUILDING_university) )
 		{
 			numUniversities++;
 		}
@@ -755,26 +667,26 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	double industryInvestment		= srcCountry->getIndustryInvestment();
 	double cultureInvestment		= srcCountry->getCultureInvestment();
 
-	std::vector<EU3Province*> srcProvinces = srcCountry->getProvinces();
+	const std::vector<EU3Province*>& srcProvinces = srcCountry->getProvinces();
 	for(unsigned int j = 0; j < srcProvinces.size(); j++)
 	{
-		if (srcProvinces[j]->hasBuilding("weapons"))
+		if (srcProvinces[j]->hasBuilding(BUILDING_weapons))
 		{
 			armyInvestment += 50;
 		}
-		if (srcProvinces[j]->hasBuilding("wharf"))
+		if (srcProvinces[j]->hasBuilding(BUILDING_wharf))
 		{
 			navyInvestment += 50;
 		}
-		if (srcProvinces[j]->hasBuilding("refinery"))
+		if (srcProvinces[j]->hasBuilding(BUILDING_refinery))
 		{
 			commerceInvestment += 50;
 		}
-		if (srcProvinces[j]->hasBuilding("textile"))
+		if (srcProvinces[j]->hasBuilding(BUILDING_textile))
 		{
 			industryInvestment += 50;
 		}
-		if (srcProvinces[j]->hasBuilding("university"))
+		if (srcProvinces[j]->hasBuilding(BUILDING_university))
 		{
 			cultureInvestment += 50;
 		}
@@ -807,10 +719,10 @@ void V2Country::initFromEU3Country(const EU3Country* _srcCountry, const std::vec
 	techSchool = bestSchool;
 
 	// Leaders
-	std::vector<EU3Leader*> oldLeaders = srcCountry->getLeaders();
-	for (std::vector<EU3Leader*>::iterator itr = oldLeaders.begin(); itr != oldLeaders.end(); ++itr)
+	const std::vector<EU3Leader*>& oldLeaders = srcCountry->getLeaders();
+	for (std::vector<EU3Leader*>::const_iterator itr = oldLeaders.begin(); itr != oldLeaders.end(); ++itr)
 	{
-		V2Leader* leader = new V2Leader(*itr, lt);
+		V2Leader* leader = theWorld->getArena().make<V2Leader>(*itr, lt);
 		leaders.push_back(leader);
 	}
 }
@@ -910,6 +822,7 @@ void V2Country::addProvince(V2Province* _province)
 }
 
 
+template<typename Traits>
 void V2Country::addState(V2State* newState)
 {
 	int				highestNavalLevel = 0;
@@ -917,7 +830,7 @@ void V2Country::addState(V2State* newState)
 	bool				hasNavalBase		= false;
 
 	states.push_back(newState);
-	std::vector<V2Province*> newProvinces = newState->getProvinces();
+	const std::vector<V2Province*>& newProvinces = newState->getProvinces();
 	for (unsigned int i = 0; i < newProvinces.size(); i++)
 	{
 		auto itr = provinces.find(newProvinces[i]->getNum());
@@ -927,25 +840,25 @@ void V2Country::addState(V2State* newState)
 		}
 
 		// find the province with the highest naval base level
-		if ((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM"))
+		if (Traits::hasNavalBases)
 		{
 			int navalLevel = 0;
 			const EU3Province* srcProvince = newProvinces[i]->getSrcProvince();
 			if (srcProvince != nullptr)
 			{
-				if (srcProvince->hasBuilding("shipyard"))
+				if (srcProvince->hasBuilding(BUILDING_shipyard))
 				{
 					navalLevel += 1;
 				}
-				if (srcProvince->hasBuilding("grand_shipyard"))
+				if (srcProvince->hasBuilding(BUILDING_grand_shipyard))
 				{
 					navalLevel += 1;
 				}
-				if (srcProvince->hasBuilding("naval_arsenal"))
+				if (srcProvince->hasBuilding(BUILDING_naval_arsenal))
 				{
 					navalLevel += 1;
 				}
-				if (srcProvince->hasBuilding("naval_base"))
+				if (srcProvince->hasBuilding(BUILDING_naval_base))
 				{
 					navalLevel += 1;
 				}
@@ -959,7 +872,7 @@ void V2Country::addState(V2State* newState)
 		}
 	}
 
-	if (( (Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM") ) && (highestNavalLevel > 0))
+	if (Traits::hasNavalBases && (highestNavalLevel > 0))
 	{
 		newProvinces[hasHighestLevel]->setNavalBaseLevel(1);
 	}
@@ -969,8 +882,8 @@ void V2Country::addState(V2State* newState)
 //#define TEST_V2_PROVINCES
 void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_per_regiment[num_reg_categories], 
 	const inverseProvinceMapping& inverseProvinceMap,
-	const std::map<int, V2Province*>& allProvinces, 
-	const std::vector<int>& port_whitelist, const adjacencyMapping& adjacencyMap)
+	const ProvinceTable<V2Province*>& allProvinces, 
+	const std::vector<int>& port_whitelist, const AdjacencyGraph& adjacencyMap)
 {
 #ifndef TEST_V2_PROVINCES
 	if (srcCountry == nullptr)
@@ -985,10 +898,10 @@ void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_
 	// set up armies with whatever regiments they deserve, rounded down
 	// and keep track of the remainders for later
 	double countryRemainder[num_reg_categories] = { 0.0 };
-	std::vector<EU3Army*> sourceArmies = srcCountry->getArmies();
-	for (std::vector<EU3Army*>::iterator aitr = sourceArmies.begin(); aitr != sourceArmies.end(); ++aitr)
+	const std::vector<EU3Army*>& sourceArmies = srcCountry->getArmies();
+	for (std::vector<EU3Army*>::const_iterator aitr = sourceArmies.begin(); aitr != sourceArmies.end(); ++aitr)
 	{
-		V2Army* army = new V2Army(*aitr, leaderIDMap);
+		V2Army* army = theWorld->getArena().make<V2Army>(*aitr, leaderIDMap, theWorld->getNextArmyID());
 
 		for (int rc = infantry; rc < num_reg_categories; ++rc)
 		{
@@ -1044,7 +957,7 @@ void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_
 		// guarantee that navies are assigned to sea provinces, or land provinces with naval bases
 		if (army->getNavy())
 		{
-			std::map<int, V2Province*>::const_iterator pitr = allProvinces.find(locationCandidates[0]);
+			ProvinceTable<V2Province*>::const_iterator pitr = allProvinces.find(locationCandidates[0]);
 			if (pitr != allProvinces.end())
 			{
 				usePort = true;
@@ -1057,8 +970,8 @@ void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_
 					// added
 					army->noUse();
 
-					LOG(LogLevel::Warning) << "Navy " << (*aitr)->getName() << " assigned to EU3 province " 
-						<< (*aitr)->getLocation() << " which has no corresponding V2 port provinces; dissolving to pool";
+					DIAGNOSE(LogLevel::Warning, "Navy assigned to an EU3 province with no corresponding V2 port provinces; dissolving to pool")
+						<< (*aitr)->getName() << " in EU3 province " << (*aitr)->getLocation();
 					int regimentCounts[num_reg_categories] = { 0 };
 					army->getRegimentCounts(regimentCounts);
 					for (int rc = infantry; rc < num_reg_categories; ++rc)
@@ -1075,8 +988,8 @@ void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_
 			std::vector<int>::const_iterator white = std::find(port_whitelist.begin(), port_whitelist.end(), selectedLocation);
 			if (white == port_whitelist.end())
 			{
-				LOG(LogLevel::Warning) << "Assigning navy to non-whitelisted port province " << selectedLocation
-					<< " - if the save crashes, try blacklisting this province";
+				DIAGNOSE(LogLevel::Warning, "Assigning navy to non-whitelisted port province - if the save crashes, try blacklisting it")
+					<< selectedLocation;
 
 				army->noUse();
 			}
@@ -1129,7 +1042,7 @@ void V2Country::convertArmies(const std::map<int,int>& leaderIDMap, double cost_
 			army.setAtSea(0);
 			army.setNavy(true);
 			army.setLocation(pitr->getNum());
-			V2Regiment reg(heavy_ship);
+			V2Regiment reg(heavy_ship, theWorld->getNextArmyID());
 			reg.setStrength(100);
 			army.addRegiment(reg);
 			itr->addArmy(army);
@@ -1230,7 +1143,7 @@ void V2Country::getNationalValueScores(int& libertyScore, int& equalityScore, in
 
 void V2Country::addRelation(V2Relations* newRelation)
 {
-	relations.insert(make_pair(newRelation->getTag(), newRelation));
+	relations.insert(std::make_pair(newRelation->getTag(), newRelation));
 }
 
 
@@ -1259,32 +1172,11 @@ bool V2Country::addFactory(V2Factory* factory)
 	}
 	
 	// check factory inventions
-	if ((Configuration::getV2Gametype() == "vanilla") || (Configuration::getV2Gametype() == "AHD"))
-	{
-		vanillaInventionType requiredInvention = factory->getVanillaRequiredInvention();
-		if (requiredInvention >= 0 && vanillaInventions[requiredInvention] != active)
-		{
-			LOG(LogLevel::Debug) << tag << " rejected " << factory->getTypeName() << " (missing required invention: " << vanillaInventionNames[requiredInvention] << ')';
-			return false;
-		}
-	}
-	else if (Configuration::getV2Gametype() == "HOD")
-	{
-		HODInventionType requiredInvention = factory->getHODRequiredInvention();
-		if (requiredInvention >= 0 && HODInventions[requiredInvention] != active)
-		{
-			LOG(LogLevel::Debug) << tag << " rejected " << factory->getTypeName() << " (missing required invention: " << HODInventionNames[requiredInvention] << ')';
-			return false;
-		}
-	}
-	else if (Configuration::getV2Gametype() == "HoD-NNM")
+	int requiredInvention = factory->getRequiredInvention();
+	if ((requiredInvention >= 0) && (inventions[requiredInvention] != active))
 	{
-		HODNNMInventionType requiredInvention = factory->getHODNNMRequiredInvention();
-		if (requiredInvention >= 0 && HODNNMInventions[requiredInvention] != active)
-		{
-			LOG(LogLevel::Debug) << tag << " rejected " << factory->getTypeName() << " (missing reqd invention: " << HODNNMInventionNames[requiredInvention] << ')';
-			return false;
-		}
+		LOG(LogLevel::Debug) << tag << " rejected " << factory->getTypeName() << " (missing required invention: " << getV2InventionName(requiredInvention) << ')';
+		return false;
 	}
 
 	// find a state to add the factory to, which meets the factory's requirements
@@ -1312,11 +1204,11 @@ bool V2Country::addFactory(V2Factory* factory)
 			continue;
 		}
 
-		std::map<std::string,float> requiredProducts = factory->getRequiredRGO();
+		const std::map<std::string,float>& requiredProducts = factory->getRequiredRGO();
 		if (requiredProducts.size() > 0)
 		{
 			bool hasInput = false;
-			for (std::map<std::string,float>::iterator prod = requiredProducts.begin(); prod != requiredProducts.end(); ++prod)
+			for (std::map<std::string,float>::const_iterator prod = requiredProducts.begin(); prod != requiredProducts.end(); ++prod)
 			{
 				if ( (*itr)->hasLocalSupply(prod->first) )
 				{
@@ -1362,10 +1254,10 @@ void V2Country::addRailroadtoCapitalState()
 }
 
 
+template<typename Traits>
 void V2Country::convertUncivReforms()
 {
-	if ((srcCountry != nullptr) && ((Configuration::getV2Gametype() == "AHD") || (Configuration::getV2Gametype() == "HOD") 
-		|| (Configuration::getV2Gametype() == "HoD-NNM")))
+	if ((srcCountry != nullptr) && Traits::hasUncivilizedNations)
 	{
 		if (	(srcCountry->getTechGroup() == "western") || (srcCountry->getTechGroup() == "latin") ||
 				(srcCountry->getTechGroup() == "eastern") || (srcCountry->getTechGroup() == "ottoman"))
@@ -1380,7 +1272,7 @@ void V2Country::convertUncivReforms()
 			double militaryDev		= ( srcCountry->getLandTech() + srcCountry->getNavalTech() ) / totalTechs;
 			double socioEconDev		= ( srcCountry->getGovernmentTech() + srcCountry->getTradeTech() + srcCountry->getProductionTech() ) / totalTechs;
 			LOG(LogLevel::Debug) << "Setting unciv reforms for " << tag << " - westernization at 0%";
-			uncivReforms	= new V2UncivReforms(0, militaryDev, socioEconDev, this);
+			uncivReforms	= theWorld->getArena().make<V2UncivReforms>(0, militaryDev, socioEconDev, this);
 			government		= "absolute_monarchy";
 		}
 		else if ( (srcCountry->getTechGroup() == "indian") || (srcCountry->getTechGroup() == "chinese") )
@@ -1390,7 +1282,7 @@ void V2Country::convertUncivReforms()
 			double militaryDev		= (srcCountry->getLandTech() + srcCountry->getNavalTech() ) / totalTechs;
 			double socioEconDev		= (srcCountry->getGovernmentTech() + srcCountry->getTradeTech() + srcCountry->getProductionTech() ) / totalTechs;
 			LOG(LogLevel::Debug) << "Setting unciv reforms for " << tag << " - westernization at 30%";
-			uncivReforms	= new V2UncivReforms(30, militaryDev, socioEconDev, this);
+			uncivReforms	= theWorld->getArena().make<V2UncivReforms>(30, militaryDev, socioEconDev, this);
 			government		= "absolute_monarchy";
 		}
 		else if (srcCountry->getTechGroup() == "muslim")
@@ -1400,7 +1292,7 @@ void V2Country::convertUncivReforms()
 			double militaryDev		= ( srcCountry->getLandTech() + srcCountry->getNavalTech() ) / totalTechs;
 			double socioEconDev		= ( srcCountry->getGovernmentTech() + srcCountry->getTradeTech() + srcCountry->getProductionTech() ) / totalTechs;
 			LOG(LogLevel::Debug) << "Setting unciv reforms for " << tag << " - westernization at 60%";
-			uncivReforms	= new V2UncivReforms(60, militaryDev, socioEconDev, this);
+			uncivReforms	= theWorld->getArena().make<V2UncivReforms>(60, militaryDev, socioEconDev, this);
 			government		= "absolute_monarchy";
 		}
 		else
@@ -1410,7 +1302,7 @@ void V2Country::convertUncivReforms()
 											  srcCountry->getTradeTech() + srcCountry->getProductionTech();
 			double militaryDev		= ( srcCountry->getLandTech() + srcCountry->getNavalTech() ) / totalTechs;
 			double socioEconDev		= ( srcCountry->getGovernmentTech() + srcCountry->getTradeTech() + srcCountry->getProductionTech() ) / totalTechs;
-			uncivReforms	= new V2UncivReforms(0, militaryDev, socioEconDev, this);
+			uncivReforms	= theWorld->getArena().make<V2UncivReforms>(0, militaryDev, socioEconDev, this);
 			government		= "absolute_monarchy";
 		}
 	}
@@ -1425,14 +1317,14 @@ void V2Country::setupPops(EU3World& sourceWorld, double popWeightRatio)
 	// create the pops
 	for (auto itr = provinces.begin(); itr != provinces.end(); ++itr)
 	{
-		itr->second->doCreatePops(sourceWorld.getWorldType(), popWeightRatio, this);
+		itr->second->doCreatePops(sourceWorld.getWorldType(), popWeightRatio, this, theWorld->getPopPool());
 	}
 
 	// output statistics on pops
 	std::map<std::string, long int> popsData;
 	for (auto provItr = provinces.begin(); provItr != provinces.end(); ++provItr)
 	{
-		auto pops = provItr->second->getPops();
+		const auto& pops = provItr->second->getPops();
 		for (auto popsItr = pops.begin(); popsItr != pops.end(); ++popsItr)
 		{
 			auto popItr = popsData.find( (*popsItr)->getType() );
@@ -1466,6 +1358,7 @@ void V2Country::setupPops(EU3World& sourceWorld, double popWeightRatio)
 }
 
 
+template<typename Traits>
 void V2Country::setArmyTech(double mean, double highest)
 {
 	if (srcCountry == nullptr)
@@ -1476,13 +1369,13 @@ void V2Country::setArmyTech(double mean, double highest)
 	double newTechLevel = (srcCountry->getLandTech() - mean) / (highest - mean);
 	LOG(LogLevel::Debug) << tag << " has army tech of " << newTechLevel;
 
-	if ( (Configuration::getV2Gametype() == "vanilla") || (civilized == true) )
+	if ( (!Traits::hasUncivilizedNations) || (civilized == true) )
 	{
 		if (newTechLevel >= -1.0)
 		{
 			techs.push_back("flintlock_rifles");
-			HODInventions[HOD_flintlock_rifle_armament] = active;
-			HODNNMInventions[HOD_NNM_flintlock_rifle_armament] = active;
+			activateInvention<Traits>(HOD_flintlock_rifle_armament);
+			activateInvention<Traits>(HOD_NNM_flintlock_rifle_armament);
 		}
 		if (newTechLevel >= -0.9)
 		{
@@ -1491,8 +1384,8 @@ void V2Country::setArmyTech(double mean, double highest)
 		if (newTechLevel >= -0.2)
 		{
 			techs.push_back("post_napoleonic_thought");
-			HODInventions[HOD_post_napoleonic_army_doctrine]			= active;
-			HODNNMInventions[HOD_NNM_post_napoleonic_army_doctrine]	= active;
+			activateInvention<Traits>(HOD_post_napoleonic_army_doctrine);
+			activateInvention<Traits>(HOD_NNM_post_napoleonic_army_doctrine);
 		}
 		if (newTechLevel >= 0.2)
 		{
@@ -1501,30 +1394,31 @@ void V2Country::setArmyTech(double mean, double highest)
 		if (newTechLevel >= 0.6)
 		{
 			techs.push_back("military_staff_system");
-			HODInventions[HOD_cuirassier_activation]			= active;
-			HODInventions[HOD_dragoon_activation]				= active;
-			HODInventions[HOD_hussar_activation]				= active;
-			HODNNMInventions[HOD_NNM_cuirassier_activation]	= active;
-			HODNNMInventions[HOD_NNM_dragoon_activation]		= active;
-			HODNNMInventions[HOD_NNM_hussar_activation]		= active;
+			activateInvention<Traits>(HOD_cuirassier_activation);
+			activateInvention<Traits>(HOD_dragoon_activation);
+			activateInvention<Traits>(HOD_hussar_activation);
+			activateInvention<Traits>(HOD_NNM_cuirassier_activation);
+			activateInvention<Traits>(HOD_NNM_dragoon_activation);
+			activateInvention<Traits>(HOD_NNM_hussar_activation);
 		}
 		if (newTechLevel >= 1.0)
 		{
 			techs.push_back("army_professionalism");
-			vanillaInventions[VANILLA_army_academic_training]	= active;
-			vanillaInventions[VANILLA_field_training]				= active;
-			vanillaInventions[VANILLA_army_societal_status]		= active;
-			HODInventions[HOD_army_academic_training]				= active;
-			HODInventions[HOD_field_training]						= active;
-			HODInventions[HOD_army_societal_status]				= active;
-			HODNNMInventions[HOD_NNM_army_academic_training]	= active;
-			HODNNMInventions[HOD_NNM_field_training]				= active;
-			HODNNMInventions[HOD_NNM_army_societal_status]		= active;
+			activateInvention<Traits>(VANILLA_army_academic_training);
+			activateInvention<Traits>(VANILLA_field_training);
+			activateInvention<Traits>(VANILLA_army_societal_status);
+			activateInvention<Traits>(HOD_army_academic_training);
+			activateInvention<Traits>(HOD_field_training);
+			activateInvention<Traits>(HOD_army_societal_status);
+			activateInvention<Traits>(HOD_NNM_army_academic_training);
+			activateInvention<Traits>(HOD_NNM_field_training);
+			activateInvention<Traits>(HOD_NNM_army_societal_status);
 		}
 	}
 }
 
 
+template<typename Traits>
 void V2Country::setNavyTech(double mean, double highest)
 {
 	if (srcCountry == nullptr)
@@ -1535,15 +1429,15 @@ void V2Country::setNavyTech(double mean, double highest)
 	double newTechLevel = (srcCountry->getNavalTech() - mean) / (highest - mean);
 	LOG(LogLevel::Debug) << tag << " has navy tech of " << newTechLevel;
 
-	if ( (Configuration::getV2Gametype() == "vanilla") || (civilized == true) )
+	if ( (!Traits::hasUncivilizedNations) || (civilized == true) )
 	{
 		if (newTechLevel >= 0)
 		{
 			techs.push_back("post_nelsonian_thought");
-			HODInventions[HOD_long_range_fire_tactic]					= active;
-			HODInventions[HOD_speedy_maneuvering_tactic]				= active;
-			HODNNMInventions[HOD_NNM_long_range_fire_tactic]		= active;
-			HODNNMInventions[HOD_NNM_speedy_maneuvering_tactic]	= active;
+			activateInvention<Traits>(HOD_long_range_fire_tactic);
+			activateInvention<Traits>(HOD_speedy_maneuvering_tactic);
+			activateInvention<Traits>(HOD_NNM_long_range_fire_tactic);
+			activateInvention<Traits>(HOD_NNM_speedy_maneuvering_tactic);
 		}
 		if (newTechLevel >= 0.036)
 		{
@@ -1554,50 +1448,51 @@ void V2Country::setNavyTech(double mean, double highest)
 			techs.push_back("clipper_design");
 			techs.push_back("naval_design_bureaus");
 			techs.push_back("alphabetic_flag_signaling");
-			vanillaInventions[VANILLA_building_station_shipyards]	= active;
-			HODInventions[HOD_building_station_shipyards]			= active;
-			HODNNMInventions[HOD_NNM_building_station_shipyards]	= active;
+			activateInvention<Traits>(VANILLA_building_station_shipyards);
+			activateInvention<Traits>(HOD_building_station_shipyards);
+			activateInvention<Traits>(HOD_NNM_building_station_shipyards);
 		}
 		if (newTechLevel >= 0.857)
 		{
 			techs.push_back("battleship_column_doctrine");
 			techs.push_back("steamers");
-			vanillaInventions[VANILLA_long_range_fire_tactic]						= active;
-			HODInventions[HOD_long_range_fire_tactic]									= active;
-			HODNNMInventions[HOD_NNM_long_range_fire_tactic]						= active;
-			vanillaInventions[VANILLA_speedy_maneuvering_tactic]					= active;
-			HODInventions[HOD_speedy_maneuvering_tactic]								= active;
-			HODNNMInventions[HOD_NNM_speedy_maneuvering_tactic]					= active;
-			vanillaInventions[VANILLA_mechanized_fishing_vessels]					= active;
-			HODInventions[HOD_mechanized_fishing_vessels]							= active;
-			HODNNMInventions[HOD_NNM_mechanized_fishing_vessels]					= active;
-			vanillaInventions[VANILLA_steamer_automatic_construction_plants]	= active;
-			HODInventions[HOD_steamer_automatic_construction_plants]				= active;
-			HODNNMInventions[HOD_NNM_steamer_automatic_construction_plants]	= active;
-			vanillaInventions[VANILLA_steamer_transports]							= active;
-			HODInventions[HOD_steamer_transports]										= active;
-			HODNNMInventions[HOD_NNM_steamer_transports]								= active;
-			vanillaInventions[VANILLA_commerce_raiders]								= active;
-			HODInventions[HOD_commerce_raiders]											= active;
-			HODNNMInventions[HOD_NNM_commerce_raiders]								= active;
+			activateInvention<Traits>(VANILLA_long_range_fire_tactic);
+			activateInvention<Traits>(HOD_long_range_fire_tactic);
+			activateInvention<Traits>(HOD_NNM_long_range_fire_tactic);
+			activateInvention<Traits>(VANILLA_speedy_maneuvering_tactic);
+			activateInvention<Traits>(HOD_speedy_maneuvering_tactic);
+			activateInvention<Traits>(HOD_NNM_speedy_maneuvering_tactic);
+			activateInvention<Traits>(VANILLA_mechanized_fishing_vessels);
+			activateInvention<Traits>(HOD_mechanized_fishing_vessels);
+			activateInvention<Traits>(HOD_NNM_mechanized_fishing_vessels);
+			activateInvention<Traits>(VANILLA_steamer_automatic_construction_plants);
+			activateInvention<Traits>(HOD_steamer_automatic_construction_plants);
+			activateInvention<Traits>(HOD_NNM_steamer_automatic_construction_plants);
+			activateInvention<Traits>(VANILLA_steamer_transports);
+			activateInvention<Traits>(HOD_steamer_transports);
+			activateInvention<Traits>(HOD_NNM_steamer_transports);
+			activateInvention<Traits>(VANILLA_commerce_raiders);
+			activateInvention<Traits>(HOD_commerce_raiders);
+			activateInvention<Traits>(HOD_NNM_commerce_raiders);
 		}
 		if (newTechLevel >= 1.0)
 		{
 			techs.push_back("naval_professionalism");
-			vanillaInventions[VANILLA_academic_training]			= active;
-			vanillaInventions[VANILLA_combat_station_training]	= active;
-			vanillaInventions[VANILLA_societal_status]			= active;
-			HODInventions[HOD_academic_training]					= active;
-			HODInventions[HOD_combat_station_training]			= active;
-			HODInventions[HOD_societal_status]						= active;
-			HODNNMInventions[HOD_NNM_academic_training]			= active;
-			HODNNMInventions[HOD_NNM_combat_station_training]	= active;
-			HODNNMInventions[HOD_NNM_societal_status]				= active;
+			activateInvention<Traits>(VANILLA_academic_training);
+			activateInvention<Traits>(VANILLA_combat_station_training);
+			activateInvention<Traits>(VANILLA_societal_status);
+			activateInvention<Traits>(HOD_academic_training);
+			activateInvention<Traits>(HOD_combat_station_training);
+			activateInvention<Traits>(HOD_societal_status);
+			activateInvention<Traits>(HOD_NNM_academic_training);
+			activateInvention<Traits>(HOD_NNM_combat_station_training);
+			activateInvention<Traits>(HOD_NNM_societal_status);
 		}
 	}
 }
 
 
+template<typename Traits>
 void V2Country::setCommerceTech(double mean, double highest)
 {
 	if (srcCountry == nullptr)
@@ -1608,7 +1503,7 @@ void V2Country::setCommerceTech(double mean, double highest)
 	double newTechLevel = (srcCountry->getTradeTech() - mean) / (highest - mean);
 	LOG(LogLevel::Debug) << tag << " has commerce tech of " << newTechLevel;
 
-	if ( (Configuration::getV2Gametype() == "vanilla") || (civilized == true) )
+	if ( (!Traits::hasUncivilizedNations) || (civilized == true) )
 	{
 		techs.push_back("no_standard");
 		if (newTechLevel >= -0.777)
@@ -1626,66 +1521,67 @@ void V2Country::setCommerceTech(double mean, double highest)
 		if (newTechLevel >= -0.277)
 		{
 			techs.push_back("freedom_of_trade");
-			vanillaInventions[VANILLA_john_ramsay_mcculloch]	= active;
-			HODInventions[HOD_john_ramsay_mcculloch]				= active;
-			HODNNMInventions[HOD_NNM_john_ramsay_mcculloch]		= active;
-			vanillaInventions[VANILLA_nassau_william_sr]			= active;
-			HODInventions[HOD_nassau_william_sr]					= active;
-			HODNNMInventions[HOD_NNM_nassau_william_sr]			= active;
-			vanillaInventions[VANILLA_james_mill]					= active;
-			HODInventions[HOD_james_mill]								= active;
-			HODNNMInventions[HOD_NNM_james_mill]					= active;
+			activateInvention<Traits>(VANILLA_john_ramsay_mcculloch);
+			activateInvention<Traits>(HOD_john_ramsay_mcculloch);
+			activateInvention<Traits>(HOD_NNM_john_ramsay_mcculloch);
+			activateInvention<Traits>(VANILLA_nassau_william_sr);
+			activateInvention<Traits>(HOD_nassau_william_sr);
+			activateInvention<Traits>(HOD_NNM_nassau_william_sr);
+			activateInvention<Traits>(VANILLA_james_mill);
+			activateInvention<Traits>(HOD_james_mill);
+			activateInvention<Traits>(HOD_NNM_james_mill);
 		}
 		if (newTechLevel >= 0.333)
 		{
 			techs.push_back("stock_exchange");
-			vanillaInventions[VANILLA_multitude_of_financial_instruments]		= active;
-			HODInventions[HOD_multitude_of_financial_instruments]					= active;
-			HODNNMInventions[HOD_NNM_multitude_of_financial_instruments]		= active;
-			vanillaInventions[VANILLA_insurance_companies]							= active;
-			HODInventions[HOD_insurance_companies]										= active;
-			HODNNMInventions[HOD_NNM_insurance_companies]							= active;
-			vanillaInventions[VANILLA_regulated_buying_and_selling_of_stocks]	= active;
-			HODInventions[HOD_regulated_buying_and_selling_of_stocks]			= active;
-			HODNNMInventions[HOD_NNM_regulated_buying_and_selling_of_stocks]	= active;
+			activateInvention<Traits>(VANILLA_multitude_of_financial_instruments);
+			activateInvention<Traits>(HOD_multitude_of_financial_instruments);
+			activateInvention<Traits>(HOD_NNM_multitude_of_financial_instruments);
+			activateInvention<Traits>(VANILLA_insurance_companies);
+			activateInvention<Traits>(HOD_insurance_companies);
+			activateInvention<Traits>(HOD_NNM_insurance_companies);
+			activateInvention<Traits>(VANILLA_regulated_buying_and_selling_of_stocks);
+			activateInvention<Traits>(HOD_regulated_buying_and_selling_of_stocks);
+			activateInvention<Traits>(HOD_NNM_regulated_buying_and_selling_of_stocks);
 		}
 		if (newTechLevel >= 0.777)
 		{
 			techs.push_back("ad_hoc_money_bill_printing");
 			techs.push_back("market_structure");
-			vanillaInventions[VANILLA_silver_standard]			= active;
-			HODInventions[HOD_silver_standard]						= active;
-			HODNNMInventions[HOD_NNM_silver_standard]				= active;
-			vanillaInventions[VANILLA_decimal_monetary_system]	= active;
-			HODInventions[HOD_decimal_monetary_system]			= active;
-			HODNNMInventions[HOD_NNM_decimal_monetary_system]	= active;
-			vanillaInventions[VANILLA_polypoly_structure]		= active;
-			HODInventions[HOD_polypoly_structure]					= active;
-			HODNNMInventions[HOD_NNM_polypoly_structure]			= active;
-			vanillaInventions[VANILLA_oligopoly_structure]		= active;
-			HODInventions[HOD_oligopoly_structure]					= active;
-			HODNNMInventions[HOD_NNM_oligopoly_structure]		= active;
-			vanillaInventions[VANILLA_monopoly_structure]		= active;
-			HODInventions[HOD_monopoly_structure]					= active;
-			HODNNMInventions[HOD_NNM_monopoly_structure]			= active;
+			activateInvention<Traits>(VANILLA_silver_standard);
+			activateInvention<Traits>(HOD_silver_standard);
+			activateInvention<Traits>(HOD_NNM_silver_standard);
+			activateInvention<Traits>(VANILLA_decimal_monetary_system);
+			activateInvention<Traits>(HOD_decimal_monetary_system);
+			activateInvention<Traits>(HOD_NNM_decimal_monetary_system);
+			activateInvention<Traits>(VANILLA_polypoly_structure);
+			activateInvention<Traits>(HOD_polypoly_structure);
+			activateInvention<Traits>(HOD_NNM_polypoly_structure);
+			activateInvention<Traits>(VANILLA_oligopoly_structure);
+			activateInvention<Traits>(HOD_oligopoly_structure);
+			activateInvention<Traits>(HOD_NNM_oligopoly_structure);
+			activateInvention<Traits>(VANILLA_monopoly_structure);
+			activateInvention<Traits>(HOD_monopoly_structure);
+			activateInvention<Traits>(HOD_NNM_monopoly_structure);
 		}
 		if (newTechLevel >= 1.0)
 		{
 			techs.push_back("late_classical_theory");
-			vanillaInventions[VANILLA_john_elliot_cairnes]	= active;
-			vanillaInventions[VANILLA_robert_torrens]			= active;
-			vanillaInventions[VANILLA_john_stuart_mill]		= active;
-			HODInventions[HOD_john_elliot_cairnes]				= active;
-			HODInventions[HOD_robert_torrens]					= active;
-			HODInventions[HOD_john_stuart_mill]					= active;
-			HODNNMInventions[HOD_NNM_john_elliot_cairnes]	= active;
-			HODNNMInventions[HOD_NNM_robert_torrens]			= active;
-			HODNNMInventions[HOD_NNM_john_stuart_mill]		= active;
+			activateInvention<Traits>(VANILLA_john_elliot_cairnes);
+			activateInvention<Traits>(VANILLA_robert_torrens);
+			activateInvention<Traits>(VANILLA_john_stuart_mill);
+			activateInvention<Traits>(HOD_john_elliot_cairnes);
+			activateInvention<Traits>(HOD_robert_torrens);
+			activateInvention<Traits>(HOD_john_stuart_mill);
+			activateInvention<Traits>(HOD_NNM_john_elliot_cairnes);
+			activateInvention<Traits>(HOD_NNM_robert_torrens);
+			activateInvention<Traits>(HOD_NNM_john_stuart_mill);
 		}
 	}
 }
 
 
+template<typename Traits>
 void V2Country::setIndustryTech(double mean, double highest)
 {
 	if (srcCountry == nullptr)
@@ -1696,12 +1592,12 @@ void V2Country::setIndustryTech(double mean, double highest)
 	double newTechLevel = (srcCountry->getProductionTech() - mean) / (highest - mean);
 	LOG(LogLevel::Debug) << tag << " has industry tech of " << newTechLevel;
 
-	if ( (Configuration::getV2Gametype() == "vanilla") || (civilized == true) )
+	if ( (!Traits::hasUncivilizedNations) || (civilized == true) )
 	{
 		if (newTechLevel >= -1.0)
 		{
 			techs.push_back("water_wheel_power");
-			HODInventions[HOD_tulls_seed_drill]	= active;
+			activateInvention<Traits>(HOD_tulls_seed_drill);
 		}
 		if (newTechLevel >= -0.714)
 		{
@@ -1711,24 +1607,24 @@ void V2Country::setIndustryTech(double mean, double highest)
 		{
 			techs.push_back("mechanized_mining");
 			techs.push_back("basic_chemistry");
-			vanillaInventions[VANILLA_ammunition_production]	= active;
-			HODInventions[HOD_ammunition_production]				= active;
-			HODNNMInventions[HOD_NNM_ammunition_production]		= active;
-			vanillaInventions[VANILLA_small_arms_production]	= active;
-			HODInventions[HOD_small_arms_production]				= active;
-			HODNNMInventions[HOD_NNM_small_arms_production]		= active;
-			vanillaInventions[VANILLA_explosives_production]	= active;
-			HODInventions[HOD_explosives_production]				= active;
-			HODNNMInventions[HOD_NNM_explosives_production]		= active;
-			vanillaInventions[VANILLA_artillery_production]		= active;
-			HODInventions[HOD_artillery_production]				= active;
-			HODNNMInventions[HOD_NNM_artillery_production]		= active;
+			activateInvention<Traits>(VANILLA_ammunition_production);
+			activateInvention<Traits>(HOD_ammunition_production);
+			activateInvention<Traits>(HOD_NNM_ammunition_production);
+			activateInvention<Traits>(VANILLA_small_arms_production);
+			activateInvention<Traits>(HOD_small_arms_production);
+			activateInvention<Traits>(HOD_NNM_small_arms_production);
+			activateInvention<Traits>(VANILLA_explosives_production);
+			activateInvention<Traits>(HOD_explosives_production);
+			activateInvention<Traits>(HOD_NNM_explosives_production);
+			activateInvention<Traits>(VANILLA_artillery_production);
+			activateInvention<Traits>(HOD_artillery_production);
+			activateInvention<Traits>(HOD_NNM_artillery_production);
 		}
 		if (newTechLevel >= 0.143)
 		{
 			techs.push_back("practical_steam_engine");
-			HODInventions[HOD_rotherham_plough]						= active;
-			HODNNMInventions[HOD_NNM_rotherham_plough]			= active;
+			activateInvention<Traits>(HOD_rotherham_plough);
+			activateInvention<Traits>(HOD_NNM_rotherham_plough);
 		}
 		if (newTechLevel >= 0.428)
 		{
@@ -1737,47 +1633,48 @@ void V2Country::setIndustryTech(double mean, double highest)
 		if (newTechLevel >= 0.714)
 		{
 			techs.push_back("mechanical_production");
-			HODInventions[HOD_sharp_n_roberts_power_loom]						= active;
-			HODNNMInventions[HOD_NNM_sharp_n_roberts_power_loom]				= active;
-			vanillaInventions[VANILLA_sharp_n_roberts_power_loom]				= active;
-			HODInventions[HOD_jacquard_power_loom]									= active;
-			HODNNMInventions[HOD_NNM_jacquard_power_loom]						= active;
-			vanillaInventions[VANILLA_jacquard_power_loom]						= active;
-			HODInventions[HOD_northrop_power_loom]									= active;
-			HODNNMInventions[HOD_NNM_northrop_power_loom]						= active;
-			vanillaInventions[VANILLA_northrop_power_loom]						= active;
-			HODInventions[HOD_mechanical_saw]										= active;
-			HODNNMInventions[HOD_NNM_mechanical_saw]								= active;
-			vanillaInventions[VANILLA_mechanical_saw]								= active;
-			HODInventions[HOD_mechanical_precision_saw]							= active;
-			HODNNMInventions[HOD_NNM_mechanical_precision_saw]					= active;
-			vanillaInventions[VANILLA_mechanical_precision_saw]				= active;
-			HODInventions[HOD_hussey_n_mccormicks_reaping_machine]			= active;
-			HODNNMInventions[HOD_NNM_hussey_n_mccormicks_reaping_machine]	= active;
-			vanillaInventions[VANILLA_hussey_n_mccormicks_reaping_machine]	= active;
-			HODInventions[HOD_pitts_threshing_machine]							= active;
-			HODNNMInventions[HOD_NNM_pitts_threshing_machine]					= active;
-			vanillaInventions[VANILLA_pitts_threshing_machine]					= active;
-			HODInventions[HOD_mechanized_slaughtering_block]					= active;
-			HODNNMInventions[HOD_NNM_mechanized_slaughtering_block]			= active;
-			vanillaInventions[VANILLA_mechanized_slaughtering_block]			= active;
-			HODInventions[HOD_precision_work]										= active;
-			HODNNMInventions[HOD_NNM_precision_work]								= active;
+			activateInvention<Traits>(HOD_sharp_n_roberts_power_loom);
+			activateInvention<Traits>(HOD_NNM_sharp_n_roberts_power_loom);
+			activateInvention<Traits>(VANILLA_sharp_n_roberts_power_loom);
+			activateInvention<Traits>(HOD_jacquard_power_loom);
+			activateInvention<Traits>(HOD_NNM_jacquard_power_loom);
+			activateInvention<Traits>(VANILLA_jacquard_power_loom);
+			activateInvention<Traits>(HOD_northrop_power_loom);
+			activateInvention<Traits>(HOD_NNM_northrop_power_loom);
+			activateInvention<Traits>(VANILLA_northrop_power_loom);
+			activateInvention<Traits>(HOD_mechanical_saw);
+			activateInvention<Traits>(HOD_NNM_mechanical_saw);
+			activateInvention<Traits>(VANILLA_mechanical_saw);
+			activateInvention<Traits>(HOD_mechanical_precision_saw);
+			activateInvention<Traits>(HOD_NNM_mechanical_precision_saw);
+			activateInvention<Traits>(VANILLA_mechanical_precision_saw);
+			activateInvention<Traits>(HOD_hussey_n_mccormicks_reaping_machine);
+			activateInvention<Traits>(HOD_NNM_hussey_n_mccormicks_reaping_machine);
+			activateInvention<Traits>(VANILLA_hussey_n_mccormicks_reaping_machine);
+			activateInvention<Traits>(HOD_pitts_threshing_machine);
+			activateInvention<Traits>(HOD_NNM_pitts_threshing_machine);
+			activateInvention<Traits>(VANILLA_pitts_threshing_machine);
+			activateInvention<Traits>(HOD_mechanized_slaughtering_block);
+			activateInvention<Traits>(HOD_NNM_mechanized_slaughtering_block);
+			activateInvention<Traits>(VANILLA_mechanized_slaughtering_block);
+			activateInvention<Traits>(HOD_precision_work);
+			activateInvention<Traits>(HOD_NNM_precision_work);
 		}
 		if (newTechLevel >= 1.0)
 		{
 			techs.push_back("clean_coal");
-			vanillaInventions[VANILLA_pit_coal]	= active;
-			vanillaInventions[VANILLA_coke]		= active;
-			HODInventions[HOD_pit_coal]			= active;
-			HODInventions[HOD_coke]					= active;
-			HODNNMInventions[HOD_NNM_pit_coal]	= active;
-			HODNNMInventions[HOD_NNM_coke]		= active;
+			activateInvention<Traits>(VANILLA_pit_coal);
+			activateInvention<Traits>(VANILLA_coke);
+			activateInvention<Traits>(HOD_pit_coal);
+			activateInvention<Traits>(HOD_coke);
+			activateInvention<Traits>(HOD_NNM_pit_coal);
+			activateInvention<Traits>(HOD_NNM_coke);
 		}
 	}
 }
 
 
+template<typename Traits>
 void V2Country::setCultureTech(double mean, double highest)
 {
 	if (srcCountry == nullptr)
@@ -1788,23 +1685,23 @@ void V2Country::setCultureTech(double mean, double highest)
 	double newTechLevel = (srcCountry->getGovernmentTech() - mean) / (highest - mean);
 	LOG(LogLevel::Debug) << tag << " has culture tech of " << newTechLevel;
 
-	if ( (Configuration::getV2Gametype() == "vanilla") || (civilized == true) )
+	if ( (!Traits::hasUncivilizedNations) || (civilized == true) )
 	{
 		techs.push_back("classicism_n_early_romanticism");
-		HODNNMInventions[HOD_NNM_carlism] = active;
+		activateInvention<Traits>(HOD_NNM_carlism);
 		techs.push_back("late_enlightenment_philosophy");
 		if (newTechLevel >= -0.333)
 		{
 			techs.push_back("enlightenment_thought");
-			HODNNMInventions[HOD_NNM_declaration_of_the_rights_of_man]	= active;
-			HODInventions[HOD_paternalism]			= active;
-			HODNNMInventions[HOD_NNM_caste_privileges] = active;
-			HODNNMInventions[HOD_NNM_sati_abolished] = active;
-			HODInventions[HOD_constitutionalism]	= active;
-			HODNNMInventions[HOD_NNM_pig_fat_cartridges] = active;
-			HODInventions[HOD_atheism]					= active;
-			HODInventions[HOD_egalitarianism]		= active;
-			HODInventions[HOD_rationalism]			= active;
+			activateInvention<Traits>(HOD_NNM_declaration_of_the_rights_of_man);
+			activateInvention<Traits>(HOD_paternalism);
+			activateInvention<Traits>(HOD_NNM_caste_privileges);
+			activateInvention<Traits>(HOD_NNM_sati_abolished);
+			activateInvention<Traits>(HOD_constitutionalism);
+			activateInvention<Traits>(HOD_NNM_pig_fat_cartridges);
+			activateInvention<Traits>(HOD_atheism);
+			activateInvention<Traits>(HOD_egalitarianism);
+			activateInvention<Traits>(HOD_rationalism);
 		}
 		if (newTechLevel >= 0.333)
 		{
@@ -1817,23 +1714,23 @@ void V2Country::setCultureTech(double mean, double highest)
 		if (newTechLevel >= 0.666)
 		{
 			techs.push_back("romanticism");
-			vanillaInventions[VANILLA_romanticist_literature]	= active;
-			HODNNMInventions[HOD_NNM_romanticist_literature]	= active;
-			HODNNMInventions[HOD_NNM_romanticist_literature]	= active;
-			vanillaInventions[VANILLA_romanticist_art]			= active;
-			HODNNMInventions[HOD_NNM_romanticist_art]				= active;
-			HODNNMInventions[HOD_NNM_romanticist_art]				= active;
-			vanillaInventions[VANILLA_romanticist_music]			= active;
-			HODNNMInventions[HOD_NNM_romanticist_music]			= active;
-			HODNNMInventions[HOD_NNM_romanticist_music]			= active;
+			activateInvention<Traits>(VANILLA_romanticist_literature);
+			activateInvention<Traits>(HOD_NNM_romanticist_literature);
+			activateInvention<Traits>(HOD_NNM_romanticist_literature);
+			activateInvention<Traits>(VANILLA_romanticist_art);
+			activateInvention<Traits>(HOD_NNM_romanticist_art);
+			activateInvention<Traits>(HOD_NNM_romanticist_art);
+			activateInvention<Traits>(VANILLA_romanticist_music);
+			activateInvention<Traits>(HOD_NNM_romanticist_music);
+			activateInvention<Traits>(HOD_NNM_romanticist_music);
 		}
 	}
 }
 
 
-V2Relations* V2Country::getRelations(const std::string& withWhom) const
+V2Relations* V2Country::getRelations(CountryTag withWhom) const
 {
-	std::map<std::string, V2Relations*>::const_iterator i = relations.find(withWhom);
+	std::map<CountryTag, V2Relations*>::const_iterator i = relations.find(withWhom);
 	if (i != relations.end())
 	{
 		return i->second;
@@ -1854,7 +1751,7 @@ void V2Country::addLoan(const std::string& creditor, double size, double interes
 	}
 	else
 	{
-		V2Creditor* cred = new V2Creditor(creditor);
+		V2Creditor* cred = theWorld->getArena().make<V2Creditor>(creditor);
 		cred->addLoan(size, interest);
 		creditors.insert(make_pair(creditor, cred));
 	}
@@ -1863,9 +1760,9 @@ void V2Country::addLoan(const std::string& creditor, double size, double interes
 
 // return values: 0 = success, -1 = retry from pool, -2 = do not retry
 int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const inverseProvinceMapping& inverseProvinceMap, 
-	const std::map<int, V2Province*>& allProvinces, const adjacencyMapping& adjacencyMap)
+	const ProvinceTable<V2Province*>& allProvinces, const AdjacencyGraph& adjacencyMap)
 {
-	V2Regiment reg((RegimentCategory)rc);
+	V2Regiment reg((RegimentCategory)rc, theWorld->getNextArmyID());
 	int eu3Home = army->getSourceArmy()->getProbabilisticHomeProvince(rc);
 	if (eu3Home == -1)
 	{
@@ -1893,7 +1790,7 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const invers
 		if (homeCandidates.size() != 0)
 		{
 			int homeProvinceID = homeCandidates[int(homeCandidates.size() * ((double)rand() / RAND_MAX))];
-			std::map<int, V2Province*>::const_iterator pitr = allProvinces.find(homeProvinceID);
+			ProvinceTable<V2Province*>::const_iterator pitr = allProvinces.find(homeProvinceID);
 			if (pitr != allProvinces.end())
 			{
 				homeProvince = pitr->second;
@@ -1906,7 +1803,7 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const invers
 		std::vector<V2Province*> sortedHomeCandidates;
 		for (std::vector<int>::iterator nitr = homeCandidates.begin(); nitr != homeCandidates.end(); ++nitr)
 		{
-			std::map<int, V2Province*>::const_iterator pitr = allProvinces.find(*nitr);
+			ProvinceTable<V2Province*>::const_iterator pitr = allProvinces.find(*nitr);
 			if (pitr != allProvinces.end())
 			{
 				sortedHomeCandidates.push_back(pitr->second);
@@ -1923,10 +1820,10 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const invers
 		homeProvince = sortedHomeCandidates[0];
 		if (homeProvince->getOwner() != tag)
 		{
-			std::map<int, V2Province*>	openProvinces = allProvinces;
+			ProvinceTable<V2Province*>	openProvinces = allProvinces;
 			std::queue<int>					goodProvinces;
 
-			std::map<int, V2Province*>::iterator openItr = openProvinces.find(homeProvince->getNum());
+			ProvinceTable<V2Province*>::iterator openItr = openProvinces.find(homeProvince->getNum());
 			homeProvince = nullptr;
 			if ( (openItr != openProvinces.end()) && (provinces.size() > 0) )
 			{
@@ -1937,15 +1834,15 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const invers
 				{
 					int currentProvince = goodProvinces.front();
 					goodProvinces.pop();
-					if (currentProvince > static_cast<int>(adjacencyMap.size()))
+					if (currentProvince >= static_cast<int>(adjacencyMap.size()))
 					{
 						LOG(LogLevel::Warning) << "No adjacency mapping for province " << currentProvince;
 						continue;
 					}
-					std::vector<int> adjacencies = adjacencyMap[currentProvince];
+					AdjacencySpan adjacencies = adjacencyMap.neighbors(currentProvince);
 					for (unsigned int i = 0; i < adjacencies.size(); i++)
 					{
-						std::map<int, V2Province*>::iterator openItr = openProvinces.find(adjacencies[i]);
+						ProvinceTable<V2Province*>::iterator openItr = openProvinces.find(adjacencies[i]);
 						if (openItr == openProvinces.end())
 						{
 							continue;
@@ -2007,7 +1904,7 @@ int V2Country::addRegimentToArmy(V2Army* army, RegimentCategory rc, const invers
 }
 
 
-std::vector<int> V2Country::getPortProvinces(std::vector<int> locationCandidates, const std::map<int, V2Province*>& allProvinces)
+std::vector<int> V2Country::getPortProvinces(std::vector<int> locationCandidates, const ProvinceTable<V2Province*>& allProvinces)
 {
 	// hack for naval bases.  not ALL naval bases are in port provinces, and if you spawn a navy at a naval base in
 	// a non-port province, Vicky crashes....
@@ -2037,13 +1934,12 @@ std::vector<int> V2Country::getPortProvinces(std::vector<int> locationCandidates
 
 	for (std::vector<int>::iterator litr = locationCandidates.begin(); litr != locationCandidates.end(); ++litr)
 	{
-		std::map<int, V2Province*>::const_iterator pitr = allProvinces.find(*litr);
+		ProvinceTable<V2Province*>::const_iterator pitr = allProvinces.find(*litr);
 		if (pitr != allProvinces.end())
 		{
 			if ( !pitr->second->isCoastal() )
 			{
 				locationCandidates.erase(litr);
-				--pitr;
 				break;
 			}
 		}
@@ -2138,4 +2034,16 @@ std::string V2Country::getRegimentName(RegimentCategory rc)
 			break;
 	}
 	return str.str();
-}
\ No newline at end of file
+}
+
+
+// V2World picks the instantiation for the configured game, so every game's is built here
+#define INSTANTIATE_V2COUNTRY_KERNELS(TRAITS) \
+	template void V2Country::addState<TRAITS>(V2State* newState); \
+	template void V2Country::convertUncivReforms<TRAITS>(); \
+	template void V2Country::setArmyTech<TRAITS>(double mean, double highest); \
+	template void V2Country::setNavyTech<TRAITS>(double mean, double highest); \
+	template void V2Country::setCommerceTech<TRAITS>(double mean, double highest); \
+	template void V2Country::setIndustryTech<TRAITS>(double mean, double highest); \
+	template void V2Country::setCultureTech<TRAITS>(double mean, double highest);
+V2_GAMETYPE_TRAITS(INSTANTIATE_V2COUNTRY_KERNELS)
\ No newline at end of file
@@ -27,12 +27,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include "../CountryMapping.h"
+#include "../CultureRuleEngine.h"
 #include "../Mapper.h"
+#include "../ProvinceTable.h"
 #include "../Color.h"
 #include "../Date.h"
 #include "../EU3World/EU3Army.h"
 #include "V2Localisation.h"
-#include "V2Inventions.h"
+#include "V2Gametype.h"
 #include "V2TechSchools.h"
 #include <vector>
 #include <set>
@@ -57,34 +59,42 @@ struct V2Party;
 class V2Country
 {
 	public:
-		V2Country(const std::string& _tag, const std::string& _commonCountryFile, const std::vector<V2Party*>& _parties, 
+		V2Country(CountryTag _tag, const std::string& _commonCountryFile, const std::vector<V2Party*>& _parties, 
 			V2World* _theWorld, bool _newCountry = false, bool _dynamicCountry = false);
+		V2Country(const V2Country& base, V2World* _theWorld);	// copies an unconverted country into another world
 		void								output() const;
 		void								outputToCommonCountriesFile(FILE*) const;
 		void								outputLocalisation(FILE*) const;
 		void								outputOOB() const;
-		void								initFromEU3Country(const EU3Country* _srcCountry, const std::vector<std::string>& outputOrder,
-			const CountryMapping& countryMap, const cultureMapping& cultureMap, const religionMapping& religionMap, const unionCulturesMap& unionCultures,
+		void								initFromEU3Country(const EU3Country* _srcCountry, const std::vector<CountryTag>& outputOrder,
+			const CountryMapping& countryMap, const CultureRuleEngine& cultureRules, const religionMapping& religionMap, const unionCulturesMap& unionCultures,
 			const governmentMapping& governmentMap, const inverseProvinceMapping& inverseProvinceMap, const std::vector<V2TechSchool>& techSchools, 
-			const std::map<int, int>& leaderMap, const V2LeaderTraits& lt, const EU3RegionsMapping& regionsMap);
+			const std::map<int, int>& leaderMap, const V2LeaderTraits& lt);
 		void								initFromHistory();
 		void								addProvince(V2Province* _province);
+		template<typename Traits>
 		void								addState(V2State* newState);
 		void								convertArmies(const std::map<int,int>& leaderIDMap, double cost_per_regiment[num_reg_categories],
-			const inverseProvinceMapping& inverseProvinceMap, const std::map<int, V2Province*>& allProvinces, const std::vector<int>& port_whitelist,
-			const adjacencyMapping& adjacencyMap);
+			const inverseProvinceMapping& inverseProvinceMap, const ProvinceTable<V2Province*>& allProvinces, const std::vector<int>& port_whitelist,
+			const AdjacencyGraph& adjacencyMap);
 		bool								addFactory(V2Factory* factory);
 		void								addRailroadtoCapitalState();
+		template<typename Traits>
 		void								convertUncivReforms();
 		void								setupPops(EU3World& sourceWorld, double popWeightRatio);
+		template<typename Traits>
 		void								setArmyTech(double mean, double highest);
+		template<typename Traits>
 		void								setNavyTech(double mean, double highest);
+		template<typename Traits>
 		void								setCommerceTech(double mean, double highest);
+		template<typename Traits>
 		void								setIndustryTech(double mean, double highest);
+		template<typename Traits>
 		void								setCultureTech(double mean, double highest);
 		void								addRelation(V2Relations* newRelation);
 
-		V2Relations*					getRelations(const std::string& withWhom) const;
+		V2Relations*					getRelations(CountryTag withWhom) const;
 		void								getNationalValueScores(int& liberty, int& equality, int& order);
 
 		void								addResearchPoints(double newPoints)	noexcept	{ researchPoints += newPoints; }
@@ -93,22 +103,20 @@ class V2Country
 		void								isANewCountry(void)					noexcept { newCountry = true; }
 		void								scalePrestige(double scale)			noexcept { prestige *= scale; }
 
-		std::map<int, V2Province*>		getProvinces()													const noexcept { return provinces; }
-		std::string							getTag()															const noexcept { return tag; };
+		const std::map<int, V2Province*>&	getProvinces()												const noexcept { return provinces; }
+		CountryTag							getTag()															const noexcept { return tag; };
 		bool								isCivilized()													const noexcept { return civilized; };
-		std::string							getPrimaryCulture()											const noexcept { return primaryCulture; };
-		std::set<std::string>						getAcceptedCultures()										const noexcept { return acceptedCultures; };
+		Symbol								getPrimaryCulture()											const noexcept { return primaryCulture; };
+		const std::set<Symbol>&			getAcceptedCultures()										const noexcept { return acceptedCultures; };
 		const EU3Country*				getSourceCountry()											const noexcept { return srcCountry; };
-		inventionStatus				getInventionState(vanillaInventionType invention)	const { return vanillaInventions[invention]; };
-		inventionStatus				getInventionState(HODInventionType invention)		const { return HODInventions[invention]; };
-		inventionStatus				getInventionState(HODNNMInventionType invention)	const { return HODNNMInventions[invention]; };
+		inventionStatus				getInventionState(int invention)							const { return inventions[invention]; };
 		double							getReactionary()												const noexcept { return upperHouseReactionary; };
 		double							getConservative()												const noexcept { return upperHouseConservative; };
 		double							getLiberal()													const noexcept { return upperHouseLiberal; };
 		std::string							getGovernment()												const noexcept { return government; };
-		std::vector< std::pair<int, int> >	getReactionaryIssues()										const noexcept { return reactionaryIssues; };
-		std::vector< std::pair<int, int> >	getConservativeIssues()										const noexcept { return conservativeIssues; };
-		std::vector< std::pair<int, int> >	getLiberalIssues()											const noexcept { return liberalIssues; };
+		const std::vector< std::pair<int, int> >&	getReactionaryIssues()							const noexcept { return reactionaryIssues; };
+		const std::vector< std::pair<int, int> >&	getConservativeIssues()							const noexcept { return conservativeIssues; };
+		const std::vector< std::pair<int, int> >&	getLiberalIssues()								const noexcept { return liberalIssues; };
 		double							getLiteracy()													const noexcept { return literacy; };
 		int								getCapital()													const noexcept { return capital; };
 		bool								isNewCountry()													const noexcept { return newCountry; };
@@ -119,25 +127,36 @@ class V2Country
 		void			outputElection(FILE*) const;
 		void			addLoan(const std::string& creditor, double size, double interest);
 		int			addRegimentToArmy(V2Army* army, RegimentCategory rc, const inverseProvinceMapping& inverseProvinceMap,
-			const std::map<int, V2Province*>& allProvinces, const adjacencyMapping& adjacencyMap);
-		std::vector<int>	getPortProvinces(std::vector<int> locationCandidates, const std::map<int, V2Province*>& allProvinces);
+			const ProvinceTable<V2Province*>& allProvinces, const AdjacencyGraph& adjacencyMap);
+		std::vector<int>	getPortProvinces(std::vector<int> locationCandidates, const ProvinceTable<V2Province*>& allProvinces);
 		V2Army*		getArmyForRemainder(RegimentCategory rc);
 		V2Province*	getProvinceForExpeditionaryArmy();
 		std::string		getRegimentName(RegimentCategory rc);
 
+		// marks an invention active if it is one of the configured game's, which Traits settles at compile time
+		template<typename Traits, typename Invention>
+		void			activateInvention(Invention invention)
+		{
+			const int index = Traits::inventionIndex(invention);
+			if (index >= 0)
+			{
+				inventions[index] = active;
+			}
+		}
+
 		V2World*							theWorld;
 		const EU3Country*				srcCountry;
 		std::string							filename;
 		bool								newCountry;			// true if this country is being added by the converter, i.e. doesn't already exist in Vic2
 		bool								dynamicCountry;	// true if this country is a Vic2 dynamic country
-		std::string							tag;
+		CountryTag							tag;
 		std::vector<V2State*>				states;
 		std::map<int, V2Province*>		provinces;
 		int								capital;
 		bool								civilized;
-		std::string							primaryCulture;
-		std::set<std::string>						acceptedCultures;
-		std::string							religion;
+		Symbol								primaryCulture;
+		std::set<Symbol>					acceptedCultures;
+		Symbol								religion;
 		std::vector<V2Party*>				parties;
 		std::string							rulingParty;
 		std::string							commonCountryFile;
@@ -145,9 +164,7 @@ class V2Country
 		double							leadership;
 		double							plurality;
 		std::vector<std::string>					techs;
-		inventionStatus				vanillaInventions[VANILLA_naval_exercises];
-		inventionStatus				HODInventions[HOD_naval_exercises];
-		inventionStatus				HODNNMInventions[HOD_NNM_naval_exercises];
+		std::vector<inventionStatus>	inventions;			// indexed by the configured game's invention types
 		V2UncivReforms*				uncivReforms;
 		double							researchPoints;
 		std::string							techSchool;
@@ -158,7 +175,7 @@ class V2Country
 		std::vector< std::pair<int, int> >	reactionaryIssues;
 		std::vector< std::pair<int, int> >	conservativeIssues;
 		std::vector< std::pair<int, int> >	liberalIssues;
-		std::map<std::string,V2Relations*>	relations;
+		std::map<CountryTag, V2Relations*>	relations;
 		std::vector<V2Army*>				armies;
 		V2Reforms*						reforms;
 		std::string							nationalValue;
@@ -83,8 +83,8 @@ void V2Diplomacy::output() const
 		}
 		fprintf(out, "%s=\n", itr->type.c_str());
 		fprintf(out, "{\n");
-		fprintf(out, "\tfirst=\"%s\"\n", itr->country1.c_str());
-		fprintf(out, "\tsecond=\"%s\"\n", itr->country2.c_str());
+		fprintf(out, "\tfirst=\"%s\"\n", itr->country1.str().c_str());
+		fprintf(out, "\tsecond=\"%s\"\n", itr->country2.str().c_str());
 		fprintf(out, "\tstart_date=\"%s\"\n", itr->start_date.toString().c_str());
 		fprintf(out, "\tend_date=\"1936.1.1\"\n");
 		fprintf(out, "}\n");
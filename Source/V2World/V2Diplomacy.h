@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+#include "../CountryTag.h"
 #include "../Date.h"
 #include <vector>
 
@@ -34,8 +35,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 struct V2Agreement
 {
 	std::string	type;
-	std::string	country1;
-	std::string	country2;
+	CountryTag	country1;
+	CountryTag	country2;
 	date		start_date;
 };
 
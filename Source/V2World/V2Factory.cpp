@@ -24,59 +24,78 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 #include <cstdlib>
+#include <new>
+#include <stdexcept>
 
 #include "V2Factory.h"
+#include "../Arena.h"
 #include "../Log.h"
 #include "../Configuration.h"
+#include "../FieldTable.h"
+#include "../Snapshot.h"
+#include "V2Gametype.h"
 
 #include "wiz/load_data.h"
 
 
 V2FactoryType::V2FactoryType(const wiz::load_data::UserType* factory)
 {
-	name = factory->GetName().ToString();
+	static const FieldTable<V2FactoryType> fields = FieldTable<V2FactoryType>()
+		.field("is_coastal", &V2FactoryType::requireCoastal)
+		.field("limit_by_local_supply", &V2FactoryType::requireLocalInput)
+		.userType("input_goods", [](V2FactoryType& type, wiz::load_data::UserType* inputGoods)
+			{
+				for (long long x = 0; x < inputGoods->GetItemListSize(); ++x)
+				{
+					type.inputs.insert(std::make_pair(inputGoods->GetItemList(x).GetName().ToString(),
+						inputGoods->GetItemList(x).Get(0).ToFloat()));
+				}
+			})
+		.field("output_goods", &V2FactoryType::outputGoods);
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> is_coastal = factory->GetItem("is_coastal");
-	if ((is_coastal.size() > 0) && (is_coastal[0].Get(0).ToString() == "yes"))
-	{
-		requireCoastal = true;
-	}
-	else
-	{
-		requireCoastal = false;
-	}
+	name = factory->GetName().ToString();
 
+	requireCoastal					= false;
 	requireTech						= "";
-	vanillaRequiredInvention	= (vanillaInventionType)-1;
-	HODRequiredInvention			= (HODInventionType)-1;
-	HODNNMRequiredInvention		= (HODNNMInventionType)-1;
+	requiredInvention				= -1;
+	requireLocalInput				= false;
+	inputs.clear();
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> local_supply = factory->GetItem("limit_by_local_supply");
-	if ((local_supply.size() > 0) && (local_supply[0].Get(0).ToString() == "yes"))
-	{
-		requireLocalInput = true;
-	}
-	else
-	{
-		requireLocalInput = false;
-	}
+	fields.apply(factory, *this);
+}
 
-	inputs.clear();
-	std::vector<wiz::load_data::UserType*> inputGoods = factory->GetUserTypeItem("input_goods");
-	if (inputGoods.size() > 0)
+
+V2FactoryType::V2FactoryType(SnapshotReader& snapshot)
+{
+	name								= snapshot.readString();
+	requireCoastal					= snapshot.readBool();
+	requireTech						= snapshot.readString();
+	requiredInvention				= static_cast<int>(snapshot.readInt());
+	requireLocalInput				= snapshot.readBool();
+	size_t numInputs = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numInputs); ++i)
 	{
-		for (long long x = 0; x < inputGoods[0]->GetItemListSize(); ++x)
-		{
-			inputs.insert(std::make_pair(inputGoods[0]->GetItemList(x).GetName().ToString(),
-				inputGoods[0]->GetItemList(x).Get(0).ToFloat()));
-		}
+		std::string goods = snapshot.readString();
+		inputs.insert(std::make_pair(goods, static_cast<float>(snapshot.readDouble())));
 	}
+	outputGoods						= snapshot.readString();
+}
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> outputGoodsObj = factory->GetItem("output_goods");
-	if (outputGoodsObj.size() > 0)
+
+void V2FactoryType::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(name);
+	snapshot.writeBool(requireCoastal);
+	snapshot.writeString(requireTech);
+	snapshot.writeInt(requiredInvention);
+	snapshot.writeBool(requireLocalInput);
+	snapshot.writeInt(inputs.size());
+	for (std::map<std::string, float>::const_iterator itr = inputs.begin(); itr != inputs.end(); ++itr)
 	{
-		outputGoods = outputGoodsObj[0].Get(0).ToString();
+		snapshot.writeString(itr->first);
+		snapshot.writeDouble(itr->second);
 	}
+	snapshot.writeString(outputGoods);
 }
 
 
@@ -91,17 +110,16 @@ void V2Factory::output(FILE* output) const
 }
 
 
-std::map<std::string,float> V2Factory::getRequiredRGO() const
+const std::map<std::string,float>& V2Factory::getRequiredRGO() const
 {
+	static const std::map<std::string,float> noInputs;
 	if (type->requireLocalInput)
 	{
 		return type->inputs;
 	}
 	else
 	{
-		std::map<std::string,float> emptyMap;
-		emptyMap.clear();
-		return emptyMap;
+		return noInputs;
 	}
 }
 
@@ -112,7 +130,38 @@ void V2Factory::increaseLevel()
 }
 
 
+static const char* const factorySnapshotFile = "V2Factories.snapshot";
+
+
 V2FactoryFactory::V2FactoryFactory()
+{
+	// the factory types only change with the game install, so they are kept as a snapshot between runs
+	SnapshotKey snapshotKey;
+	snapshotKey.addFolder(Configuration::getV2Path() + "\\technologies");
+	snapshotKey.addFolder(Configuration::getV2Path() + "\\inventions");
+	snapshotKey.addFile(Configuration::getV2Path() + "\\common\\production_types.txt");
+	snapshotKey.addFile("starting_factories.txt");
+	snapshotKey.addString(Configuration::getV2GametypeName());
+
+	SnapshotReader snapshot;
+	if (	!Configuration::getStaticDataCache() ||
+			!snapshot.open(factorySnapshotFile, snapshotKey) ||
+			!readSnapshot(snapshot)
+		)
+	{
+		snapshot.close();
+		importFactories();
+		if (Configuration::getStaticDataCache())
+		{
+			SnapshotWriter newSnapshot;
+			writeSnapshot(newSnapshot);
+			newSnapshot.save(factorySnapshotFile, snapshotKey);
+		}
+	}
+}
+
+
+void V2FactoryFactory::importFactories()
 {
 	// load required techs/inventions
 	factoryTechReqs.clear();
@@ -146,31 +195,12 @@ V2FactoryFactory::V2FactoryFactory()
 		{
 			ft->requireTech = reqitr->second;
 		}
-		reqitr = factoryInventionReqs.find(ft->name);
-		if (reqitr != factoryInventionReqs.end())
-		{
-			for (int i = 0; i <= VANILLA_naval_exercises; ++i)
-			{
-				if (((Configuration::getV2Gametype() == "vanilla") || 
-					(Configuration::getV2Gametype() == "AHD")) && (reqitr->second == vanillaInventionNames[i]))
-				{
-					ft->vanillaRequiredInvention = (vanillaInventionType)i;
-					break;
-				}
-				else if ((Configuration::getV2Gametype() == "HOD") && (reqitr->second == HODInventionNames[i])) 
-				{
-					ft->HODRequiredInvention = (HODInventionType)i;
-					break;
-				}
-				else if ((Configuration::getV2Gametype() == "HoD-NNM") && (reqitr->second == HODNNMInventionNames[i]))
-				{
-					ft->HODNNMRequiredInvention = (HODNNMInventionType)i;
-					break;
-				}
-			}
-		}
 		factoryTypes[ft->name] = ft;
 	}
+	withV2GametypeTraits(Configuration::getV2Gametype(), [this](auto traits)
+	{
+		resolveRequiredInventions<decltype(traits)>();
+	});
 
 	factoryCounts.clear();
 	
@@ -204,14 +234,79 @@ V2FactoryFactory::V2FactoryFactory()
 }
 
 
-std::deque<V2Factory*> V2FactoryFactory::buildFactories() const
+void V2FactoryFactory::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeInt(factoryTypes.size());
+	for (std::map<std::string, V2FactoryType*>::const_iterator itr = factoryTypes.begin(); itr != factoryTypes.end(); ++itr)
+	{
+		itr->second->writeSnapshot(snapshot);
+	}
+	snapshot.writeInt(factoryCounts.size());
+	for (std::vector<std::pair<V2FactoryType*, int>>::const_iterator itr = factoryCounts.begin(); itr != factoryCounts.end(); ++itr)
+	{
+		snapshot.writeString(itr->first->name);
+		snapshot.writeInt(itr->second);
+	}
+}
+
+
+bool V2FactoryFactory::readSnapshot(SnapshotReader& snapshot)
+{
+	LOG(LogLevel::Info) << "Reading factory types from " << factorySnapshotFile;
+
+	try
+	{
+		size_t numTypes = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numTypes); ++i)
+		{
+			V2FactoryType* ft = new V2FactoryType(snapshot);
+			factoryTypes[ft->name] = ft;
+		}
+		size_t numCounts = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numCounts); ++i)
+		{
+			std::string factoryType	= snapshot.readString();
+			int count					= static_cast<int>(snapshot.readInt());
+			std::map<std::string, V2FactoryType*>::iterator t = factoryTypes.find(factoryType);
+			if (t != factoryTypes.end())
+			{
+				factoryCounts.push_back(std::pair<V2FactoryType*, int>(t->second, count));
+			}
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		snapshot.fail();
+	}
+	catch (const std::length_error&)
+	{
+		snapshot.fail();
+	}
+
+	if (!snapshot.good())
+	{
+		LOG(LogLevel::Warning) << factorySnapshotFile << " is damaged; importing the factory types instead";
+		for (std::map<std::string, V2FactoryType*>::iterator itr = factoryTypes.begin(); itr != factoryTypes.end(); ++itr)
+		{
+			delete itr->second;
+		}
+		factoryTypes.clear();
+		factoryCounts.clear();
+		return false;
+	}
+
+	return true;
+}
+
+
+std::deque<V2Factory*> V2FactoryFactory::buildFactories(Arena& arena) const
 {
 	std::deque<V2Factory*> retval;
 	for (std::vector< std::pair<V2FactoryType*, int> >::const_iterator itr = factoryCounts.begin(); itr != factoryCounts.end(); ++itr)
 	{
 		for (int i = 0; i < itr->second; ++i)
 		{
-			V2Factory* newFactory = new V2Factory(itr->first);
+			V2Factory* newFactory = arena.make<V2Factory>(itr->first);
 			retval.push_back(newFactory);
 		}
 	}
@@ -267,3 +362,25 @@ void V2FactoryFactory::loadRequiredInventions(const std::string& filename)
 		}
 	}
 }
+
+
+template<typename Traits>
+void V2FactoryFactory::resolveRequiredInventions()
+{
+	for (std::map<std::string, V2FactoryType*>::iterator itr = factoryTypes.begin(); itr != factoryTypes.end(); ++itr)
+	{
+		std::map<std::string, std::string>::iterator reqitr = factoryInventionReqs.find(itr->first);
+		if (reqitr == factoryInventionReqs.end())
+		{
+			continue;
+		}
+		for (int i = 0; i < Traits::numInventions; ++i)
+		{
+			if (reqitr->second == Traits::inventionName(i))
+			{
+				itr->second->requiredInvention = i;
+				break;
+			}
+		}
+	}
+}
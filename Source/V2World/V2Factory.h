@@ -35,17 +35,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "wiz/load_data_types.h"
 
+class Arena;
+class SnapshotReader;
+class SnapshotWriter;
+
 
 struct V2FactoryType
 {
 	V2FactoryType(const wiz::load_data::UserType* factory);
+	V2FactoryType(SnapshotReader& snapshot);				// reads what writeSnapshot wrote
+	void writeSnapshot(SnapshotWriter& snapshot) const;
 
 	std::string						name;
 	bool							requireCoastal;
 	std::string						requireTech;
-	vanillaInventionType		vanillaRequiredInvention;
-	HODInventionType			HODRequiredInvention;
-	HODNNMInventionType		HODNNMRequiredInvention;
+	int								requiredInvention;	// in the configured game's inventions, or -1 for none
 	bool							requireLocalInput;
 	std::map<std::string,float>			inputs;
 	std::string						outputGoods;
@@ -57,16 +61,14 @@ class V2Factory
 	public:
 		V2Factory(const V2FactoryType* _type) : type(_type) { level = 1; };
 		void					output(FILE* output) const;
-		std::map<std::string,float>	getRequiredRGO() const;
+		const std::map<std::string,float>&	getRequiredRGO() const;		// the inputs, if they must be local
 		void					increaseLevel();
 
 		bool						requiresCoastal()					const noexcept { return type->requireCoastal; }
 		std::string						getRequiredTech()					const noexcept { return type->requireTech; }
-		vanillaInventionType	getVanillaRequiredInvention()	const noexcept { return type->vanillaRequiredInvention; }
-		HODInventionType		getHODRequiredInvention()		const noexcept { return type->HODRequiredInvention; }
-		HODNNMInventionType	getHODNNMRequiredInvention()	const noexcept { return type->HODNNMRequiredInvention; }
+		int						getRequiredInvention()			const noexcept { return type->requiredInvention; }
 		std::string						getTypeName()						const noexcept { return type->name; }
-		std::map<std::string,float>		getInputs()							const noexcept { return type->inputs; };
+		const std::map<std::string,float>&	getInputs()				const noexcept { return type->inputs; };
 		std::string					getOutputGoods()					const noexcept { return type->outputGoods; };
 	private:
 		const V2FactoryType* type;
@@ -78,10 +80,15 @@ class V2FactoryFactory
 {
 	public:
 		V2FactoryFactory();
-		std::deque<V2Factory*>	buildFactories() const;
+		std::deque<V2Factory*>	buildFactories(Arena& arena) const;
 	private:
+		void					importFactories();
+		void					writeSnapshot(SnapshotWriter& snapshot) const;
+		bool					readSnapshot(SnapshotReader& snapshot);
 		void					loadRequiredTechs(const std::string& filename);
 		void					loadRequiredInventions(const std::string& filename);
+		template<typename Traits>
+		void					resolveRequiredInventions();
 		std::vector<std::pair<V2FactoryType*, int>>	factoryCounts;
 		std::map<std::string, V2FactoryType*>			factoryTypes;
 		std::map<std::string, std::string>						factoryTechReqs;
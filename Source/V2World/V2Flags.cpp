@@ -37,7 +37,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 const std::vector<std::string> V2Flags::flagFileSuffixes = { ".tga", "_communist.tga", "_fascist.tga", "_monarchy.tga", "_republic.tga" };
-void V2Flags::SetV2Tags(const std::map<std::string, V2Country*>& V2Countries)
+void V2Flags::SetV2Tags(const std::map<CountryTag, V2Country*>& V2Countries)
 {
 	LOG(LogLevel::Debug) << "Initializing flags";
 	tagMapping.clear();
@@ -49,7 +49,7 @@ void V2Flags::SetV2Tags(const std::map<std::string, V2Country*>& V2Countries)
 	{
 		WinUtils::GetAllFilesInFolder(availableFlagFolders[i], availableFlags);
 	}
-	std::set<std::string> usableFlagTags;
+	std::set<CountryTag> usableFlagTags;
 	while (!availableFlags.empty())
 	{
 		std::string flag = *availableFlags.begin();
@@ -86,8 +86,8 @@ void V2Flags::SetV2Tags(const std::map<std::string, V2Country*>& V2Countries)
 	}
 
 	// Now get all tags that we want to have flags.
-	std::set<std::string> requiredTags;
-	for (std::map<std::string, V2Country*>::const_iterator i = V2Countries.begin(); i != V2Countries.end(); i++)
+	std::set<CountryTag> requiredTags;
+	for (std::map<CountryTag, V2Country*>::const_iterator i = V2Countries.begin(); i != V2Countries.end(); i++)
 	{
 		if (i->second->getSourceCountry())
 		{
@@ -98,9 +98,9 @@ void V2Flags::SetV2Tags(const std::map<std::string, V2Country*>& V2Countries)
 	// The tags in common between these two sets (usableFlagTags and requiredTags) are already good - we calculate
 	// the set of tags left over from each set.
 	{
-		std::set<std::string> usableFlagTagsRemaining;
+		std::set<CountryTag> usableFlagTagsRemaining;
 		std::set_difference(usableFlagTags.begin(), usableFlagTags.end(), requiredTags.begin(), requiredTags.end(), std::inserter(usableFlagTagsRemaining, usableFlagTagsRemaining.end()));
-		std::set<std::string> requiredTagsRemaining;
+		std::set<CountryTag> requiredTagsRemaining;
 		std::set_difference(requiredTags.begin(), requiredTags.end(), usableFlagTags.begin(), usableFlagTags.end(), std::inserter(requiredTagsRemaining, requiredTagsRemaining.end()));
 		std::swap(usableFlagTags, usableFlagTagsRemaining);
 		std::swap(requiredTags, requiredTagsRemaining);
@@ -109,13 +109,13 @@ void V2Flags::SetV2Tags(const std::map<std::string, V2Country*>& V2Countries)
 	// All the remaining tags now need one of the usable flags.
 	static std::mt19937 generator(static_cast<int>(std::chrono::system_clock::now().time_since_epoch().count()));
 	size_t mappingsMade = 0;
-	for (std::set<std::string>::const_iterator i = requiredTags.cbegin(); i != requiredTags.cend(); ++i)
+	for (std::set<CountryTag>::const_iterator i = requiredTags.cbegin(); i != requiredTags.cend(); ++i)
 	{
-		const std::string& V2Tag = *i;
+		CountryTag V2Tag = *i;
 		size_t randomTagIndex = std::uniform_int_distribution<size_t>(0, usableFlagTags.size() - 1)(generator);
-		std::set<std::string>::const_iterator randomTagIter = usableFlagTags.cbegin();
+		std::set<CountryTag>::const_iterator randomTagIter = usableFlagTags.cbegin();
 		std::advance(randomTagIter, randomTagIndex);
-		const std::string& flagTag = *randomTagIter;
+		CountryTag flagTag = *randomTagIter;
 		tagMapping[V2Tag] = flagTag;
 		LOG(LogLevel::Debug) << "Country with tag " << V2Tag << " has no flag and will use the flag for " << flagTag << " instead";
 		if (usableFlagTags.size() > requiredTags.size() - tagMapping.size())
@@ -145,8 +145,8 @@ bool V2Flags::Output() const
 	const std::vector<std::string> availableFlagFolders = { "blankMod\\output\\gfx\\flags", Configuration::getV2Path() + "\\gfx\\flags" };
 	for (V2TagToFlagTagMap::const_iterator i = tagMapping.begin(); i != tagMapping.end(); ++i)
 	{
-		const std::string& V2Tag = i->first;
-		const std::string& flagTag = i->second;
+		CountryTag V2Tag = i->first;
+		CountryTag flagTag = i->second;
 		for (std::vector<std::string>::const_iterator i = flagFileSuffixes.begin(); i != flagFileSuffixes.end(); ++i)
 		{
 			const std::string& suffix = *i;
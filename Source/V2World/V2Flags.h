@@ -27,6 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <set>
 #include <string>
 #include <vector>
+#include "../CountryTag.h"
 
 class V2Country;
 
@@ -36,14 +37,14 @@ class V2Flags
 {
 public:
 	// Tries to find appropriate flags for all the countries specified.
-	void SetV2Tags(const std::map<std::string, V2Country*>& V2Countries);
+	void SetV2Tags(const std::map<CountryTag, V2Country*>& V2Countries);
 	// Copies all necessary flags to the output folder. Returns true if successful.
 	bool Output() const;
 
 private:
 	static const std::vector<std::string> flagFileSuffixes;
 
-	typedef std::map<std::string, std::string> V2TagToFlagTagMap;
+	typedef std::map<CountryTag, CountryTag> V2TagToFlagTagMap;
 	V2TagToFlagTagMap tagMapping;
 };
 
@@ -0,0 +1,142 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+#ifndef V2GAMETYPE_H_
+#define V2GAMETYPE_H_
+
+
+
+#include "../Configuration.h"
+#include "V2Inventions.h"
+
+
+
+// What differs between the V2 games, known at compile time so that the conversion routines can be
+// instantiated once per game instead of checking the configured game inside their loops.
+struct V2VanillaTraits
+{
+	static constexpr V2Gametype	gametype						= V2Vanilla;
+	static constexpr bool			hasUncivilizedNations	= false;	// uncivilized nations and their reforms
+	static constexpr bool			hasNavalBases				= false;
+	static constexpr bool			hasSmallColonies			= false;	// provinces under 1000 people stay colonies
+	static constexpr bool			hasDynamicDominions		= false;
+	static constexpr int				numInventions				= VANILLA_naval_exercises + 1;
+
+	static const char*				inventionName(int invention)						{ return vanillaInventionNames[invention]; }
+
+	// the index of an invention in this game's table, or -1 if it belongs to another game
+	static constexpr int				inventionIndex(vanillaInventionType invention)	{ return invention; }
+	static constexpr int				inventionIndex(HODInventionType)						{ return -1; }
+	static constexpr int				inventionIndex(HODNNMInventionType)					{ return -1; }
+};
+
+
+// AHD keeps the vanilla inventions
+struct V2AHDTraits: V2VanillaTraits
+{
+	static constexpr V2Gametype	gametype						= V2AHD;
+	static constexpr bool			hasUncivilizedNations	= true;
+};
+
+
+struct V2HODTraits
+{
+	static constexpr V2Gametype	gametype						= V2HOD;
+	static constexpr bool			hasUncivilizedNations	= true;
+	static constexpr bool			hasNavalBases				= true;
+	static constexpr bool			hasSmallColonies			= true;
+	static constexpr bool			hasDynamicDominions		= true;
+	static constexpr int				numInventions				= HOD_naval_exercises + 1;
+
+	static const char*				inventionName(int invention)						{ return HODInventionNames[invention]; }
+
+	static constexpr int				inventionIndex(vanillaInventionType)				{ return -1; }
+	static constexpr int				inventionIndex(HODInventionType invention)		{ return invention; }
+	static constexpr int				inventionIndex(HODNNMInventionType)					{ return -1; }
+};
+
+
+struct V2HODNNMTraits
+{
+	static constexpr V2Gametype	gametype						= V2HODNNM;
+	static constexpr bool			hasUncivilizedNations	= true;
+	static constexpr bool			hasNavalBases				= true;
+	static constexpr bool			hasSmallColonies			= true;
+	static constexpr bool			hasDynamicDominions		= true;
+	static constexpr int				numInventions				= HOD_NNM_naval_exercises + 1;
+
+	static const char*				inventionName(int invention)						{ return HODNNMInventionNames[invention]; }
+
+	static constexpr int				inventionIndex(vanillaInventionType)				{ return -1; }
+	static constexpr int				inventionIndex(HODInventionType)						{ return -1; }
+	static constexpr int				inventionIndex(HODNNMInventionType invention)	{ return invention; }
+};
+
+
+// Lists every traits struct, for explicitly instantiating the routines that are templated on them
+#define V2_GAMETYPE_TRAITS(DO) \
+	DO(V2VanillaTraits) \
+	DO(V2AHDTraits) \
+	DO(V2HODTraits) \
+	DO(V2HODNNMTraits)
+
+
+// Calls kernel with the traits of the given game, so the game is only looked at once
+template<typename Kernel>
+decltype(auto) withV2GametypeTraits(V2Gametype gametype, Kernel&& kernel)
+{
+	switch (gametype)
+	{
+		case V2AHD:
+			return kernel(V2AHDTraits());
+		case V2HOD:
+			return kernel(V2HODTraits());
+		case V2HODNNM:
+			return kernel(V2HODNNMTraits());
+		default:
+			return kernel(V2VanillaTraits());
+	}
+}
+
+
+// The name of an invention of the configured game
+inline const char* getV2InventionName(int invention)
+{
+	return withV2GametypeTraits(Configuration::getV2Gametype(), [invention](auto traits)
+	{
+		return decltype(traits)::inventionName(invention);
+	});
+}
+
+
+// The number of inventions in the configured game
+inline int getV2NumInventions()
+{
+	return withV2GametypeTraits(Configuration::getV2Gametype(), [](auto traits)
+	{
+		return decltype(traits)::numInventions;
+	});
+}
+
+
+
+#endif	// V2GAMETYPE_H_
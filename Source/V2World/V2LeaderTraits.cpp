@@ -24,63 +24,28 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "V2LeaderTraits.h"
 #include "../Log.h"
+#include "../FieldTable.h"
 
 #include "wiz/load_data.h"
 
 
 V2TraitConversion::V2TraitConversion(const wiz::load_data::UserType* obj)
 {
-	trait = obj->GetName().ToString();
+	static const FieldTable<V2TraitConversion> fields = FieldTable<V2TraitConversion>()
+		.field("fire", &V2TraitConversion::req_fire)
+		.field("shock", &V2TraitConversion::req_shock)
+		.field("manuever", &V2TraitConversion::req_manuever)
+		.field("siege", &V2TraitConversion::req_siege)
+		.field("other", &V2TraitConversion::req_other);
 
-	std::vector<wiz::load_data::ItemType<wiz::DataType>> reqObj = obj->GetItem("fire");
-	if (reqObj.size() > 0)
-	{
-		req_fire = reqObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		req_fire = 0;
-	}
-
-	reqObj = obj->GetItem("shock");
-	if (reqObj.size() > 0)
-	{
-		req_shock = reqObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		req_shock = 0;
-	}
-
-	reqObj = obj->GetItem("manuever");
-	if (reqObj.size() > 0)
-	{
-		req_manuever = reqObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		req_manuever = 0;
-	}
-
-	reqObj = obj->GetItem("siege");
-	if (reqObj.size() > 0)
-	{
-		req_siege = reqObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		req_siege = 0;
-	}
+	trait = obj->GetName().ToString();
 
-	reqObj = obj->GetItem("other");
-	if (reqObj.size() > 0)
-	{
-		req_other = reqObj[0].Get(0).ToInt();
-	}
-	else
-	{
-		req_other = 0;
-	}
+	req_fire		= 0;
+	req_shock		= 0;
+	req_manuever	= 0;
+	req_siege		= 0;
+	req_other		= 0;
+	fields.apply(obj, *this);
 }
 
 
@@ -27,7 +27,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-V2Pop::V2Pop(const std::string& _type, int _size, const std::string& _culture, const std::string& _religion)
+V2Pop::V2Pop(Symbol _type, int _size, Symbol _culture, Symbol _religion)
 {
 	type						= _type;
 	size						= _size;
@@ -60,3 +60,41 @@ bool V2Pop::combine(const V2Pop& rhs)
 		return false;
 	}
 }
+
+
+// Every pop is merged into the first pop of the same type, culture and religion, which keeps its
+// place.  That first pop is dropped if it started out smaller than 1, except for the very first
+// pop of the list, which is always kept.
+void combineAlikePops(std::vector<V2Pop*>& pops)
+{
+	// a small open-addressed table of the first pop of each kind, at most half full
+	size_t tableSize = 16;
+	while (tableSize < 2 * pops.size())
+	{
+		tableSize *= 2;
+	}
+	std::vector<V2Pop*> firstOfKind(tableSize, nullptr);
+
+	size_t kept = 0;
+	for (size_t i = 0; i < pops.size(); ++i)
+	{
+		V2Pop* pop = pops[i];
+		size_t slot = ((pop->getType().getId() * 0x9E3779B1u) ^ (pop->getCulture().getId() * 0x85EBCA77u) ^ (pop->getReligion().getId() * 0xC2B2AE3Du)) & (tableSize - 1);
+		while ((firstOfKind[slot] != nullptr) && !firstOfKind[slot]->combine(*pop))
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if (firstOfKind[slot] != nullptr)
+		{
+			continue;	// combined into the first pop of its kind
+		}
+		firstOfKind[slot] = pop;
+
+		if ((i > 0) && (pop->getSize() < 1))
+		{
+			continue;
+		}
+		pops[kept++] = pop;
+	}
+	pops.resize(kept);
+}
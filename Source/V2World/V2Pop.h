@@ -29,34 +29,38 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include <string>
 #include <vector>
+#include "../Symbol.h"
 
 
 class V2Pop
 {
 	public:
-		V2Pop(const std::string& type, int size, const std::string& culture, const std::string& religion);
+		V2Pop(Symbol type, int size, Symbol culture, Symbol religion);
 		void output(FILE*) const;
 		bool combine(const V2Pop& rhs);
 
 		void	changeSize(int delta)				noexcept	{ size += delta; }
 		void	incrementSupportedRegimentCount() noexcept { supportedRegiments++; }
-		void	setCulture(std::string _culture)		noexcept { culture = _culture; }
-		void	setReligion(std::string _religion)		noexcept { religion = _religion; }
+		void	setCulture(Symbol _culture)		noexcept { culture = _culture; }
+		void	setReligion(Symbol _religion)		noexcept { religion = _religion; }
 
 		int		getSize()							const	noexcept { return size; }
-		std::string	getType()							const	noexcept { return type; }
-		std::string	getCulture()						const	noexcept { return culture; }
-		std::string	getReligion()						const	noexcept { return religion; }
+		Symbol	getType()							const	noexcept { return type; }
+		Symbol	getCulture()						const	noexcept { return culture; }
+		Symbol	getReligion()						const	noexcept { return religion; }
 		int		getSupportedRegimentCount()	const noexcept { return supportedRegiments; }
 	private:
-		std::string	type;
+		Symbol	type;
 		int		size;
-		std::string	culture;
-		std::string	religion;
+		Symbol	culture;
+		Symbol	religion;
 		int		supportedRegiments;
 };
 
 
+// Merges pops of the same type, culture and religion, keeping the order of the pops that stay
+void combineAlikePops(std::vector<V2Pop*>& pops);
+
 int getNextPopId(); // ?
 
 
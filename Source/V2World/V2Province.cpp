@@ -23,6 +23,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 #include "V2Province.h"
 #include "../Log.h"
+#include "../Snapshot.h"
 #include "../EU3World/EU3World.h"
 #include "../EU3World/EU3Province.h"
 #include "V2Pop.h"
@@ -30,6 +31,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "V2Factory.h"
 #include <sstream>
 #include <algorithm>
+#include <unordered_map>
 #include <stdio.h>
 #include <sys/stat.h>
 
@@ -37,15 +39,23 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "wiz/load_data_types.h"
 
 
-V2Province::V2Province(const std::string& _filename)
+
+// the pop types that are looked for by name
+static const Symbol	anyPopType("*");
+static const Symbol	soldiersPopType("soldiers");
+static const Symbol	farmersPopType("farmers");
+static const Symbol	labourersPopType("labourers");
+
+
+V2Province::V2Province()
 {
 	srcProvince			= nullptr;
 
-	filename				= _filename;
+	filename				= "";
 	coastal				= false;
 	num					= 0;
 	name					= "";
-	owner					= "";
+	owner					= CountryTag();
 	//controler			= "";
 	cores.clear();
 	colonyLevel			= 0;
@@ -77,6 +87,13 @@ V2Province::V2Province(const std::string& _filename)
 	factories.clear();
 
 	resettable			= false;
+}
+
+
+V2Province::V2Province(const std::string& _filename)
+	: V2Province()
+{
+	filename				= _filename;
 
 	int slash = filename.find_last_of("\\");
 	int numDigits = filename.find_first_of("-") - slash - 2;
@@ -173,6 +190,83 @@ V2Province::V2Province(const std::string& _filename)
 }
 
 
+V2Province::V2Province(SnapshotReader& snapshot, ObjectPool<V2Pop>& popPool)
+	: V2Province()
+{
+	filename				= snapshot.readString();
+	coastal				= snapshot.readBool();
+	num					= static_cast<int>(snapshot.readInt());
+	name					= snapshot.readString();
+	owner					= snapshot.readTag();
+	cores.resize(snapshot.readCount(sizeof(long long)));
+	for (std::vector<CountryTag>::iterator itr = cores.begin(); snapshot.good() && (itr != cores.end()); ++itr)
+	{
+		*itr = snapshot.readTag();
+	}
+	colonyLevel			= static_cast<int>(snapshot.readInt());
+	colonial				= static_cast<int>(snapshot.readInt());
+	rgoType				= snapshot.readString();
+	terrain				= snapshot.readString();
+	lifeRating			= static_cast<int>(snapshot.readInt());
+	slaveState			= snapshot.readBool();
+	fortLevel			= static_cast<int>(snapshot.readInt());
+	navalBaseLevel		= static_cast<int>(snapshot.readInt());
+	railLevel			= static_cast<int>(snapshot.readInt());
+	slaveProportion	= snapshot.readDouble();
+
+	// the minority pops are the same objects as some of the old pops
+	size_t numPops = snapshot.readCount(sizeof(long long));
+	for (size_t i = 0; snapshot.good() && (i < numPops); ++i)
+	{
+		Symbol type				= snapshot.readString();
+		int size					= static_cast<int>(snapshot.readInt());
+		Symbol culture			= snapshot.readString();
+		Symbol religion		= snapshot.readString();
+		V2Pop* newPop = popPool.make(type, size, culture, religion);
+		oldPops.push_back(newPop);
+		if (snapshot.readBool())
+		{
+			minorityPops.push_back(newPop);
+		}
+	}
+}
+
+
+void V2Province::writeSnapshot(SnapshotWriter& snapshot) const
+{
+	snapshot.writeString(filename);
+	snapshot.writeBool(coastal);
+	snapshot.writeInt(num);
+	snapshot.writeString(name);
+	snapshot.writeString(owner);
+	snapshot.writeInt(cores.size());
+	for (std::vector<CountryTag>::const_iterator itr = cores.begin(); itr != cores.end(); ++itr)
+	{
+		snapshot.writeString(*itr);
+	}
+	snapshot.writeInt(colonyLevel);
+	snapshot.writeInt(colonial);
+	snapshot.writeString(rgoType);
+	snapshot.writeString(terrain);
+	snapshot.writeInt(lifeRating);
+	snapshot.writeBool(slaveState);
+	snapshot.writeInt(fortLevel);
+	snapshot.writeInt(navalBaseLevel);
+	snapshot.writeInt(railLevel);
+	snapshot.writeDouble(slaveProportion);
+
+	snapshot.writeInt(oldPops.size());
+	for (std::vector<const V2Pop*>::const_iterator itr = oldPops.begin(); itr != oldPops.end(); ++itr)
+	{
+		snapshot.writeString((*itr)->getType());
+		snapshot.writeInt((*itr)->getSize());
+		snapshot.writeString((*itr)->getCulture());
+		snapshot.writeString((*itr)->getReligion());
+		snapshot.writeBool(std::find(minorityPops.begin(), minorityPops.end(), *itr) != minorityPops.end());
+	}
+}
+
+
 void V2Province::output() const
 {
 	FILE* output;
@@ -185,14 +279,14 @@ void V2Province::output() const
 		LOG(LogLevel::Error) << "Could not create province history file Output\\" << Configuration::getOutputName() << "\\history\\provinces\\" << filename << " - " << errStr;
 		exit(-1);
 	}
-	if (owner != "")
+	if (!owner.empty())
 	{
-		fprintf_s(output, "owner= %s\n", owner.c_str());
-		fprintf_s(output, "controller= %s\n", owner.c_str());
+		fprintf_s(output, "owner= %s\n", owner.str().c_str());
+		fprintf_s(output, "controller= %s\n", owner.str().c_str());
 	}
 	for (unsigned int i = 0; i < cores.size(); i++)
 	{
-		fprintf_s(output, "add_core= %s\n", cores[i].c_str());
+		fprintf_s(output, "add_core= %s\n", cores[i].str().c_str());
 	}
 	if (rgoType != "")
 	{
@@ -350,7 +444,7 @@ void V2Province::determineColonial()
 }
 
 
-void V2Province::addCore(const std::string&  newCore)
+void V2Province::addCore(CountryTag newCore)
 {
 	// only add if unique
 	if ( find(cores.begin(), cores.end(), newCore) == cores.end() )
@@ -373,21 +467,21 @@ void V2Province::addMinorityPop(V2Pop* minorityPop)
 }
 
 
-void V2Province::doCreatePops(WorldType game, double popWeightRatio, V2Country* _owner)
+void V2Province::doCreatePops(WorldType game, double popWeightRatio, V2Country* _owner, ObjectPool<V2Pop>& popPool)
 {
 	// convert pops
 	for (std::vector<V2Demographic>::const_iterator itr = demographics.begin(); itr != demographics.end(); ++itr)
 	{
-		createPops(game, *itr, popWeightRatio, _owner);
+		createPops(game, *itr, popWeightRatio, _owner, popPool);
 	}
-	combinePops();
+	combineAlikePops(pops);
 
 	// organize pops for adding minorities
-	std::map<std::string, int>					totals;
-	std::map<std::string, std::vector<V2Pop*>>	thePops;
+	std::unordered_map<Symbol, int>						totals;
+	std::unordered_map<Symbol, std::vector<V2Pop*>>	thePops;
 	for (auto popItr: pops)
 	{
-		std::string type = popItr->getType();
+		Symbol type = popItr->getType();
 
 		auto totalsItr = totals.find(type);
 		if (totalsItr == totals.end())
@@ -432,18 +526,18 @@ void V2Province::doCreatePops(WorldType game, double popWeightRatio, V2Country*
 		{
 			for (auto popsItr: thePopsItr->second)
 			{
-				std::string newCulture		= minorityItr->getCulture();
-				std::string newReligion	= minorityItr->getReligion();
-				if (newCulture == "")
+				Symbol newCulture		= minorityItr->getCulture();
+				Symbol newReligion	= minorityItr->getReligion();
+				if (newCulture.empty())
 				{
 					newCulture = popsItr->getCulture();
 				}
-				if (newReligion == "")
+				if (newReligion.empty())
 				{
 					newReligion = popsItr->getReligion();
 				}
 
-				V2Pop* newMinority = new V2Pop(minorityItr->getType(), static_cast<int>(1.0 * popsItr->getSize() / totalTypePopulation * minorityItr->getSize() + 0.5), newCulture, newReligion);
+				V2Pop* newMinority = popPool.make(minorityItr->getType(), static_cast<int>(1.0 * popsItr->getSize() / totalTypePopulation * minorityItr->getSize() + 0.5), newCulture, newReligion);
 				actualMinorities.push_back(newMinority);
 
 				popsItr->changeSize(static_cast<int>(-1.0 * popsItr->getSize() / totalTypePopulation * minorityItr->getSize()));
@@ -456,11 +550,11 @@ void V2Province::doCreatePops(WorldType game, double popWeightRatio, V2Country*
 	{
 		pops.push_back(minorityItr);
 	}
-	combinePops();
+	combineAlikePops(pops);
 }
 
 
-void V2Province::createPops(WorldType game, const V2Demographic& demographic, double popWeightRatio, V2Country* _owner)
+void V2Province::createPops(WorldType game, const V2Demographic& demographic, double popWeightRatio, V2Country* _owner, ObjectPool<V2Pop>& popPool)
 {
 	const EU3Province*	oldProvince		= demographic.oldProvince;
 	const EU3Country*		oldCountry		= demographic.oldCountry;
@@ -508,109 +602,11 @@ void V2Province::createPops(WorldType game, const V2Demographic& demographic, do
 
 	if (game == DivineWind) // Gametype == dw
 	{
-		int govBuilding = 0;
-		if (oldProvince->hasBuilding("temple"))
-		{
-			govBuilding = 1;
-		}
-		else if (oldProvince->hasBuilding("courthouse"))
-		{
-			govBuilding = 2;
-		}
-		else if (oldProvince->hasBuilding("spy_agency"))
-		{
-			govBuilding = 3;
-		}
-		else if (oldProvince->hasBuilding("town_hall"))
-		{
-			govBuilding = 4;
-		}
-		else if (oldProvince->hasBuilding("college"))
-		{
-			govBuilding = 6;
-		}
-		else if (oldProvince->hasBuilding("cathedral"))
-		{
-			govBuilding = 8;
-		}
-
-		int armyBuilding = 0;
-		if (oldProvince->hasBuilding("armory"))
-		{
-			armyBuilding = 1;
-		}
-		else if (oldProvince->hasBuilding("training_fields"))
-		{
-			armyBuilding = 2;
-		}
-		else if (oldProvince->hasBuilding("barracks"))
-		{
-			armyBuilding = 3;
-		}
-		else if (oldProvince->hasBuilding("regimental_camp"))
-		{
-			armyBuilding = 4;
-		}
-		else if (oldProvince->hasBuilding("arsenal"))
-		{
-			armyBuilding = 6;
-		}
-		else if (oldProvince->hasBuilding("conscription_center"))
-		{
-			armyBuilding = 8;
-		}
-
-		int productionBuilding = 0;
-		if (oldProvince->hasBuilding("constable"))
-		{
-			productionBuilding = 1;
-		}
-		else if (oldProvince->hasBuilding("workshop"))
-		{
-			productionBuilding = 2;
-		}
-		else if (oldProvince->hasBuilding("counting_house"))
-		{
-			productionBuilding = 3;
-		}
-		else if (oldProvince->hasBuilding("treasury_office"))
-		{
-			productionBuilding = 4;
-		}
-		else if (oldProvince->hasBuilding("mint"))
-		{
-			productionBuilding = 6;
-		}
-		else if (oldProvince->hasBuilding("stock_exchange"))
-		{
-			productionBuilding = 8;
-		}
-
-		int tradeBuilding = 0;
-		if (oldProvince->hasBuilding("marketplace"))
-		{
-			tradeBuilding = 1;
-		}
-		else if (oldProvince->hasBuilding("trade_depot"))
-		{
-			tradeBuilding = 2;
-		}
-		else if (oldProvince->hasBuilding("canal"))
-		{
-			tradeBuilding = 3;
-		}
-		else if (oldProvince->hasBuilding("road_network"))
-		{
-			tradeBuilding = 4;
-		}
-		else if (oldProvince->hasBuilding("post_office"))
-		{
-			tradeBuilding = 6;
-		}
-		else if (oldProvince->hasBuilding("customs_house"))
-		{
-			tradeBuilding = 8;
-		}
+		const EU3BuildingSet& buildings = oldProvince->getBuildings();
+		int govBuilding			= getBuildingLineLevel(buildings, BUILDING_temple);
+		int armyBuilding			= getBuildingLineLevel(buildings, BUILDING_armory);
+		int productionBuilding	= getBuildingLineLevel(buildings, BUILDING_constable);
+		int tradeBuilding			= getBuildingLineLevel(buildings, BUILDING_marketplace);
 
 		artisans += 400;
 		artisans	+= productionBuilding * 125;
@@ -708,74 +704,74 @@ void V2Province::createPops(WorldType game, const V2Demographic& demographic, do
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * slaveProportion);
 		farmers -= size;
-		V2Pop* slavesPop = new V2Pop("slaves", size,	demographic.slaveCulture, demographic.religion);
+		V2Pop* slavesPop = popPool.make("slaves", size,	demographic.slaveCulture, demographic.religion);
 		pops.push_back(slavesPop);
 	}
 	if (soldiers > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (soldiers / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* soldiersPop = new V2Pop("soldiers", size, demographic.culture, demographic.religion);
+		V2Pop* soldiersPop = popPool.make("soldiers", size, demographic.culture, demographic.religion);
 		pops.push_back(soldiersPop);
 	}
 	if (craftsmen > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (craftsmen / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* craftsmenPop = new V2Pop("craftsmen", size,	demographic.culture, demographic.religion);
+		V2Pop* craftsmenPop = popPool.make("craftsmen", size,	demographic.culture, demographic.religion);
 		pops.push_back(craftsmenPop);
 	}
 	if (artisans > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (artisans / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* artisansPop = new V2Pop("artisans", size, demographic.culture, demographic.religion);
+		V2Pop* artisansPop = popPool.make("artisans", size, demographic.culture, demographic.religion);
 		pops.push_back(artisansPop);
 	}
 	if (clergymen > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (clergymen / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* clergymenPop = new V2Pop("clergymen", size,	demographic.culture, demographic.religion);
+		V2Pop* clergymenPop = popPool.make("clergymen", size,	demographic.culture, demographic.religion);
 		pops.push_back(clergymenPop);
 	}
 	if (clerks > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (clerks / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* clerksPop = new V2Pop("clerks", size,	demographic.culture, demographic.religion);
+		V2Pop* clerksPop = popPool.make("clerks", size,	demographic.culture, demographic.religion);
 		pops.push_back(clerksPop);
 	}
 	if (bureaucrats > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (bureaucrats / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* bureaucratsPop = new V2Pop("bureaucrats", size, demographic.culture, demographic.religion);
+		V2Pop* bureaucratsPop = popPool.make("bureaucrats", size, demographic.culture, demographic.religion);
 		pops.push_back(bureaucratsPop);
 	}
 	if (officers > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (officers / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* officersPop = new V2Pop("officers", size, demographic.culture, demographic.religion);
+		V2Pop* officersPop = popPool.make("officers", size, demographic.culture, demographic.religion);
 		pops.push_back(officersPop);
 	}
 	if (capitalists > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (capitalists / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* capitalistsPop = new V2Pop("capitalists", size, demographic.culture, demographic.religion);
+		V2Pop* capitalistsPop = popPool.make("capitalists", size, demographic.culture, demographic.religion);
 		pops.push_back(capitalistsPop);
 	}
 	if (aristocrats > 0)
 	{
 		int size = static_cast<int>(demographic.ratio * newPopulation * (aristocrats / 10000) + 0.5);
 		farmers -= size;
-		V2Pop* aristocratsPop = new V2Pop("aristocrats", size, demographic.culture, demographic.religion);
+		V2Pop* aristocratsPop = popPool.make("aristocrats", size, demographic.culture, demographic.religion);
 		pops.push_back(aristocratsPop);
 	}
 
-	V2Pop* farmersPop = new V2Pop("farmers", farmers, demographic.culture, demographic.religion);
+	V2Pop* farmersPop = popPool.make("farmers", farmers, demographic.culture, demographic.religion);
 	pops.push_back(farmersPop);
 
 	//LOG(LogLevel::Info) << "Name: " << this->getSrcProvince()->getProvName() << " demographics.ratio: " << demographic.ratio << " newPopulation: " << newPopulation 
@@ -784,45 +780,6 @@ void V2Province::createPops(WorldType game, const V2Demographic& demographic, do
 }
 
 
-void V2Province::combinePops()
-{
-	std::vector<V2Pop*> trashPops;
-	for (std::vector<V2Pop*>::iterator lhs = pops.begin(); lhs != pops.end(); ++lhs)
-	{
-		std::vector<V2Pop*>::iterator rhs = lhs;
-		for (++rhs; rhs != pops.end(); ++rhs)
-		{
-			if ( (*lhs)->combine(**rhs) )
-			{
-				trashPops.push_back(*rhs);
-			}
-			if ( (*rhs)->getSize() < 1 )
-			{
-				trashPops.push_back(*rhs);
-			}
-		}
-	}
-
-	std::vector<V2Pop*> consolidatedPops;
-	for (std::vector<V2Pop*>::iterator itr = pops.begin(); itr != pops.end(); ++itr)
-	{
-		bool isTrashed = false;
-		for (std::vector<V2Pop*>::iterator titr = trashPops.begin(); titr != trashPops.end(); ++titr)
-		{
-			if (*itr == *titr)
-			{
-				isTrashed = true;
-			}
-		}
-		if (!isTrashed)
-		{
-			consolidatedPops.push_back(*itr);
-		}
-	}
-	pops.swap(consolidatedPops);
-}
-
-
 void V2Province::addFactory(V2Factory* factory)
 {
 	std::map<std::string, V2Factory*>::iterator itr = factories.find(factory->getTypeName());
@@ -866,12 +823,12 @@ int V2Province::getTotalPopulation() const
 }
 
 
-std::vector<V2Pop*> V2Province::getPops(const std::string&  type) const
+std::vector<V2Pop*> V2Province::getPops(Symbol type) const
 {
 	std::vector<V2Pop*> retval;
 	for (std::vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
 	{
-		if (type == "*" || (*itr)->getType() == type)
+		if (type == anyPopType || (*itr)->getType() == type)
 			retval.push_back(*itr);
 	}
 	return retval;
@@ -896,7 +853,7 @@ static int getRequiredPopForRegimentCount(int count)
 // pick a soldier pop to use for an army.  prefer larger pops to smaller ones, and grow only if necessary.
 V2Pop* V2Province::getSoldierPopForArmy(bool force)
 {
-	std::vector<V2Pop*> spops = getPops("soldiers");
+	std::vector<V2Pop*> spops = getPops(soldiersPopType);
 	if (spops.size() == 0)
 		return nullptr; // no soldier pops
 
@@ -944,7 +901,7 @@ bool V2Province::growSoldierPop(V2Pop* pop)
 		bool foundSourcePop = false;
 		for (std::vector<V2Pop*>::iterator isrc = pops.begin(); isrc != pops.end(); ++isrc)
 		{
-			if ( (*isrc)->getType() == "farmers" || (*isrc)->getType() == "labourers" )
+			if ( (*isrc)->getType() == farmersPopType || (*isrc)->getType() == labourersPopType )
 			{
 				if ( (*isrc)->getCulture() == pop->getCulture() && (*isrc)->getReligion() == pop->getReligion() )
 				{
@@ -976,12 +933,12 @@ std::pair<int, int> V2Province::getAvailableSoldierCapacity() const
 	int provincePop = getTotalPopulation();
 	for (std::vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
 	{
-		if ( (*itr)->getType() == "soldiers" )
+		if ( (*itr)->getType() == soldiersPopType )
 		{
 			// unused capacity is the size of the pop minus the capacity already used, or 0, if it's already overdrawn
 			soldierCap += std::max( (*itr)->getSize() - getRequiredPopForRegimentCount( (*itr)->getSupportedRegimentCount() ), 0 );
 		}
-		else if ( (*itr)->getType() == "farmers" || (*itr)->getType() == "labourers" )
+		else if ( (*itr)->getType() == farmersPopType || (*itr)->getType() == labourersPopType )
 		{
 			// unused capacity is the size of the pop in excess of 10% of the province pop, or 0, if it's already too small
 			draftCap += std::max( (*itr)->getSize() - int(0.10 * provincePop), 0 );
@@ -1025,7 +982,7 @@ std::string V2Province::getRegimentName(RegimentCategory rc)
 }
 
 
-bool V2Province::hasCulture(const std::string&  culture, float percentOfPopulation) const
+bool V2Province::hasCulture(Symbol culture, float percentOfPopulation) const
 {
 	int culturePops = 0;
 	for (std::vector<V2Pop*>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
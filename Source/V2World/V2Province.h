@@ -26,21 +26,25 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+#include "../Arena.h"
 #include "../Configuration.h"
+#include "../Symbol.h"
 #include "../EU3World/EU3World.h"
 #include "../EU3World/EU3Country.h"
 
 class V2Pop;
 class V2Factory;
 class V2Country;
+class SnapshotReader;
+class SnapshotWriter;
 
 
 
 struct V2Demographic
 {
-	std::string								culture;
-	std::string								slaveCulture;
-	std::string								religion;
+	Symbol								culture;
+	Symbol								slaveCulture;
+	Symbol								religion;
 	double								ratio;
 	EU3Province*						oldProvince;
 	EU3Country*							oldCountry;
@@ -51,29 +55,31 @@ class V2Province
 {
 	public:
 		V2Province(const std::string& _filename);
+		V2Province(SnapshotReader& snapshot, ObjectPool<V2Pop>& popPool);	// reads what writeSnapshot wrote
+		void writeSnapshot(SnapshotWriter& snapshot) const;	// the imported state: history, name, coast and old pops
 		void output() const;
 		void outputPops(FILE*) const;
 		void convertFromOldProvince(const EU3Province* oldProvince);
 		void determineColonial();
-		void addCore(const std::string&);
+		void addCore(CountryTag);
 		void addOldPop(const V2Pop*);
 		void addMinorityPop(V2Pop*);
-		void doCreatePops(WorldType game, double popWeightRatio, V2Country* _owner);
+		void doCreatePops(WorldType game, double popWeightRatio, V2Country* _owner, ObjectPool<V2Pop>& popPool);
 		void addFactory(V2Factory* factory);
 		void addPopDemographic(V2Demographic d);
 
 		int				getTotalPopulation() const;
 
-		std::vector<V2Pop*>	getPops(const std::string& type) const;
+		std::vector<V2Pop*>	getPops(Symbol type) const;		// "*" for every pop
 		V2Pop*			getSoldierPopForArmy(bool force = false);
 		std::pair<int, int>	getAvailableSoldierCapacity() const;
 		std::string			getRegimentName(RegimentCategory rc);
-		bool				hasCulture(const std::string& culture, float percentOfPopulation) const;
+		bool				hasCulture(Symbol culture, float percentOfPopulation) const;
 		
 		void				clearCores()									{ cores.clear(); }
 		void				setCoastal(bool _coastal)		noexcept			{ coastal = _coastal; }
 		void				setName(const std::string& _name)				noexcept { name = _name; }
-		void				setOwner(const std::string& _owner)				noexcept { owner = _owner; }
+		void				setOwner(CountryTag _owner)				noexcept { owner = _owner; }
 		void				setLandConnection(bool _connection)	noexcept { landConnection = _connection; }
 		void				setSameContinent(bool _same)		noexcept { sameContinent = _same; }
 		void				setFortLevel(int level)				noexcept { fortLevel = level; }
@@ -89,17 +95,18 @@ class V2Province
 		bool						wasColony()				const noexcept { return wasColonised; };
 		bool						isColonial()			const noexcept { return colonial != 0; };
 		std::string					getRgoType()			const noexcept { return rgoType; };
-		std::string					getOwner()				const noexcept { return owner; };
+		CountryTag					getOwner()				const noexcept { return owner; };
 		int						getNum()					const noexcept { return num; };
 		std::string					getName()				const noexcept { return name; };
 		bool						isCoastal()				const noexcept { return coastal; };
 		bool						hasNavalBase()			const noexcept { return (navalBaseLevel > 0); };
 		bool						hasLandConnection()	const noexcept { return landConnection; }
-		std::vector<V2Pop*>			getPops()				const noexcept { return pops; }
+		const std::vector<V2Pop*>&	getPops()				const noexcept { return pops; }
 	private:
+		V2Province();
+
 		void outputUnits(FILE*) const;
-		void createPops(WorldType game, const V2Demographic& d, double popWeightRatio, V2Country* _owner);
-		void combinePops();
+		void createPops(WorldType game, const V2Demographic& d, double popWeightRatio, V2Country* _owner, ObjectPool<V2Pop>& popPool);
 		bool growSoldierPop(V2Pop* pop);
 
 		const EU3Province*		srcProvince;
@@ -108,8 +115,8 @@ class V2Province
 		bool							coastal;
 		int							num;
 		std::string						name;
-		std::string						owner;
-		std::vector<std::string>				cores;
+		CountryTag						owner;
+		std::vector<CountryTag>				cores;
 		int							colonyLevel;
 		int							colonial;
 		bool							wasColonised;
@@ -378,7 +378,7 @@ V2UncivReforms::V2UncivReforms(int westernizationProgress, double milFocus, doub
 	if (reforms[10] == true)
 	{
 		country->addTech("post_napoleonic_thought");
-		auto provinces = country->getProvinces();
+		const auto& provinces = country->getProvinces();
 		auto provItr = provinces.find(country->getCapital());
 		if (provItr != provinces.end())
 		{
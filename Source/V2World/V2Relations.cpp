@@ -26,7 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
-V2Relations::V2Relations(const std::string& newTag)
+V2Relations::V2Relations(CountryTag newTag)
 {
 	tag					= newTag;
 	value					= 0;
@@ -37,7 +37,7 @@ V2Relations::V2Relations(const std::string& newTag)
 }
 
 
-V2Relations::V2Relations(const std::string& newTag, EU3Relations* oldRelations)
+V2Relations::V2Relations(CountryTag newTag, EU3Relations* oldRelations)
 {
 	tag					= newTag;
 	value					= oldRelations->getRelations();
@@ -50,7 +50,7 @@ V2Relations::V2Relations(const std::string& newTag, EU3Relations* oldRelations)
 
 void V2Relations::output(FILE* out) const
 {
-	fprintf(out, "\t%s=\n", tag.c_str());
+	fprintf(out, "\t%s=\n", tag.str().c_str());
 	fprintf(out, "\t{\n");
 	fprintf(out, "\t\tvalue=%d\n", value);
 	if (militaryAccess)
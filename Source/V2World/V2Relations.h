@@ -26,6 +26,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 
 
 
+#include "../CountryTag.h"
 #include "../Date.h"
 
 class EU3Relations;
@@ -35,17 +36,17 @@ class EU3Relations;
 class V2Relations
 {
 	public:
-		V2Relations(const std::string& newTag);
-		V2Relations(const std::string& newTag, EU3Relations* oldRelations);
+		V2Relations(CountryTag newTag);
+		V2Relations(CountryTag newTag, EU3Relations* oldRelations);
 		void output(FILE* out) const;
 
 		void		setLevel(int level);
 
-		std::string	getTag()			const noexcept { return tag; };
+		CountryTag	getTag()			const noexcept { return tag; };
 		int		getRelations()	const noexcept { return value; };
 		int		getLevel()		const noexcept { return level; };
 	private:
-		std::string	tag;
+		CountryTag	tag;
 		int		value;
 		bool		militaryAccess;
 		date		lastSendDiplomat;
@@ -77,7 +77,7 @@ bool V2State::hasLocalSupply(const std::string& product) const
 double V2State::getSuppliedInputs(const V2Factory* factory) const
 {
 	// find out the needs
-	std::map<std::string, float>	inputs	= factory->getInputs();
+	const std::map<std::string, float>&	inputs	= factory->getInputs();
 	int						numNeeds	= inputs.size();
 
 	// find out what we have from both RGOs and existing factories
@@ -168,12 +168,12 @@ double V2State::getManuRatio() const
 	for (auto itr = srcProvinces.begin(); itr != srcProvinces.end(); ++itr)
 	{
 		if (	(*itr != nullptr) &&
-				(	(*itr)->hasBuilding("refinery") ||
-					(*itr)->hasBuilding("wharf") ||
-					(*itr)->hasBuilding("weapons") ||
-					(*itr)->hasBuilding("textile") ||
-					(*itr)->hasBuilding("fine_arts_academy") ||
-					(*itr)->hasBuilding("university")
+				(	(*itr)->hasBuilding(BUILDING_refinery) ||
+					(*itr)->hasBuilding(BUILDING_wharf) ||
+					(*itr)->hasBuilding(BUILDING_weapons) ||
+					(*itr)->hasBuilding(BUILDING_textile) ||
+					(*itr)->hasBuilding(BUILDING_fine_arts_academy) ||
+					(*itr)->hasBuilding(BUILDING_university)
 				)
 			)
 		{
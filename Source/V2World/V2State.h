@@ -59,7 +59,7 @@ class V2State
 		bool						isColonial()		const noexcept { return colonial; };
 		int						getFactoryCount()	const noexcept { return factories.size(); };
 		int						getID()				const noexcept { return id; };
-		std::vector<V2Province*>	getProvinces()		const noexcept { return provinces; };
+		const std::vector<V2Province*>&	getProvinces()	const noexcept { return provinces; };
 	private:
 		bool	hasCOT();
 		int								id;
@@ -30,10 +30,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include <queue>
 #include <cmath>
 #include <cfloat>
+#include <new>
+#include <stdexcept>
 #include <sys/stat.h>
 #include "../Log.h"
+#include "../Diagnostics.h"
+#include "../FieldTable.h"
 #include "../Mapper.h"
 #include "../Configuration.h"
+#include "../Parallel.h"
+#include "../Snapshot.h"
 #include "../WinUtils.h"
 #include "../EU3World/EU3World.h"
 #include "../EU3World/EU3Relations.h"
@@ -48,6 +54,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "V2Leader.h"
 #include "V2Pop.h"
 #include "V2Country.h"
+#include "V2Gametype.h"
 #include "V2Reforms.h"
 #include "V2Flags.h"
 #include "V2LeaderTraits.h"
@@ -66,7 +73,86 @@ typedef struct fileWithCreateTime
 } fileWithCreateTime;
 
 
+// A country listed in common\countries.txt, with the parties from its own file
+struct V2World::potentialCountry
+{
+	CountryTag				tag;
+	std::string				countryFileName;
+	std::vector<V2Party>	parties;
+	bool						dynamic;
+};
+
+
+static const char* const V2WorldSnapshotFile = "V2World.snapshot";
+
+
 V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorities)
+{
+	totalWorldPopulation	= 0;
+	lastArmyID				= 0;
+
+	// The imported data only changes with the game install, so it is kept as a snapshot between runs
+	SnapshotKey snapshotKey;
+	snapshotKey.addFolder(Configuration::getV2Path() + "\\history\\provinces");
+	snapshotKey.addFolder(".\\blankMod\\output\\history\\provinces");
+	snapshotKey.addFile(Configuration::getV2Path() + "\\localisation\\text.csv");
+	snapshotKey.addFile(".\\blankMod\\output\\localisation\\text.csv");
+	snapshotKey.addFolder(Configuration::getV2Path() + "\\history\\pops\\1836.1.1");
+	snapshotKey.addFolder(".\\blankMod\\output\\history\\pops\\1836.1.1");
+	snapshotKey.addFile(Configuration::getV2Path() + "\\map\\positions.txt");
+	snapshotKey.addFile(Configuration::getV2Path() + "\\common\\countries.txt");
+	snapshotKey.addFile(".\\blankMod\\output\\common\\countries.txt");
+	snapshotKey.addFolder(Configuration::getV2Path() + "\\common\\countries");
+	snapshotKey.addFolder(".\\blankMod\\output\\common\\countries");
+	for (std::vector<std::pair<std::string, std::string>>::const_iterator itr = minorities.begin(); itr != minorities.end(); ++itr)
+	{
+		snapshotKey.addString(itr->first);
+		snapshotKey.addString(itr->second);
+	}
+
+	std::vector<potentialCountry> countryList;
+	SnapshotReader snapshot;
+	if (	!Configuration::getStaticDataCache() ||
+			!snapshot.open(V2WorldSnapshotFile, snapshotKey) ||
+			!readSnapshot(snapshot, countryList)
+		)
+	{
+		snapshot.close();
+		importProvinces(minorities);
+		countryList = importPotentialCountries();
+		if (Configuration::getStaticDataCache())
+		{
+			SnapshotWriter newSnapshot;
+			writeSnapshot(newSnapshot, countryList);
+			newSnapshot.save(V2WorldSnapshotFile, snapshotKey);
+		}
+	}
+
+	LOG(LogLevel::Info) << "Getting potential countries";
+	countries.clear();
+	potentialCountries.clear();
+	dynamicCountries.clear();
+	for (std::vector<potentialCountry>::const_iterator itr = countryList.begin(); itr != countryList.end(); ++itr)
+	{
+		std::vector<V2Party*> localParties;
+		for (std::vector<V2Party>::const_iterator partyItr = itr->parties.begin(); partyItr != itr->parties.end(); ++partyItr)
+		{
+			localParties.push_back(arena.make<V2Party>(*partyItr));
+		}
+
+		V2Country* newCountry = arena.make<V2Country>(itr->tag, itr->countryFileName, localParties, this, false, itr->dynamic);
+		potentialCountries.push_back(newCountry);
+		if (itr->dynamic)
+		{
+			dynamicCountries.insert( std::make_pair(itr->tag, newCountry) );
+		}
+	}
+
+	colonies.clear();
+}
+
+
+void V2World::importProvinces(const std::vector<std::pair<std::string, std::string>>& minorities)
 {
 	LOG(LogLevel::Info) << "Importing provinces";
 
@@ -74,6 +160,7 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 	intptr_t					fileListing = 0;
 	std::list<std::string>			directories;
 	directories.push_back("");
+	std::vector<std::string>	provinceFiles;
 	struct _stat st;
 	/*if (_stat(".\\blankMod\\output\\history\\provinces\\", &st) == 0)
 	{
@@ -133,8 +220,7 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 				}
 				else
 				{
-					V2Province* newProvince = new V2Province(directories.front() + "\\" + provinceFileData.name);
-					provinces.insert(std::make_pair(newProvince->getNum(), newProvince));
+					provinceFiles.push_back(directories.front() + "\\" + provinceFileData.name);
 				}
 			} while (_findnext(fileListing, &provinceFileData) == 0);
 			_findclose(fileListing);
@@ -142,6 +228,17 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 		}
 	}
 
+	// each province parses its own history file, so the files can be read side by side
+	std::vector<V2Province*> newProvinces(provinceFiles.size());
+	ParallelFor(provinceFiles.size(), [&](size_t i)
+	{
+		newProvinces[i] = arena.make<V2Province>(provinceFiles[i]);
+	});
+	for (std::vector<V2Province*>::iterator itr = newProvinces.begin(); itr != newProvinces.end(); ++itr)
+	{
+		provinces.insert(std::make_pair((*itr)->getNum(), *itr));
+	}
+
 	// Get province names
 	if (_stat(".\\blankMod\\output\\localisation\\text.csv", &st) == 0)
 	{
@@ -156,191 +253,21 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 	LOG(LogLevel::Info) << "Importing historical pops.";
 	//std::map< std::string, std::map<std::string, long int> > countryPops; // country, poptype, num
 
-	totalWorldPopulation	= 0;
 	std::set<std::string> fileNames;
 	WinUtils::GetAllFilesInFolder(".\\blankMod\\output\\history\\pops\\1836.1.1\\", fileNames);
-	for (std::set<std::string>::iterator itr = fileNames.begin(); itr != fileNames.end(); itr++)
-	{
-		std::list<int>* popProvinces = new std::list<int>;
-		wiz::load_data::UserType	obj2; // generic object
-		wiz::load_data::LoadData::LoadDataFromFile3((".\\blankMod\\output\\history\\pops\\1836.1.1\\" + *itr), obj2, -1, 0);
-
-		for (unsigned int j = 0; j < obj2.GetUserTypeListSize(); j++)
-		{
-			int provNum = obj2.GetUserTypeList(j)->GetName().ToInt();
-			
-			std::map<int, V2Province*>::iterator k = provinces.find(provNum);
-			if (k == provinces.end())
-			{
-				LOG(LogLevel::Warning) << "Could not find province " << provNum << " for original pops.";
-				continue;
-			}
-			else
-			{
-				/*auto countryPopItr = countryPops.find(k->second->getOwner());
-				if (countryPopItr == countryPops.end())
-				{
-					std::map<std::string, long int> newCountryPop;
-					std::pair<std::map< std::string, std::map<std::string, long int> >::iterator, bool> newIterator = countryPops.insert(std::make_pair(k->second->getOwner(), newCountryPop));
-					countryPopItr = newIterator.first;
-				}*/
-
-				int provincePopulation			= 0;
-				int provinceSlavePopulation	= 0;
-
-				popProvinces->push_back(provNum);
-
-				for(long long l = 0; l < obj2.GetUserTypeList(j)->GetUserTypeListSize(); l++)
-				{
-					auto pops = obj2.GetUserTypeList(j);
-					std::string	popType		= pops->GetUserTypeList(l)->GetName().ToString();
-					int		popSize = pops->GetUserTypeList(l)->GetItem("size")[0].Get(0).ToInt();
-					std::string	popCulture = pops->GetUserTypeList(l)->GetItem("culture")[0].Get(0).ToString();
-					std::string	popReligion	= pops->GetUserTypeList(l)->GetItem("religion")[0].Get(0).ToString();
-
-					/*auto popItr = countryPopItr->second.find(pops[l]->getKey());
-					if (popItr == countryPopItr->second.end())
-					{
-						long int newPopSize = 0;
-						std::pair<std::map<std::string, long int>::iterator, bool> newIterator = countryPopItr->second.insert(std::make_pair(popType, newPopSize));
-						popItr = newIterator.first;
-					}
-					popItr->second += popSize;*/
-
-					totalWorldPopulation += popSize;
-					V2Pop* newPop = new V2Pop(popType, popSize, popCulture, popReligion);
-					k->second->addOldPop(newPop);
+	importPops(".\\blankMod\\output\\history\\pops\\1836.1.1\\", std::vector<std::string>(fileNames.begin(), fileNames.end()), minorities);
 
-					for (auto minorityItr : minorities)
-					{
-						if ((popCulture == minorityItr.first) && (popReligion == minorityItr.second))
-						{
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-						else if ((minorityItr.first == "") && (popReligion == minorityItr.second))
-						{
-							newPop->setCulture("");
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-						else if ((popCulture == minorityItr.first) && (minorityItr.second == ""))
-						{
-							newPop->setReligion("");
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-					}
-
-					if ((popType == "slaves") || (popCulture.substr(0, 4) == "afro"))
-					{
-						provinceSlavePopulation += popSize;
-					}
-					provincePopulation += popSize;
-				}
-				auto province = provinces.find(provNum);
-				if (province != provinces.end())
-				{
-					province->second->setSlaveProportion( 1.0 * provinceSlavePopulation / provincePopulation);
-				}
-			}
-			popRegions.insert( std::make_pair(*itr, popProvinces) );
-		}
-	}
+	// the base game's files only fill in what the blank mod doesn't have
 	WinUtils::GetAllFilesInFolder(Configuration::getV2Path() + "\\history\\pops\\1836.1.1\\", fileNames);
+	std::vector<std::string> baseGameFiles;
 	for (std::set<std::string>::iterator itr = fileNames.begin(); itr != fileNames.end(); itr++)
 	{
-		auto duplicateCheck = popRegions.find(*itr);
-		if (duplicateCheck != popRegions.end())
+		if (popRegions.find(*itr) == popRegions.end())
 		{
-			continue;
-		}
-
-		std::list<int>* popProvinces = new std::list<int>;
-		wiz::load_data::UserType	obj2;
-		wiz::load_data::LoadData::LoadDataFromFile3((Configuration::getV2Path() + "\\history\\pops\\1836.1.1\\" + *itr), obj2, -1, 0);
-
-		for (unsigned int j = 0; j < obj2.GetUserTypeListSize(); j++)
-		{
-			int provNum = obj2.GetUserTypeList(j)->GetName().ToInt(); 
-			std::map<int, V2Province*>::iterator k = provinces.find(provNum);
-			if (k == provinces.end())
-			{
-				LOG(LogLevel::Warning) << "Could not find province " << provNum << " for original pops.";
-				continue;
-			}
-			else
-			{
-				/*auto countryPopItr = countryPops.find(k->second->getOwner());
-				if (countryPopItr == countryPops.end())
-				{
-					std::map<std::string, long int> newCountryPop;
-					std::pair<std::map< std::string, std::map<std::string, long int> >::iterator, bool> newIterator = countryPops.insert(std::make_pair(k->second->getOwner(), newCountryPop));
-					countryPopItr = newIterator.first;
-				}*/
-
-				int provincePopulation			= 0;
-				int provinceSlavePopulation	= 0;
-
-				popProvinces->push_back(provNum);
-
-				auto pops = obj2.GetUserTypeList(j);
-				for(unsigned int l = 0; l < pops->GetUserTypeListSize(); l++)
-				{
-					std::string	popType		= pops->GetUserTypeList(l)->GetName().ToString();
-					int		popSize = pops->GetUserTypeList(l)->GetItem("size")[0].Get(0).ToInt();
-					std::string	popCulture	= pops->GetUserTypeList(l)->GetItem("culture")[0].Get(0).ToString();
-					std::string	popReligion	= pops->GetUserTypeList(l)->GetItem("religion")[0].Get(0).ToString();
-
-					/*auto popItr = countryPopItr->second.find(pops[l]->getKey());
-					if (popItr == countryPopItr->second.end())
-					{
-						long int newPopSize = 0;
-						std::pair<std::map<std::string, long int>::iterator, bool> newIterator = countryPopItr->second.insert(std::make_pair(popType, newPopSize));
-						popItr = newIterator.first;
-					}
-					popItr->second += popSize;*/
-
-					totalWorldPopulation += popSize;
-					V2Pop* newPop = new V2Pop(popType, popSize, popCulture, popReligion);
-					k->second->addOldPop(newPop);
-
-					for (auto minorityItr : minorities)
-					{
-						if ((popCulture == minorityItr.first) && (popReligion == minorityItr.second))
-						{
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-						else if ((minorityItr.first == "") && (popReligion == minorityItr.second))
-						{
-							newPop->setCulture("");
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-						else if ((popCulture == minorityItr.first) && (minorityItr.second == ""))
-						{
-							newPop->setReligion("");
-							k->second->addMinorityPop(newPop);
-							break;
-						}
-					}
-
-					if ((popType == "slaves") || (popCulture.substr(0, 4) == "afro"))
-					{
-						provinceSlavePopulation += popSize;
-					}
-					provincePopulation += popSize;
-				}
-				auto province = provinces.find(provNum);
-				if (province != provinces.end())
-				{
-					province->second->setSlaveProportion( 1.0 * provinceSlavePopulation / provincePopulation);
-				}
-			}
-			popRegions.insert( std::make_pair(*itr, popProvinces) );
+			baseGameFiles.push_back(*itr);
 		}
 	}
+	importPops(Configuration::getV2Path() + "\\history\\pops\\1836.1.1\\", baseGameFiles, minorities);
 
 	/*for (auto countryItr = countryPops.begin(); countryItr != countryPops.end(); countryItr++)
 	{
@@ -388,23 +315,21 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 		if (objNavalBase.size() != 0)
 		{
 			// this province is coastal
-			for (std::map<int, V2Province*>::iterator pitr = provinces.begin(); pitr != provinces.end(); ++pitr)
+			ProvinceTable<V2Province*>::iterator pitr = provinces.find(provinceNum);
+			if (pitr != provinces.end())
 			{
-				if ( pitr->first == provinceNum)
-				{
-					pitr->second->setCoastal(true);
-					break;
-				}
+				pitr->second->setCoastal(true);
 			}
 		}
 	}
+}
 
-	countries.clear();
 
-	LOG(LogLevel::Info) << "Getting potential countries";
-	potentialCountries.clear();
-	dynamicCountries.clear();
-	const date FirstStartDate = date("1836.1.1");
+std::vector<V2World::potentialCountry> V2World::importPotentialCountries()
+{
+	LOG(LogLevel::Info) << "Reading potential countries";
+	std::vector<potentialCountry> countryList;
+	struct _stat st;
 	std::ifstream V2CountriesInput;
 	if (_stat(".\\blankMod\\output\\common\\countries.txt", &st) == 0)
 	{
@@ -469,28 +394,322 @@ V2World::V2World(const std::vector<std::pair<std::string, std::string>>& minorit
 			continue;
 		}
 
+		potentialCountry newCountry;
+		newCountry.tag					= tag;
+		newCountry.countryFileName	= countryFileName;
+		newCountry.dynamic			= !staticSection;
 		std::vector<wiz::load_data::UserType*> partyData = countryData.GetUserTypeItem("party");
-		std::vector<V2Party*> localParties;
 		for (std::vector<wiz::load_data::UserType*>::iterator itr = partyData.begin(); itr != partyData.end(); ++itr)
 		{
-			V2Party* newParty = new V2Party(*itr);
-			localParties.push_back(newParty);
+			newCountry.parties.push_back(V2Party(*itr));
 		}
+		countryList.push_back(newCountry);
+	}
+	V2CountriesInput.close();
+
+	return countryList;
+}
 
-		V2Country* newCountry = new V2Country(tag, countryFileName, localParties, this, false, !staticSection);
-		if (staticSection)
+
+static void WritePartySnapshot(SnapshotWriter& snapshot, const V2Party& party)
+{
+	snapshot.writeString(party.name);
+	snapshot.writeString(party.ideology);
+	snapshot.writeDate(party.start_date);
+	snapshot.writeDate(party.end_date);
+	snapshot.writeString(party.economic_policy);
+	snapshot.writeString(party.trade_policy);
+	snapshot.writeString(party.religious_policy);
+	snapshot.writeString(party.citizenship_policy);
+	snapshot.writeString(party.war_policy);
+}
+
+
+static V2Party ReadPartySnapshot(SnapshotReader& snapshot)
+{
+	V2Party party;
+	party.name						= snapshot.readString();
+	party.ideology					= snapshot.readString();
+	party.start_date				= snapshot.readDate();
+	party.end_date					= snapshot.readDate();
+	party.economic_policy		= snapshot.readString();
+	party.trade_policy			= snapshot.readString();
+	party.religious_policy		= snapshot.readString();
+	party.citizenship_policy	= snapshot.readString();
+	party.war_policy				= snapshot.readString();
+	return party;
+}
+
+
+void V2World::writeSnapshot(SnapshotWriter& snapshot, const std::vector<potentialCountry>& countryList) const
+{
+	snapshot.writeInt(provinces.size());
+	for (ProvinceTable<V2Province*>::const_iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	{
+		itr->second->writeSnapshot(snapshot);
+	}
+
+	snapshot.writeInt(popRegions.size());
+	for (std::map<std::string, std::list<int>* >::const_iterator itr = popRegions.begin(); itr != popRegions.end(); ++itr)
+	{
+		snapshot.writeString(itr->first);
+		snapshot.writeInt(itr->second->size());
+		for (std::list<int>::const_iterator provItr = itr->second->begin(); provItr != itr->second->end(); ++provItr)
 		{
-			potentialCountries.push_back(newCountry);
+			snapshot.writeInt(*provItr);
 		}
-		else
+	}
+	snapshot.writeInt(totalWorldPopulation);
+
+	snapshot.writeInt(countryList.size());
+	for (std::vector<potentialCountry>::const_iterator itr = countryList.begin(); itr != countryList.end(); ++itr)
+	{
+		snapshot.writeString(itr->tag);
+		snapshot.writeString(itr->countryFileName);
+		snapshot.writeBool(itr->dynamic);
+		snapshot.writeInt(itr->parties.size());
+		for (std::vector<V2Party>::const_iterator partyItr = itr->parties.begin(); partyItr != itr->parties.end(); ++partyItr)
 		{
-			potentialCountries.push_back(newCountry);
-			dynamicCountries.insert( std::make_pair(tag, newCountry) );
+			WritePartySnapshot(snapshot, *partyItr);
 		}
 	}
-	V2CountriesInput.close();
+}
 
-	colonies.clear();
+
+bool V2World::readSnapshot(SnapshotReader& snapshot, std::vector<potentialCountry>& countryList)
+{
+	LOG(LogLevel::Info) << "Reading imported provinces and countries from " << V2WorldSnapshotFile;
+
+	try
+	{
+		size_t numProvinces = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numProvinces); ++i)
+		{
+			V2Province* newProvince = arena.make<V2Province>(snapshot, popPool);
+			provinces.insert(std::make_pair(newProvince->getNum(), newProvince));
+		}
+
+		size_t numPopRegions = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numPopRegions); ++i)
+		{
+			std::string		fileName		= snapshot.readString();
+			std::list<int>*	popProvinces	= arena.make<std::list<int>>();
+			size_t numPopProvinces = snapshot.readCount(sizeof(long long));
+			for (size_t j = 0; snapshot.good() && (j < numPopProvinces); ++j)
+			{
+				popProvinces->push_back(static_cast<int>(snapshot.readInt()));
+			}
+			popRegions.insert( std::make_pair(fileName, popProvinces) );
+		}
+		totalWorldPopulation = static_cast<long>(snapshot.readInt());
+
+		size_t numCountries = snapshot.readCount(sizeof(long long));
+		for (size_t i = 0; snapshot.good() && (i < numCountries); ++i)
+		{
+			potentialCountry newCountry;
+			newCountry.tag					= snapshot.readTag();
+			newCountry.countryFileName	= snapshot.readString();
+			newCountry.dynamic			= snapshot.readBool();
+			size_t numParties = snapshot.readCount(sizeof(long long));
+			for (size_t j = 0; snapshot.good() && (j < numParties); ++j)
+			{
+				newCountry.parties.push_back(ReadPartySnapshot(snapshot));
+			}
+			countryList.push_back(newCountry);
+		}
+	}
+	catch (const std::bad_alloc&)
+	{
+		snapshot.fail();
+	}
+	catch (const std::length_error&)
+	{
+		snapshot.fail();
+	}
+
+	if (!snapshot.good())
+	{
+		LOG(LogLevel::Warning) << V2WorldSnapshotFile << " is damaged; importing the V2 data instead";
+		// what was read stays in the arena until the world goes
+		provinces.clear();
+		popRegions.clear();
+		totalWorldPopulation = 0;
+		countryList.clear();
+		return false;
+	}
+
+	return true;
+}
+
+
+V2World::V2World(const V2World& base)
+{
+	// The imported pops and the pop regions are never changed by a conversion, so the copies share them
+	for (ProvinceTable<V2Province*>::const_iterator itr = base.provinces.begin(); itr != base.provinces.end(); ++itr)
+	{
+		provinces.insert( std::make_pair(itr->first, arena.make<V2Province>(*itr->second)) );
+	}
+
+	std::map<const V2Country*, V2Country*> copiedCountries;
+	for (std::vector<V2Country*>::const_iterator itr = base.potentialCountries.begin(); itr != base.potentialCountries.end(); ++itr)
+	{
+		V2Country* newCountry = arena.make<V2Country>(**itr, this);
+		copiedCountries.insert( std::make_pair(*itr, newCountry) );
+		potentialCountries.push_back(newCountry);
+	}
+	for (std::map<CountryTag, V2Country*>::const_iterator itr = base.dynamicCountries.begin(); itr != base.dynamicCountries.end(); ++itr)
+	{
+		dynamicCountries.insert( std::make_pair(itr->first, copiedCountries[itr->second]) );
+	}
+	for (std::map<CountryTag, V2Country*>::const_iterator itr = base.countries.begin(); itr != base.countries.end(); ++itr)
+	{
+		countries.insert( std::make_pair(itr->first, copiedCountries[itr->second]) );
+	}
+
+	diplomacy				= base.diplomacy;
+	colonies					= base.colonies;
+	popRegions				= base.popRegions;
+	totalWorldPopulation	= base.totalWorldPopulation;
+	lastArmyID				= 0;	// ids start over for every conversion
+}
+
+
+// One pop as read from a history\pops file
+struct historicalPop
+{
+	std::string	type;
+	int			size;
+	std::string	culture;
+	std::string	religion;
+	int			minority;	// which kind of minorities entry the pop matches, see ReadPopFile
+};
+
+
+struct historicalPopProvince
+{
+	int								num;
+	std::vector<historicalPop>	pops;
+};
+
+
+enum
+{
+	noMinority = 0,
+	minorityCultureReligion,	// both culture and religion match
+	minorityReligion,				// the entry has no culture, so the pop's culture is dropped
+	minorityCulture				// the entry has no religion, so the pop's religion is dropped
+};
+
+
+static std::vector<historicalPopProvince> ReadPopFile(const std::string& fileName, const std::vector<std::pair<std::string, std::string>>& minorities)
+{
+	static const FieldTable<historicalPop> fields = FieldTable<historicalPop>()
+		.field("size", &historicalPop::size)
+		.field("culture", &historicalPop::culture)
+		.field("religion", &historicalPop::religion);
+
+	std::vector<historicalPopProvince> popProvinces;
+	wiz::load_data::UserType obj2; // generic object
+	wiz::load_data::LoadData::LoadDataFromFile3(fileName, obj2, -1, 0);
+
+	for (long long j = 0; j < obj2.GetUserTypeListSize(); j++)
+	{
+		historicalPopProvince popProvince;
+		wiz::load_data::UserType* pops = obj2.GetUserTypeList(j);
+		popProvince.num = pops->GetName().ToInt();
+		popProvince.pops.resize(pops->GetUserTypeListSize());
+		for (long long l = 0; l < pops->GetUserTypeListSize(); l++)
+		{
+			historicalPop& pop	= popProvince.pops[l];
+			pop.type					= pops->GetUserTypeList(l)->GetName().ToString();
+			pop.size					= 0;
+			pop.minority			= noMinority;
+			fields.apply(pops->GetUserTypeList(l), pop);
+
+			for (auto minorityItr : minorities)
+			{
+				if ((pop.culture == minorityItr.first) && (pop.religion == minorityItr.second))
+				{
+					pop.minority = minorityCultureReligion;
+					break;
+				}
+				else if ((minorityItr.first == "") && (pop.religion == minorityItr.second))
+				{
+					pop.minority = minorityReligion;
+					break;
+				}
+				else if ((pop.culture == minorityItr.first) && (minorityItr.second == ""))
+				{
+					pop.minority = minorityCulture;
+					break;
+				}
+			}
+		}
+		popProvinces.push_back(std::move(popProvince));
+	}
+
+	return popProvinces;
+}
+
+
+void V2World::importPops(const std::string& folder, const std::vector<std::string>& fileNames, const std::vector<std::pair<std::string, std::string>>& minorities)
+{
+	// the files are parsed side by side, then added in file order so the result doesn't depend on the threads
+	std::vector<std::vector<historicalPopProvince>> popFiles(fileNames.size());
+	ParallelFor(fileNames.size(), [&](size_t i)
+	{
+		popFiles[i] = ReadPopFile(folder + fileNames[i], minorities);
+	});
+
+	for (size_t i = 0; i < fileNames.size(); ++i)
+	{
+		std::list<int>* popProvinces = arena.make<std::list<int>>();
+		for (std::vector<historicalPopProvince>::const_iterator itr = popFiles[i].begin(); itr != popFiles[i].end(); ++itr)
+		{
+			ProvinceTable<V2Province*>::iterator k = provinces.find(itr->num);
+			if (k == provinces.end())
+			{
+				LOG(LogLevel::Warning) << "Could not find province " << itr->num << " for original pops.";
+				continue;
+			}
+
+			int provincePopulation			= 0;
+			int provinceSlavePopulation	= 0;
+
+			popProvinces->push_back(itr->num);
+
+			for (std::vector<historicalPop>::const_iterator popItr = itr->pops.begin(); popItr != itr->pops.end(); ++popItr)
+			{
+				totalWorldPopulation += popItr->size;
+				V2Pop* newPop = popPool.make(popItr->type, popItr->size, popItr->culture, popItr->religion);
+				k->second->addOldPop(newPop);
+
+				switch (popItr->minority)
+				{
+					case minorityCultureReligion:
+						k->second->addMinorityPop(newPop);
+						break;
+					case minorityReligion:
+						newPop->setCulture("");
+						k->second->addMinorityPop(newPop);
+						break;
+					case minorityCulture:
+						newPop->setReligion("");
+						k->second->addMinorityPop(newPop);
+						break;
+				}
+
+				if ((popItr->type == "slaves") || (popItr->culture.substr(0, 4) == "afro"))
+				{
+					provinceSlavePopulation += popItr->size;
+				}
+				provincePopulation += popItr->size;
+			}
+			k->second->setSlaveProportion( 1.0 * provinceSlavePopulation / provincePopulation);
+
+			popRegions.insert( std::make_pair(fileNames[i], popProvinces) );
+		}
+	}
 }
 
 
@@ -512,21 +731,25 @@ void V2World::output() const
 		LOG(LogLevel::Error) << "Could not create countries file";
 		exit(-1);
 	}
-	for (std::map<std::string, V2Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	for (std::map<CountryTag, V2Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
 	{
 		const V2Country& country = *i->second;
-		std::map<std::string, V2Country*>::const_iterator j = dynamicCountries.find(country.getTag());
+		std::map<CountryTag, V2Country*>::const_iterator j = dynamicCountries.find(country.getTag());
 		if (j == dynamicCountries.end())
 		{
 			country.outputToCommonCountriesFile(allCountriesFile);
 		}
 	}
 	fprintf(allCountriesFile, "\n");
-	if ((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD_NNM"))
+	const bool hasDynamicDominions = withV2GametypeTraits(Configuration::getV2Gametype(), [](auto traits)
+	{
+		return decltype(traits)::hasDynamicDominions;
+	});
+	if (hasDynamicDominions)
 	{
 		fprintf(allCountriesFile, "##HoD Dominions\n");
 		fprintf(allCountriesFile, "dynamic_tags = yes # any tags after this is considered dynamic dominions\n");
-		for (std::map<std::string, V2Country*>::const_iterator i = dynamicCountries.begin(); 
+		for (std::map<CountryTag, V2Country*>::const_iterator i = dynamicCountries.begin(); 
 			i!= dynamicCountries.end(); ++i)
 		{
 			i->second->outputToCommonCountriesFile(allCountriesFile);
@@ -555,7 +778,7 @@ void V2World::output() const
 		LOG(LogLevel::Error) << "Could not update localisation text file";
 		exit(-1);
 	}
-	for (std::map<std::string, V2Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	for (std::map<CountryTag, V2Country*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
 	{
 		const V2Country& country = *i->second;
 		if (country.isNewCountry())
@@ -566,7 +789,7 @@ void V2World::output() const
 	fclose(localisationFile);
 
 	LOG(LogLevel::Debug) << "Writing provinces";
-	for (std::map<int, V2Province*>::const_iterator i = provinces.begin(); i != provinces.end(); ++i)
+	for (ProvinceTable<V2Province*>::const_iterator i = provinces.begin(); i != provinces.end(); ++i)
 	{
 		i->second->output();
 	}
@@ -644,7 +867,7 @@ void V2World::outputPops() const
 		for (std::list<int>::const_iterator provNumItr = itr->second->begin(); 
 			provNumItr != itr->second->end(); ++provNumItr)
 		{
-			std::map<int, V2Province*>::const_iterator provItr = provinces.find(*provNumItr);
+			ProvinceTable<V2Province*>::const_iterator provItr = provinces.find(*provNumItr);
 			if (provItr != provinces.end())
 			{
 				provItr->second->outputPops(popsFile);
@@ -654,8 +877,6 @@ void V2World::outputPops() const
 				LOG(LogLevel::Error) << "Could not find province " << *provNumItr << " while outputing pops!";
 			}
 		}
-
-		delete itr->second;
 	}
 }
 
@@ -667,25 +888,24 @@ bool scoresSorter(std::pair<V2Country*, int> first, std::pair<V2Country*, int> s
 
 
 void V2World::convertCountries(const EU3World& sourceWorld, const CountryMapping& countryMap,
-	const cultureMapping& cultureMap, const unionCulturesMap& unionCultures, const religionMapping& religionMap, 
+	const CultureRuleEngine& cultureRules, const unionCulturesMap& unionCultures, const religionMapping& religionMap, 
 	const governmentMapping& governmentMap, const inverseProvinceMapping& inverseProvinceMap, 
-	const std::vector<techSchool>& techSchools, std::map<int, int>& leaderMap, const V2LeaderTraits& lt,
-	const EU3RegionsMapping& regionsMap)
+	const std::vector<techSchool>& techSchools, std::map<int, int>& leaderMap, const V2LeaderTraits& lt)
 {
-	std::vector<std::string> outputOrder;
+	std::vector<CountryTag> outputOrder;
 	outputOrder.clear();
 	for (unsigned int i = 0; i < potentialCountries.size(); i++)
 	{
 		outputOrder.push_back(potentialCountries[i]->getTag());
 	}
 
-	std::map<std::string, EU3Country*> sourceCountries = sourceWorld.getCountries();
-	for (std::map<std::string, EU3Country*>::iterator i = sourceCountries.begin(); i != sourceCountries.end(); ++i)
+	const std::map<CountryTag, EU3Country*>& sourceCountries = sourceWorld.getCountries();
+	for (std::map<CountryTag, EU3Country*>::const_iterator i = sourceCountries.begin(); i != sourceCountries.end(); ++i)
 	{
 		EU3Country* sourceCountry = i->second;
-		std::string EU3Tag = sourceCountry->getTag();
+		CountryTag EU3Tag = sourceCountry->getTag();
 		V2Country* destCountry = nullptr;
-		const std::string& V2Tag = countryMap[EU3Tag];
+		CountryTag V2Tag = countryMap[EU3Tag];
 		if (!V2Tag.empty())
 		{
 			for (std::vector<V2Country*>::iterator j = potentialCountries.begin(); j != potentialCountries.end() 
@@ -700,10 +920,10 @@ void V2World::convertCountries(const EU3World& sourceWorld, const CountryMapping
 			if (!destCountry)
 			{ // No such V2 country exists yet for this tag so we make a new one.
 				std::string countryFileName = '/' + sourceCountry->getName() + ".txt";
-				destCountry = new V2Country(V2Tag, countryFileName, std::vector<V2Party*>(), this, true, false);
+				destCountry = arena.make<V2Country>(V2Tag, countryFileName, std::vector<V2Party*>(), this, true, false);
 			}
-			destCountry->initFromEU3Country(sourceCountry, outputOrder, countryMap, cultureMap, religionMap, 
-				unionCultures, governmentMap, inverseProvinceMap, techSchools, leaderMap, lt, regionsMap);
+			destCountry->initFromEU3Country(sourceCountry, outputOrder, countryMap, cultureRules, religionMap, 
+				unionCultures, governmentMap, inverseProvinceMap, techSchools, leaderMap, lt);
 			countries.insert(std::make_pair(V2Tag, destCountry));
 		}
 		else
@@ -716,7 +936,7 @@ void V2World::convertCountries(const EU3World& sourceWorld, const CountryMapping
 	std::list< std::pair<V2Country*, int> > libertyScores;
 	std::list< std::pair<V2Country*, int> > equalityScores;
 	std::set<V2Country*>					valuesUnset;
-	for (std::map<std::string, V2Country*>::iterator countryItr = countries.begin(); 
+	for (std::map<CountryTag, V2Country*>::iterator countryItr = countries.begin(); 
 		countryItr != countries.end(); ++countryItr)
 	{
 		int libertyScore = 1;
@@ -780,7 +1000,7 @@ void V2World::convertCountries(const EU3World& sourceWorld, const CountryMapping
 	// ALL potential countries should be output to the file, otherwise some things don't get initialized right
 	for (std::vector<V2Country*>::iterator itr = potentialCountries.begin(); itr != potentialCountries.end(); ++itr)
 	{
-		std::map<std::string, V2Country*>::iterator citr = countries.find((*itr)->getTag());
+		std::map<CountryTag, V2Country*>::iterator citr = countries.find((*itr)->getTag());
 		if (citr == countries.end())
 		{
 			(*itr)->initFromHistory();
@@ -790,9 +1010,9 @@ void V2World::convertCountries(const EU3World& sourceWorld, const CountryMapping
 
 	// put countries in the same order as potentialCountries was (this is the same order V2 will save them in)
 	/*std::vector<V2Country*> sortedCountries;
-	for (std::vector<std::string>::const_iterator oitr = outputOrder.begin(); oitr != outputOrder.end(); ++oitr)
+	for (std::vector<CountryTag>::const_iterator oitr = outputOrder.begin(); oitr != outputOrder.end(); ++oitr)
 	{
-		std::map<std::string, V2Country*>::iterator itr = countries.find((*itr)->getTag());
+		std::map<CountryTag, V2Country*>::iterator itr = countries.find((*itr)->getTag());
 		{
 			if ( (*itr)->getTag() == (*oitr) )
 			{
@@ -827,26 +1047,26 @@ void V2World::scalePrestige()
 
 void V2World::convertDiplomacy(const EU3World& sourceWorld, const CountryMapping& countryMap)
 {
-	std::vector<EU3Agreement> agreements = sourceWorld.getDiplomacy()->getAgreements();
-	for (std::vector<EU3Agreement>::iterator itr = agreements.begin(); itr != agreements.end(); ++itr)
+	const std::vector<EU3Agreement>& agreements = sourceWorld.getDiplomacy()->getAgreements();
+	for (std::vector<EU3Agreement>::const_iterator itr = agreements.begin(); itr != agreements.end(); ++itr)
 	{
-		const std::string& EU3Tag1 = itr->country1;
-		const std::string& V2Tag1 = countryMap[EU3Tag1];
+		CountryTag EU3Tag1 = itr->country1;
+		CountryTag V2Tag1 = countryMap[EU3Tag1];
 		if (V2Tag1.empty())
 		{
 			LOG(LogLevel::Warning) << "EU3 Country " << EU3Tag1 << " used in diplomatic agreement doesn't exist";
 			continue;
 		}
-		const std::string& EU3Tag2 = itr->country2;
-		const std::string& V2Tag2 = countryMap[EU3Tag2];
+		CountryTag EU3Tag2 = itr->country2;
+		CountryTag V2Tag2 = countryMap[EU3Tag2];
 		if (V2Tag2.empty())
 		{
 			LOG(LogLevel::Warning) << "EU3 Country " << EU3Tag2 << " used in diplomatic agreement doesn't exist";
 			continue;
 		}
 
-		std::map<std::string, V2Country*>::iterator country1 = countries.find(V2Tag1);
-		std::map<std::string, V2Country*>::iterator country2 = countries.find(V2Tag2);
+		std::map<CountryTag, V2Country*>::iterator country1 = countries.find(V2Tag1);
+		std::map<CountryTag, V2Country*>::iterator country2 = countries.find(V2Tag2);
 		if (country1 == countries.end())
 		{
 			LOG(LogLevel::Warning) << "Vic2 country " << V2Tag1 << " used in diplomatic agreement doesn't exist";
@@ -860,13 +1080,13 @@ void V2World::convertDiplomacy(const EU3World& sourceWorld, const CountryMapping
 		V2Relations* r1 = country1->second->getRelations(V2Tag2);
 		if (!r1)
 		{
-			r1 = new V2Relations(V2Tag2);
+			r1 = arena.make<V2Relations>(V2Tag2);
 			country1->second->addRelation(r1);
 		}
 		V2Relations* r2 = country2->second->getRelations(V2Tag1);
 		if (!r2)
 		{
-			r2 = new V2Relations(V2Tag1);
+			r2 = arena.make<V2Relations>(V2Tag1);
 			country2->second->addRelation(r2);
 		}
 
@@ -916,11 +1136,22 @@ struct MTo1ProvinceComp
 
 
 void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMapping& provinceMap, 
-	const resettableMap& resettableProvinces, const CountryMapping& countryMap, const cultureMapping& cultureMap,
-	const cultureMapping& slaveCultureMap, const religionMapping& religionMap, const stateIndexMapping& stateIndexMap, 
-	const EU3RegionsMapping& regionsMap)
+	const resettableMap& resettableProvinces, const CountryMapping& countryMap, const DemographicCache& demographicCache,
+	const stateIndexMapping& stateIndexMap)
+{
+	withV2GametypeTraits(Configuration::getV2Gametype(), [&](auto traits)
+	{
+		convertProvincesFor<decltype(traits)>(sourceWorld, provinceMap, resettableProvinces, countryMap, demographicCache, stateIndexMap);
+	});
+}
+
+
+template<typename Traits>
+void V2World::convertProvincesFor(const EU3World& sourceWorld, const provinceMapping& provinceMap,
+	const resettableMap& resettableProvinces, const CountryMapping& countryMap, const DemographicCache& demographicCache,
+	const stateIndexMapping& stateIndexMap)
 {
-	for (std::map<int, V2Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
+	for (ProvinceTable<V2Province*>::iterator i = provinces.begin(); i != provinces.end(); ++i)
 	{
 		int destNum												= i->first;
 		provinceMapping::const_iterator provinceLink	= provinceMap.find(destNum);
@@ -944,7 +1175,7 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 		EU3Province*	oldProvince	= nullptr;
 		EU3Country*		oldOwner		= nullptr;
 		// determine ownership by province count, or total base tax (if province count is tied)
-		std::map<std::string, MTo1ProvinceComp> provinceBins;
+		std::map<CountryTag, MTo1ProvinceComp> provinceBins;
 		double newProvinceTotalBaseTax = 0;
 		for (std::vector<int>::const_iterator itr = provinceLink->second.begin(); itr != provinceLink->second.end(); ++itr)
 		{
@@ -955,22 +1186,17 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 				continue;
 			}
 			EU3Country* owner = province->getOwner();
-			std::string tag;
+			CountryTag tag;
 			if (owner != nullptr)
 			{
 				tag = owner->getTag();
 			}
-			else
-			{
-				tag = "";
-			}
 			if (provinceBins.find(tag) == provinceBins.end())
 			{
 				provinceBins[tag] = MTo1ProvinceComp();
 			}
 
-			if (((Configuration::getV2Gametype() == "HOD") || (Configuration::getV2Gametype() == "HoD-NNM"))
-				&& (province->getPopulation() < 1000) && (owner != nullptr))
+			if (Traits::hasSmallColonies && (province->getPopulation() < 1000) && (owner != nullptr))
 			{
 				stateIndexMapping::const_iterator stateIndexMapping = stateIndexMap.find(i->first);
 				if (stateIndexMapping == stateIndexMap.end())
@@ -980,10 +1206,10 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 				}
 				else
 				{
-					std::map< int, std::set<std::string> >::iterator colony = colonies.find(stateIndexMapping->second);
+					std::map< int, std::set<CountryTag> >::iterator colony = colonies.find(stateIndexMapping->second);
 					if (colony == colonies.end())
 					{
-						std::set<std::string> countries;
+						std::set<CountryTag> countries;
 						countries.insert(owner->getTag());
 						colonies.insert( std::make_pair(stateIndexMapping->second, countries) );
 					}
@@ -1012,11 +1238,11 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 		}
 		if (oldOwner == nullptr)
 		{
-			i->second->setOwner("");
+			i->second->setOwner(CountryTag());
 			continue;
 		}
 
-		const std::string& V2Tag = countryMap[oldOwner->getTag()];
+		CountryTag V2Tag = countryMap[oldOwner->getTag()];
 		if (V2Tag.empty())
 		{
 			LOG(LogLevel::Warning) << "Could not map provinces owned by " << oldOwner->getTag();
@@ -1024,14 +1250,14 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 		else
 		{
 			i->second->setOwner(V2Tag);
-			std::map<std::string, V2Country*>::iterator ownerItr = countries.find(V2Tag);
+			std::map<CountryTag, V2Country*>::iterator ownerItr = countries.find(V2Tag);
 			if (ownerItr != countries.end())
 			{
 				ownerItr->second->addProvince(i->second);
 			}
 			i->second->convertFromOldProvince(oldProvince);
 
-			for (std::map<std::string, MTo1ProvinceComp>::iterator mitr = provinceBins.begin(); 
+			for (std::map<CountryTag, MTo1ProvinceComp>::iterator mitr = provinceBins.begin(); 
 				mitr != provinceBins.end(); ++mitr)
 			{
 				for (std::vector<EU3Province*>::iterator vitr = mitr->second.provinces.begin(); 
@@ -1041,7 +1267,7 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 					std::vector<EU3Country*> oldCores = (*vitr)->getCores(sourceWorld.getCountries());
 					for(std::vector<EU3Country*>::iterator j = oldCores.begin(); j != oldCores.end(); ++j)
 					{
-						std::string coreEU3Tag = (*j)->getTag();
+						CountryTag coreEU3Tag = (*j)->getTag();
 						// skip this core if the country is the owner of the EU3 province but not the V2 province
 						// (i.e. "avoid boundary conflicts that didn't exist in EU3").
 						// this country may still get core via a province that DID belong to the current V2 owner
@@ -1050,7 +1276,7 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 							continue;
 						}
 
-						const std::string& coreV2Tag = countryMap[coreEU3Tag];
+						CountryTag coreV2Tag = countryMap[coreEU3Tag];
 						if (!coreV2Tag.empty())
 						{
 							i->second->addCore(coreV2Tag);
@@ -1059,135 +1285,29 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 
 					// determine demographics
 					double provPopRatio = (*vitr)->getBaseTax() / newProvinceTotalBaseTax;
-					std::vector<EU3PopRatio> popRatios = (*vitr)->getPopRatios();
-					for (std::vector<EU3PopRatio>::iterator prItr = popRatios.begin(); prItr != popRatios.end(); ++prItr)
+					const std::vector<EU3PopRatio>& popRatios = (*vitr)->getPopRatios();
+					for (std::vector<EU3PopRatio>::const_iterator prItr = popRatios.begin(); prItr != popRatios.end(); ++prItr)
 					{
-						bool matched = false;
-						std::string culture = "";
-						for (cultureMapping::const_iterator cultureItr = cultureMap.begin();
-							(cultureItr != cultureMap.end()) && (!matched); ++cultureItr)
+						resolvedDemographic resolved = demographicCache.resolve(prItr->culture, prItr->religion,
+							(*vitr)->getOwner()->getTag(), i->second->getSrcProvince()->getNum());
+						if (resolved.culture.empty())
 						{
-							if (cultureItr->srcCulture == prItr->culture)
-							{
-								bool match = true;
-								for (std::vector<distinguisher>::const_iterator distinguisherItr = 
-									cultureItr->distinguishers.begin(); 
-									distinguisherItr != cultureItr->distinguishers.end(); ++distinguisherItr)
-								{
-									if (distinguisherItr->first == DTOwner)
-									{
-										if ((*vitr)->getOwner()->getTag() != distinguisherItr->second)
-										{
-											match = false;
-										}
-									}
-									else if (distinguisherItr->first == DTReligion)
-									{
-										if (prItr->religion != distinguisherItr->second)
-										{
-											match = false;
-										}
-									}
-									else if (distinguisherItr->first == DTRegion)
-									{
-										auto regions = regionsMap.find(i->second->getSrcProvince()->getNum());
-										if ((regions == regionsMap.end()) || 
-											(regions->second.find(distinguisherItr->second) == regions->second.end()))
-										{
-											match = false;
-										}
-										else
-										{
-											match = true;
-										}
-									}
-									else
-									{
-										LOG(LogLevel::Warning) << "Unhandled distinguisher type in culture rules";
-									}
-
-								}
-								if (match)
-								{
-									culture = cultureItr->dstCulture;
-									matched = true;
-								}
-							}
+							DIAGNOSE(LogLevel::Warning, "Could not set culture for pops in province") << destNum;
 						}
-						if (!matched)
-						{
-							LOG(LogLevel::Warning) << "Could not set culture for pops in province " << destNum;
-						}
-
-						std::string religion = "";
-						religionMapping::const_iterator religionItr = religionMap.find(prItr->religion);
-						if (religionItr != religionMap.end())
+						if (resolved.religion.empty())
 						{
-							religion = religionItr->second;
+							DIAGNOSE(LogLevel::Warning, "Could not set religion for pops in province") << destNum;
 						}
-						else
-						{
-							LOG(LogLevel::Warning) << "Could not set religion for pops in province " << destNum;
-						}
-
-						matched = false;
-						std::string slaveCulture = "";
-						for (cultureMapping::const_iterator slaveCultureItr = slaveCultureMap.begin();
-							(slaveCultureItr != slaveCultureMap.end()) && (!matched); ++slaveCultureItr)
-						{
-							if (slaveCultureItr->srcCulture == prItr->culture)
-							{
-								bool match = true;
-								for (std::vector<distinguisher>::const_iterator distinguisherItr = 
-									slaveCultureItr->distinguishers.begin(); 
-									distinguisherItr != slaveCultureItr->distinguishers.end(); ++distinguisherItr)
-								{
-									if (distinguisherItr->first == DTOwner)
-									{
-										if ((*vitr)->getOwner()->getTag() != distinguisherItr->second)
-										{
-											match = false;
-										}
-									}
-									else if (distinguisherItr->first == DTReligion)
-									{
-										if (prItr->religion != distinguisherItr->second)
-										{
-											match = false;
-										}
-									}
-									else if (distinguisherItr->first == DTRegion)
-									{
-										auto regions = regionsMap.find(i->second->getSrcProvince()->getNum());
-										if ((regions == regionsMap.end()) || 
-											(regions->second.find(distinguisherItr->second) == regions->second.end()))
-										{
-											match = false;
-										}
-									}
-									else
-									{
-										LOG(LogLevel::Warning) << "Unhandled distinguisher type in culture rules";
-									}
-
-								}
-								if (match)
-								{
-									slaveCulture = slaveCultureItr->dstCulture;
-									matched = true;
-								}
-							}
-						}
-						if (!matched)
+						if (resolved.slaveCulture.empty())
 						{
 							//LOG(LogLevel::Warning) << "Could not set slave culture for pops in province " << destNum;
-							slaveCulture = "african_minor";
+							resolved.slaveCulture = "african_minor";
 						}
 
 						V2Demographic demographic;
-						demographic.culture			= culture;
-						demographic.slaveCulture	= slaveCulture;
-						demographic.religion			= religion;
+						demographic.culture			= resolved.culture;
+						demographic.slaveCulture	= resolved.slaveCulture;
+						demographic.religion			= resolved.religion;
 						demographic.ratio				= prItr->popRatio * provPopRatio;
 						demographic.oldCountry		= oldOwner;
 						demographic.oldProvince		= *vitr;
@@ -1197,7 +1317,7 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 					}
 
 					// set forts and naval bases
-					if ((*vitr)->hasBuilding("fort4") || (*vitr)->hasBuilding("fort5") || (*vitr)->hasBuilding("fort6"))
+					if ((*vitr)->hasBuilding(BUILDING_fort4) || (*vitr)->hasBuilding(BUILDING_fort5) || (*vitr)->hasBuilding(BUILDING_fort6))
 					{
 						i->second->setFortLevel(1);
 					}
@@ -1208,17 +1328,24 @@ void V2World::convertProvinces(const EU3World& sourceWorld, const provinceMappin
 }
 
 
-void V2World::setupColonies(const adjacencyMapping& adjacencyMap, const continentMapping& continentMap)
+void V2World::setupColonies(const AdjacencyGraph& adjacencyMap, const continentMapping& continentMap)
 {
-	for (std::map<std::string, V2Country*>::iterator countryItr = countries.begin();
+	// Each country floods out from its capital through the provinces it owns.  No province has two
+	// owners, so no province is reached twice and one visited set serves every country.
+	int idLimit = 0;
+	for (ProvinceTable<V2Province*>::const_iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	{
+		idLimit = itr->first + 1;
+	}
+	std::vector<bool>	visited(idLimit, false);
+	std::queue<int>	goodProvinces;
+
+	for (std::map<CountryTag, V2Country*>::iterator countryItr = countries.begin();
 		countryItr != countries.end(); ++countryItr)
 	{
 		// find all land connections to capitals
-		std::map<int, V2Province*>	openProvinces = provinces;
-		std::queue<int>					goodProvinces;
-
-		std::map<int, V2Province*>::iterator openItr = openProvinces.find(countryItr->second->getCapital());
-		if (openItr == openProvinces.end())
+		ProvinceTable<V2Province*>::iterator openItr = provinces.find(countryItr->second->getCapital());
+		if (openItr == provinces.end())
 		{
 			continue;
 		}
@@ -1228,22 +1355,26 @@ void V2World::setupColonies(const adjacencyMapping& adjacencyMap, const continen
 		}
 		openItr->second->setLandConnection(true);
 		goodProvinces.push(openItr->first);
-		openProvinces.erase(openItr);
-		
+		visited[openItr->first] = true;
+
 		do
 		{
 			int currentProvince = goodProvinces.front();
 			goodProvinces.pop();
-			if (currentProvince > static_cast<int>(adjacencyMap.size()))
+			if (currentProvince >= static_cast<int>(adjacencyMap.size()))
 			{
 				LOG(LogLevel::Warning) << "No adjacency mapping for province " << currentProvince;
 				continue;
 			}
-			std::vector<int> adjacencies = adjacencyMap[currentProvince];
-			for (unsigned int i = 0; i < adjacencies.size(); i++)
+			AdjacencySpan adjacencies = adjacencyMap.neighbors(currentProvince);
+			for (AdjacencySpan::const_iterator adjItr = adjacencies.begin(); adjItr != adjacencies.end(); ++adjItr)
 			{
-				std::map<int, V2Province*>::iterator openItr = openProvinces.find(adjacencies[i]);
-				if (openItr == openProvinces.end())
+				if ((*adjItr < 0) || (*adjItr >= idLimit) || visited[*adjItr])
+				{
+					continue;
+				}
+				ProvinceTable<V2Province*>::iterator openItr = provinces.find(*adjItr);
+				if (openItr == provinces.end())
 				{
 					continue;
 				}
@@ -1253,13 +1384,13 @@ void V2World::setupColonies(const adjacencyMapping& adjacencyMap, const continen
 				}
 				openItr->second->setLandConnection(true);
 				goodProvinces.push(openItr->first);
-				openProvinces.erase(openItr);
+				visited[openItr->first] = true;
 			}
 		} while (goodProvinces.size() > 0);
 
 		// find all provinces on the same continent as the owner's capital
 		std::string capitalContinent = "";
-		std::map<int, V2Province*>::iterator capital = provinces.find(countryItr->second->getCapital());
+		ProvinceTable<V2Province*>::iterator capital = provinces.find(countryItr->second->getCapital());
 		if (capital != provinces.end())
 		{
 			continentMapping::const_iterator itr = continentMap.find(capital->first);
@@ -1276,7 +1407,7 @@ void V2World::setupColonies(const adjacencyMapping& adjacencyMap, const continen
 		{
 			continue;
 		}
-		auto ownedProvinces = countryItr->second->getProvinces();
+		const auto& ownedProvinces = countryItr->second->getProvinces();
 		for (auto provItr = ownedProvinces.begin(); provItr != ownedProvinces.end(); ++provItr)
 		{
 			continentMapping::const_iterator itr = continentMap.find(provItr->first);
@@ -1287,69 +1418,73 @@ void V2World::setupColonies(const adjacencyMapping& adjacencyMap, const continen
 		}
 	}
 
-	for (std::map<int, V2Province*>::iterator provItr = provinces.begin(); provItr != provinces.end(); ++provItr)
+	for (ProvinceTable<V2Province*>::iterator provItr = provinces.begin(); provItr != provinces.end(); ++provItr)
 	{
 		provItr->second->determineColonial();
 	}
 }
 
 
-static int stateId = 0;
 void V2World::setupStates(const stateMapping& stateMap)
 {
-	std::list<V2Province*> unassignedProvs;
-	for (std::map<int, V2Province*>::iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	int stateId = 0;
+
+	// In id order, the first province not yet in a state starts one, and takes in the unassigned
+	// provinces of its region that have the same owner and are as colonial as it is.
+	int idLimit = 0;
+	for (ProvinceTable<V2Province*>::const_iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
 	{
-		unassignedProvs.push_back(itr->second);
+		idLimit = itr->first + 1;
 	}
+	std::vector<bool> assigned(idLimit, false);
 
-	std::list<V2Province*>::iterator iter;
-	while(unassignedProvs.size() > 0)
+	// only HoD places naval bases as states are added, so the game's addState is picked up front
+	void (V2Country::*addState)(V2State*) = withV2GametypeTraits(Configuration::getV2Gametype(), [](auto traits)
 	{
-		iter = unassignedProvs.begin();
-		int		provId	= (*iter)->getNum();
-		std::string	owner		= (*iter)->getOwner();
+		return &V2Country::addState<decltype(traits)>;
+	});
 
-		if (owner == "")
+	for (ProvinceTable<V2Province*>::iterator itr = provinces.begin(); itr != provinces.end(); ++itr)
+	{
+		if (assigned[itr->first])
 		{
-			unassignedProvs.erase(iter);
 			continue;
 		}
+		assigned[itr->first] = true;
 
-		V2State* newState = new V2State(stateId, *iter);
-		stateId++;
-		stateMapping::const_iterator stateItr = stateMap.find(provId);
-		std::vector<int> neighbors;
-		if (stateItr != stateMap.end())
+		CountryTag owner = itr->second->getOwner();
+		if (owner.empty())
 		{
-			neighbors = stateItr->second;
+			continue;
 		}
-		bool colonised = (*iter)->isColonial();
+
+		V2State* newState = arena.make<V2State>(stateId, itr->second);
+		stateId++;
+		bool colonised = itr->second->isColonial();
 		newState->setColonial(colonised);
-		iter = unassignedProvs.erase(iter);
 
-		for (std::vector<int>::iterator i = neighbors.begin(); i != neighbors.end(); ++i)
+		stateMapping::const_iterator stateItr = stateMap.find(itr->first);
+		if (stateItr != stateMap.end())
 		{
-			for(iter = unassignedProvs.begin(); iter != unassignedProvs.end(); ++iter)
+			for (std::vector<int>::const_iterator i = stateItr->second.begin(); i != stateItr->second.end(); ++i)
 			{
-				if ((*iter)->getNum() == *i)
+				if ((*i < 0) || (*i >= idLimit) || assigned[*i])
 				{
-					if ((*iter)->getOwner() == owner)
-					{
-						if ((*iter)->isColonial() == colonised)
-						{
-							newState->addProvince(*iter);
-							iter = unassignedProvs.erase(iter);
-						}
-					}
+					continue;
+				}
+				ProvinceTable<V2Province*>::iterator neighbor = provinces.find(*i);
+				if ((neighbor != provinces.end()) && (neighbor->second->getOwner() == owner) && (neighbor->second->isColonial() == colonised))
+				{
+					newState->addProvince(neighbor->second);
+					assigned[*i] = true;
 				}
 			}
 		}
 
-		std::map<std::string, V2Country*>::iterator iter2 = countries.find(owner);
+		std::map<CountryTag, V2Country*>::iterator iter2 = countries.find(owner);
 		if (iter2 != countries.end())
 		{
-			iter2->second->addState(newState);
+			(iter2->second->*addState)(newState);
 		}
 	}
 }
@@ -1357,10 +1492,13 @@ void V2World::setupStates(const stateMapping& stateMap)
 
 void V2World::convertUncivReforms()
 {
-	for (std::map<std::string, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	withV2GametypeTraits(Configuration::getV2Gametype(), [this](auto traits)
 	{
-		itr->second->convertUncivReforms();
-	}
+		for (std::map<CountryTag, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+		{
+			itr->second->convertUncivReforms<decltype(traits)>();
+		}
+	});
 }
 
 
@@ -1370,7 +1508,7 @@ void V2World::setupPops(EU3World& sourceWorld)
 	long		my_totalWorldPopulation	= static_cast<long>(0.55 * totalWorldPopulation);
 	double	popWeightRatio				= my_totalWorldPopulation / sourceWorld.getWorldWeightSum();
 
-	for (std::map<std::string, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	for (std::map<CountryTag, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
 	{
 		itr->second->setupPops(sourceWorld, popWeightRatio);
 	}
@@ -1398,7 +1536,7 @@ void V2World::setupPops(EU3World& sourceWorld)
 
 void V2World::addUnions(const unionMapping& unionMap)
 {
-	for (std::map<int, V2Province*>::iterator provItr = provinces.begin(); provItr != provinces.end(); ++provItr)
+	for (ProvinceTable<V2Province*>::iterator provItr = provinces.begin(); provItr != provinces.end(); ++provItr)
 	{
 		for (unionMapping::const_iterator unionItr = unionMap.begin(); unionItr != unionMap.end(); unionItr++)
 		{
@@ -1414,7 +1552,7 @@ void V2World::addUnions(const unionMapping& unionMap)
 
 //#define TEST_V2_PROVINCES
 void V2World::convertArmies(const EU3World& sourceWorld, const inverseProvinceMapping& inverseProvinceMap,
-	const std::map<int,int>& leaderIDMap, adjacencyMapping adjacencyMap)
+	const std::map<int,int>& leaderIDMap, const AdjacencyGraph& adjacencyMap)
 {
 	// hack for naval bases.  not ALL naval bases are in port provinces, and if you spawn a navy at a naval base in
 	// a non-port province, Vicky crashes....
@@ -1451,7 +1589,7 @@ void V2World::convertArmies(const EU3World& sourceWorld, const inverseProvinceMa
 	}
 
 	// convert armies
-	for (std::map<std::string, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	for (std::map<CountryTag, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
 	{
 		itr->second->convertArmies(leaderIDMap, cost_per_regiment, inverseProvinceMap, provinces, 
 			port_whitelist, adjacencyMap);
@@ -1461,7 +1599,7 @@ void V2World::convertArmies(const EU3World& sourceWorld, const inverseProvinceMa
 
 void V2World::convertTechs(const EU3World& sourceWorld)
 {
-	std::map<std::string, EU3Country*> sourceCountries = sourceWorld.getCountries();
+	const std::map<CountryTag, EU3Country*>& sourceCountries = sourceWorld.getCountries();
 	
 	double oldLandMean;
 	double landMean;
@@ -1484,7 +1622,7 @@ void V2World::convertTechs(const EU3World& sourceWorld)
 	double highestGovernment;
 
 	int num = 2;
-	std::map<std::string, EU3Country*>::iterator i = sourceCountries.begin();
+	std::map<CountryTag, EU3Country*>::const_iterator i = sourceCountries.begin();
 	if (sourceCountries.size() == 0)
 	{
 		return;
@@ -1548,27 +1686,31 @@ void V2World::convertTechs(const EU3World& sourceWorld)
 		num++;
 	}
 
-	for (std::map<std::string, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	withV2GametypeTraits(Configuration::getV2Gametype(), [&](auto traits)
 	{
-		if ((Configuration::getV2Gametype() == "vanilla") || itr->second->isCivilized())
+		typedef decltype(traits) Traits;
+		for (std::map<CountryTag, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
 		{
-			itr->second->setArmyTech(landMean, highestLand);
-			itr->second->setNavyTech(navalMean, highestNaval);
-			itr->second->setCommerceTech(tradeMean, highestTrade);
-			itr->second->setIndustryTech(productionMean, highestProduction);
-			itr->second->setCultureTech(governmentMean, highestGovernment);
+			if (!Traits::hasUncivilizedNations || itr->second->isCivilized())
+			{
+				itr->second->setArmyTech<Traits>(landMean, highestLand);
+				itr->second->setNavyTech<Traits>(navalMean, highestNaval);
+				itr->second->setCommerceTech<Traits>(tradeMean, highestTrade);
+				itr->second->setIndustryTech<Traits>(productionMean, highestProduction);
+				itr->second->setCultureTech<Traits>(governmentMean, highestGovernment);
+			}
 		}
-	}
+	});
 }
 
 
 void V2World::allocateFactories(const EU3World& sourceWorld, const V2FactoryFactory& factoryBuilder)
 {
 	// determine average production tech
-	std::map<std::string, EU3Country*> sourceCountries = sourceWorld.getCountries();
+	const std::map<CountryTag, EU3Country*>& sourceCountries = sourceWorld.getCountries();
 	double productionMean = 0.0f;
 	int num = 1;
-	for (std::map<std::string, EU3Country*>::iterator itr = sourceCountries.begin(); itr != sourceCountries.end(); ++itr)
+	for (std::map<CountryTag, EU3Country*>::const_iterator itr = sourceCountries.begin(); itr != sourceCountries.end(); ++itr)
 	{
 		if ( (itr)->second->getProvinces().size() == 0)
 		{
@@ -1586,7 +1728,7 @@ void V2World::allocateFactories(const EU3World& sourceWorld, const V2FactoryFact
 
 	// give all extant civilized nations an industrial score
 	std::deque<std::pair<double, V2Country*>> weightedCountries;
-	for (std::map<std::string, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
+	for (std::map<CountryTag, V2Country*>::iterator itr = countries.begin(); itr != countries.end(); ++itr)
 	{
 		if ( !itr->second->isCivilized() )
 		{
@@ -1639,7 +1781,7 @@ void V2World::allocateFactories(const EU3World& sourceWorld, const V2FactoryFact
 	weightedCountries.swap(restrictCountries);
 
 	// remove nations that won't have enough industiral score for even one factory
-	std::deque<V2Factory*> factoryList = factoryBuilder.buildFactories();
+	std::deque<V2Factory*> factoryList = factoryBuilder.buildFactories(arena);
 	while (((weightedCountries.begin()->first / totalIndWeight) * factoryList.size() + 0.5 /*round*/) < 1.0)
 	{
 		weightedCountries.pop_front();
@@ -1678,11 +1820,14 @@ void V2World::allocateFactories(const EU3World& sourceWorld, const V2FactoryFact
 		}
 		if (!accepted && citr == lastReceptiveCountry)
 		{
-			Log logOutput(LogLevel::Debug);
-			logOutput << "No countries will accept any of the remaining factories:\n";
-			for (std::deque<V2Factory*>::iterator qitr = factoryList.begin(); qitr != factoryList.end(); ++qitr)
+			if (Log::IsEnabled(LogLevel::Debug))
 			{
-				logOutput << "\t  " << (*qitr)->getTypeName() << '\n';
+				Log logOutput(LogLevel::Debug);
+				logOutput << "No countries will accept any of the remaining factories:\n";
+				for (std::deque<V2Factory*>::iterator qitr = factoryList.begin(); qitr != factoryList.end(); ++qitr)
+				{
+					logOutput << "\t  " << (*qitr)->getTypeName() << '\n';
+				}
 			}
 			break;
 		}
@@ -1694,9 +1839,9 @@ void V2World::allocateFactories(const EU3World& sourceWorld, const V2FactoryFact
 }
 
 
-std::map<std::string, V2Country*> V2World::getPotentialCountries() const
+std::map<CountryTag, V2Country*> V2World::getPotentialCountries() const
 {
-	std::map<std::string, V2Country*> retVal;
+	std::map<CountryTag, V2Country*> retVal;
 	for (std::vector<V2Country*>::const_iterator i = potentialCountries.begin(); i != potentialCountries.end(); ++i)
 	{
 		retVal[ (*i)->getTag() ] = *i;
@@ -1706,13 +1851,6 @@ std::map<std::string, V2Country*> V2World::getPotentialCountries() const
 }
 
 
-std::map<std::string, V2Country*> V2World::getDynamicCountries() const
-{
-	std::map<std::string, V2Country*> retVal = dynamicCountries;
-	return retVal;
-}
-
-
 void V2World::getProvinceLocalizations(const std::string& file)
 {
 	std::ifstream read;
@@ -1726,13 +1864,10 @@ void V2World::getProvinceLocalizations(const std::string& file)
 			int position = line.find_first_of(';');
 			int num = atoi( line.substr(4, position - 4).c_str() );
 			std::string name = line.substr(position + 1, line.find_first_of(';', position + 1) - position - 1);
-			for (auto i: provinces)
+			auto i = provinces.find(num);
+			if (i != provinces.end())
 			{
-				if (i.first == num)
-				{
-					i.second->setName(name);
-					break;
-				}
+				i->second->setName(name);
 			}
 		}
 	}
@@ -1740,9 +1875,9 @@ void V2World::getProvinceLocalizations(const std::string& file)
 }
 
 
-V2Country* V2World::getCountry(const std::string& tag)
+V2Country* V2World::getCountry(CountryTag tag)
 {
-	std::map<std::string, V2Country*>::iterator itr = countries.find(tag);
+	std::map<CountryTag, V2Country*>::iterator itr = countries.find(tag);
 	if (itr != countries.end())
 	{
 		return itr->second;
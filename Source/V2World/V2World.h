@@ -32,61 +32,91 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
 #include "V2Factory.h"
 #include "V2TechSchools.h"
 #include "V2Party.h"
+#include "V2Pop.h"
+#include "../Arena.h"
 #include "../CountryMapping.h"
+#include "../CultureRuleEngine.h"
+#include "../DemographicCache.h"
 #include "../Mapper.h"
+#include "../ProvinceTable.h"
 #include <set>
 
 class V2Country;
 class V2Province;
 class V2Army;
 class V2LeaderTraits;
+class SnapshotReader;
+class SnapshotWriter;
 
 
 
 class V2World {
 	public:
 		V2World(const std::vector<std::pair<std::string, std::string>>& minorities);
+		V2World(const V2World& base);	// copies an unconverted world, so one import serves several conversions
 		void output() const;
 		void createProvinceFiles(const EU3World& sourceWorld, const provinceMapping& provinceMap);
 		
 		void convertCountries(const EU3World& sourceWorld, const CountryMapping& countryMap,
-			const cultureMapping& cultureMap, const unionCulturesMap& unionCultures, const religionMapping& religionMap, 
+			const CultureRuleEngine& cultureRules, const unionCulturesMap& unionCultures, const religionMapping& religionMap, 
 			const governmentMapping& governmentMap, const inverseProvinceMapping& inverseProvinceMap, 
-			const std::vector<techSchool>& techSchools, std::map<int, int>& leaderMap, const V2LeaderTraits& lt, 
-			const EU3RegionsMapping& regionsMap);
+			const std::vector<techSchool>& techSchools, std::map<int, int>& leaderMap, const V2LeaderTraits& lt);
 		void scalePrestige();
 		void convertDiplomacy(const EU3World& sourceWorld, const CountryMapping& countryMap);
 		void convertProvinces(const EU3World& sourceWorld, const provinceMapping& provinceMap, 
-			const resettableMap& resettableProvinces, const CountryMapping& countryMap, const cultureMapping& cultureMap, 
-			const cultureMapping& slaveCultureMap, const religionMapping& religionMap, 
-			const stateIndexMapping& stateIndexMap, const EU3RegionsMapping& regionsMap);
-		void setupColonies(const adjacencyMapping& adjacencyMap, const continentMapping& continentMap);
+			const resettableMap& resettableProvinces, const CountryMapping& countryMap, const DemographicCache& demographicCache, 
+			const stateIndexMapping& stateIndexMap);
+		void setupColonies(const AdjacencyGraph& adjacencyMap, const continentMapping& continentMap);
 		void setupStates(const stateMapping&);
 		void convertUncivReforms();
 		void setupPops(EU3World& sourceWorld);
 		void addUnions(const unionMapping& unionMap);
 		void convertArmies(const EU3World& sourceWorld, const inverseProvinceMapping& inverseProvinceMap, 
-			const std::map<int,int>& leaderIDMap, adjacencyMapping adjacencyMap);
+			const std::map<int,int>& leaderIDMap, const AdjacencyGraph& adjacencyMap);
 		void convertTechs(const EU3World& sourceWorld);
 		void allocateFactories(const EU3World& sourceWorld, const V2FactoryFactory& factoryBuilder);
 
-		std::map<std::string, V2Country*>	getPotentialCountries()	const;
-		std::map<std::string, V2Country*>	getDynamicCountries()	const;
+		std::map<CountryTag, V2Country*>	getPotentialCountries()	const;
+		const std::map<CountryTag, V2Country*>&	getDynamicCountries()	const noexcept { return dynamicCountries; }
+
+		// for the countries to make their parts in
+		Arena&					getArena()		noexcept { return arena; }
+		ObjectPool<V2Pop>&	getPopPool()	noexcept { return popPool; }
+
+		// armies, navies and their regiments share one run of ids, counted per world
+		int						getNextArmyID()	noexcept { return ++lastArmyID; }
 	private:
+		struct potentialCountry;
+
+		void			importProvinces(const std::vector<std::pair<std::string, std::string>>& minorities);
+		static std::vector<potentialCountry>	importPotentialCountries();
+		void			writeSnapshot(SnapshotWriter& snapshot, const std::vector<potentialCountry>& countryList) const;
+		bool			readSnapshot(SnapshotReader& snapshot, std::vector<potentialCountry>& countryList);
 		void			outputPops() const;
+		template<typename Traits>
+		void			convertProvincesFor(const EU3World& sourceWorld, const provinceMapping& provinceMap,
+			const resettableMap& resettableProvinces, const CountryMapping& countryMap, const DemographicCache& demographicCache,
+			const stateIndexMapping& stateIndexMap);
 		void			getProvinceLocalizations(const std::string& file);
-		V2Country*	getCountry(const std::string& tag);
+		void			importPops(const std::string& folder, const std::vector<std::string>& fileNames, const std::vector<std::pair<std::string, std::string>>& minorities);
+		V2Country*	getCountry(CountryTag tag);
+
+		// everything in the world is made here, and goes when the world does; a copied world
+		// still points at the imported pops, parties and pop regions of the world it came from
+		Arena								arena;
+		ObjectPool<V2Pop>				popPool;
 
-		std::map<int, V2Province*>		provinces;
-		std::map<std::string, V2Country*>		countries;
+		ProvinceTable<V2Province*>		provinces;
+		std::map<CountryTag, V2Country*>		countries;
 		std::vector<V2Country*>			potentialCountries;
-		std::map<std::string, V2Country*>		dynamicCountries;
+		std::map<CountryTag, V2Country*>		dynamicCountries;
 		V2Diplomacy						diplomacy;
-		std::map< int, std::set<std::string> >		colonies;
+		std::map< int, std::set<CountryTag> >		colonies;
 
 		std::map<std::string, std::list<int>* >	popRegions;
 
 		long								totalWorldPopulation;
+		int								lastArmyID;
 };
 
 
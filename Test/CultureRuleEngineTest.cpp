@@ -0,0 +1,157 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+// Checks CultureRuleEngine against the culture map loops it replaced, for both the main map, where a
+// matching region overrides the distinguishers before it, and the slave map, where every one must hold.
+// Build it with Source/CultureRuleEngine.cpp, Source/CountryTag.cpp, Source/Symbol.cpp and
+// Source/Log.cpp; it prints the first query the two disagree on and returns 1.
+
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include "../Source/CultureRuleEngine.h"
+
+
+
+// the rule scan of convertProvinces and initFromEU3Country before the rules were compiled
+static Symbol resolveByScan(const cultureMapping& cultureMap, const EU3RegionsMapping& regionsMap, bool regionOverrides,
+	Symbol culture, Symbol religion, CountryTag tag, int srcProvince)
+{
+	for (cultureMapping::const_iterator i = cultureMap.begin(); i != cultureMap.end(); ++i)
+	{
+		if (i->srcCulture != culture)
+		{
+			continue;
+		}
+		bool match = true;
+		for (std::vector<distinguisher>::const_iterator j = i->distinguishers.begin(); j != i->distinguishers.end(); ++j)
+		{
+			if (j->first == DTOwner)
+			{
+				if (tag != j->second.str())
+				{
+					match = false;
+				}
+			}
+			else if (j->first == DTReligion)
+			{
+				if (religion != j->second)
+				{
+					match = false;
+				}
+			}
+			else if (j->first == DTRegion)
+			{
+				auto regions = regionsMap.find(srcProvince);
+				if ((regions == regionsMap.end()) || (regions->second.find(j->second) == regions->second.end()))
+				{
+					match = false;
+				}
+				else if (regionOverrides)
+				{
+					match = true;
+				}
+			}
+		}
+		if (match)
+		{
+			return i->dstCulture;
+		}
+	}
+	return Symbol();
+}
+
+
+int main()
+{
+	const char* cultures[]	= { "english", "scottish", "welsh" };
+	const char* religions[]	= { "protestant", "catholic" };
+	const char* owners[]		= { "ENG", "SCO", "TOOLONG" };	// the last one can never be a tag
+	const char* regions[]	= { "british_isles", "scotland", "wales", "ireland" };
+
+	std::mt19937 random(1399);
+	for (int run = 0; run < 10000; ++run)
+	{
+		cultureMapping cultureMap;
+		int numRules = random() % 8;
+		for (int i = 0; i < numRules; ++i)
+		{
+			cultureStruct rule;
+			rule.srcCulture = cultures[random() % 3];
+			rule.dstCulture = std::to_string(i);
+			int numDistinguishers = random() % 4;
+			for (int j = 0; j < numDistinguishers; ++j)
+			{
+				switch (random() % 3)
+				{
+					case 0:
+						rule.distinguishers.push_back(std::make_pair(DTOwner, Symbol(owners[random() % 3])));
+						break;
+					case 1:
+						rule.distinguishers.push_back(std::make_pair(DTReligion, Symbol(religions[random() % 2])));
+						break;
+					default:
+						rule.distinguishers.push_back(std::make_pair(DTRegion, Symbol(regions[random() % 4])));
+						break;
+				}
+			}
+			cultureMap.push_back(rule);
+		}
+
+		// the last region is only ever named by rules, and province 6 is in no region
+		EU3RegionsMapping regionsMap;
+		for (int province = 1; province < 6; ++province)
+		{
+			for (int region = 0; region < 3; ++region)
+			{
+				if (random() % 2 == 0)
+				{
+					regionsMap[province].insert(regions[region]);
+				}
+			}
+		}
+
+		for (int regionOverrides = 0; regionOverrides < 2; ++regionOverrides)
+		{
+			CultureRuleEngine rules(cultureMap, regionsMap, regionOverrides != 0);
+			for (int query = 0; query < 50; ++query)
+			{
+				Symbol		culture		= cultures[random() % 3];
+				Symbol		religion		= religions[random() % 2];
+				CountryTag	owner			= std::string(owners[random() % 2]);
+				int			srcProvince	= random() % 7;
+				Symbol expected	= resolveByScan(cultureMap, regionsMap, regionOverrides != 0, culture, religion, owner, srcProvince);
+				Symbol resolved	= rules.resolve(culture, religion, owner, srcProvince);
+				if (resolved != expected)
+				{
+					printf("Run %d: %s %s owned by %s in province %d resolves to \"%s\" instead of \"%s\"%s\n", run, culture.c_str(),
+						religion.c_str(), owner.str().c_str(), srcProvince, resolved.c_str(), expected.c_str(), regionOverrides ? " with region overrides" : "");
+					return 1;
+				}
+			}
+		}
+	}
+
+	printf("CultureRuleEngine matches the culture map loops\n");
+	return 0;
+}
@@ -0,0 +1,152 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+// Checks the EU3 building table and getBuildingLineLevel.  Every building of the four Divine Wind
+// lines must give its level on its own, and random sets of buildings must give the levels the old
+// chains of name tests gave.  It needs no other sources; it returns 1 on the first mismatch.
+
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include "../Source/EU3World/EU3Buildings.h"
+
+
+
+struct lineBuilding
+{
+	const char*	name;
+	EU3Building	lowest;	// the first building of its line
+	int			level;
+};
+
+
+// Every building that counts for Divine Wind pops, by name, with the line it is in and its level
+static const lineBuilding lineBuildings[] =
+{
+	{ "temple",					BUILDING_temple,		1 },
+	{ "courthouse",			BUILDING_temple,		2 },
+	{ "spy_agency",			BUILDING_temple,		3 },
+	{ "town_hall",				BUILDING_temple,		4 },
+	{ "college",				BUILDING_temple,		6 },
+	{ "cathedral",				BUILDING_temple,		8 },
+
+	{ "armory",					BUILDING_armory,		1 },
+	{ "training_fields",		BUILDING_armory,		2 },
+	{ "barracks",				BUILDING_armory,		3 },
+	{ "regimental_camp",		BUILDING_armory,		4 },
+	{ "arsenal",				BUILDING_armory,		6 },
+	{ "conscription_center",	BUILDING_armory,		8 },
+
+	{ "constable",				BUILDING_constable,	1 },
+	{ "workshop",				BUILDING_constable,	2 },
+	{ "counting_house",		BUILDING_constable,	3 },
+	{ "treasury_office",		BUILDING_constable,	4 },
+	{ "mint",					BUILDING_constable,	6 },
+	{ "stock_exchange",		BUILDING_constable,	8 },
+
+	{ "marketplace",			BUILDING_marketplace,	1 },
+	{ "trade_depot",			BUILDING_marketplace,	2 },
+	{ "canal",					BUILDING_marketplace,	3 },
+	{ "road_network",			BUILDING_marketplace,	4 },
+	{ "post_office",			BUILDING_marketplace,	6 },
+	{ "customs_house",		BUILDING_marketplace,	8 },
+};
+const int numLineBuildings = sizeof(lineBuildings) / sizeof(lineBuildings[0]);
+
+
+// The level createPops found before the buildings were a bitset: the first building of the line,
+// in the table's order, that the province has
+static int levelByNames(const std::map<std::string, bool>& buildings, EU3Building lowest)
+{
+	for (int i = 0; i < numLineBuildings; ++i)
+	{
+		if ((lineBuildings[i].lowest == lowest) && (buildings.find(lineBuildings[i].name) != buildings.end()))
+		{
+			return lineBuildings[i].level;
+		}
+	}
+	return 0;
+}
+
+
+int main()
+{
+	const EU3Building lines[] = { BUILDING_temple, BUILDING_armory, BUILDING_constable, BUILDING_marketplace };
+
+	for (int i = 0; i < NUM_BUILDINGS; ++i)
+	{
+		if (findEU3Building(EU3BuildingNames[i]) != i)
+		{
+			printf("%s is not found as building %d\n", EU3BuildingNames[i], i);
+			return 1;
+		}
+	}
+
+	for (int i = 0; i < numLineBuildings; ++i)
+	{
+		EU3Building building = findEU3Building(lineBuildings[i].name);
+		if (building == NUM_BUILDINGS)
+		{
+			printf("%s is not in the building table\n", lineBuildings[i].name);
+			return 1;
+		}
+		EU3BuildingSet buildings;
+		buildings.set(building);
+		for (int j = 0; j < 4; ++j)
+		{
+			int expected = (lines[j] == lineBuildings[i].lowest) ? lineBuildings[i].level : 0;
+			if (getBuildingLineLevel(buildings, lines[j]) != expected)
+			{
+				printf("%s alone gives level %d in the %s line instead of %d\n", lineBuildings[i].name, getBuildingLineLevel(buildings, lines[j]), EU3BuildingNames[lines[j]], expected);
+				return 1;
+			}
+		}
+	}
+
+	std::mt19937 random(1399);
+	for (int run = 0; run < 100000; ++run)
+	{
+		std::map<std::string, bool> byName;
+		EU3BuildingSet buildings;
+		for (int i = 0; i < numSaveBuildings; ++i)
+		{
+			if (random() % 4 == 0)
+			{
+				byName[EU3BuildingNames[i]] = true;
+				buildings.set(findEU3Building(EU3BuildingNames[i]));
+			}
+		}
+		for (int j = 0; j < 4; ++j)
+		{
+			if (getBuildingLineLevel(buildings, lines[j]) != levelByNames(byName, lines[j]))
+			{
+				printf("Run %d: the %s line gives level %d instead of %d\n", run, EU3BuildingNames[lines[j]], getBuildingLineLevel(buildings, lines[j]), levelByNames(byName, lines[j]));
+				return 1;
+			}
+		}
+	}
+
+	printf("getBuildingLineLevel matches the building lines\n");
+	return 0;
+}
@@ -0,0 +1,128 @@
+/*Copyright (c) 2014 The Paradox Game Converters Project
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+
+
+// Checks combineAlikePops against the pairwise routine it replaced, on random lists of pops.
+// Build it with Source/V2World/V2Pop.cpp, Source/Symbol.cpp and Source/Log.cpp; it prints the
+// first list the two disagree on and returns 1, or returns 0 when they always agree.
+
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../Source/V2World/V2Pop.h"
+
+
+
+// V2Province::combinePops as it was before the hashed pass
+static void combinePairwise(std::vector<V2Pop*>& pops)
+{
+	std::vector<V2Pop*> trashPops;
+	for (std::vector<V2Pop*>::iterator lhs = pops.begin(); lhs != pops.end(); ++lhs)
+	{
+		std::vector<V2Pop*>::iterator rhs = lhs;
+		for (++rhs; rhs != pops.end(); ++rhs)
+		{
+			if ( (*lhs)->combine(**rhs) )
+			{
+				trashPops.push_back(*rhs);
+			}
+			if ( (*rhs)->getSize() < 1 )
+			{
+				trashPops.push_back(*rhs);
+			}
+		}
+	}
+
+	std::vector<V2Pop*> consolidatedPops;
+	for (std::vector<V2Pop*>::iterator itr = pops.begin(); itr != pops.end(); ++itr)
+	{
+		bool isTrashed = false;
+		for (std::vector<V2Pop*>::iterator titr = trashPops.begin(); titr != trashPops.end(); ++titr)
+		{
+			if (*itr == *titr)
+			{
+				isTrashed = true;
+			}
+		}
+		if (!isTrashed)
+		{
+			consolidatedPops.push_back(*itr);
+		}
+	}
+	pops.swap(consolidatedPops);
+}
+
+
+static void printPops(const std::vector<V2Pop>& pops)
+{
+	for (std::vector<V2Pop>::const_iterator itr = pops.begin(); itr != pops.end(); ++itr)
+	{
+		printf("\t%s %s %s %d\n", itr->getType().c_str(), itr->getCulture().c_str(), itr->getReligion().c_str(), itr->getSize());
+	}
+}
+
+
+int main()
+{
+	const char* types[]		= { "farmers", "labourers", "soldiers", "clergymen", "artisans" };
+	const char* cultures[]	= { "british", "french", "north_german", "japanese", "manchu", "dutch" };
+	const char* religions[]	= { "protestant", "catholic", "shinto" };
+
+	std::mt19937 random(1836);
+	for (int run = 0; run < 100000; ++run)
+	{
+		// few kinds and sizes around 1, so that merges, small pops and table collisions are common
+		std::vector<V2Pop> original;
+		int numPops = random() % 40;
+		for (int i = 0; i < numPops; ++i)
+		{
+			original.push_back(V2Pop(types[random() % 5], static_cast<int>(random() % 6) - 2, cultures[random() % 6], religions[random() % 3]));
+		}
+
+		std::vector<V2Pop> oldCopy = original;
+		std::vector<V2Pop> newCopy = original;
+		std::vector<V2Pop*> oldPops;
+		std::vector<V2Pop*> newPops;
+		for (int i = 0; i < numPops; ++i)
+		{
+			oldPops.push_back(&oldCopy[i]);
+			newPops.push_back(&newCopy[i]);
+		}
+		combinePairwise(oldPops);
+		combineAlikePops(newPops);
+
+		bool same = (oldPops.size() == newPops.size());
+		for (size_t i = 0; same && (i < oldPops.size()); ++i)
+		{
+			same = ((oldPops[i] - &oldCopy[0]) == (newPops[i] - &newCopy[0])) && (oldPops[i]->getSize() == newPops[i]->getSize());
+		}
+		if (!same)
+		{
+			printf("Run %d: combineAlikePops differs from the pairwise routine on\n", run);
+			printPops(original);
+			return 1;
+		}
+	}
+
+	printf("combineAlikePops matches the pairwise routine\n");
+	return 0;
+}